@@ -0,0 +1,558 @@
+/**
+ * Synthetic benchmark for LGE (Lightweight Game Engine).
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "Bench"
+
+#include <LGE/Application.h>
+#include <LGE/DebugUI.h>
+#include <LGE/Descriptor.h>
+#include <LGE/GPUMemory.h>
+#include <LGE/GPUProfiler.h>
+#include <LGE/Init.h>
+#include <LGE/Log.h>
+#include <LGE/Pipeline.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/Stats.h>
+#include <LGE/Trace.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <LGE/Math.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "position_color.frag.txt"
+#include "position_color.vert.txt"
+
+/**
+ * The workload of every frame. Each count is the number of times per frame
+ * that the corresponding engine path is exercised.
+ */
+struct BenchConfig {
+	uint32_t draws = 1000;
+	uint32_t uniforms = 100;
+	uint32_t sets = 100;
+	uint32_t binds = 10;
+	uint32_t uploads = 0;
+	uint32_t upload_size = 65536;
+	uint32_t text = 20;
+	uint32_t warmup = 60;
+	uint32_t measure = 300;
+	const char *out = nullptr;
+};
+
+static BenchConfig config;
+
+static LGE::DescriptorSetLayout set_layout = nullptr;
+
+class BenchPipeline : public LGE::Pipeline {
+public:
+	VkPipelineLayout m_layout;
+	VkCullModeFlags m_cullMode;
+
+	BenchPipeline (VkCullModeFlags cull_mode)
+		: LGE::Pipeline (), m_cullMode (cull_mode)
+	{
+		VkDescriptorSetLayout layouts[1] = {
+			LGE::GetVkDescriptorSetLayout (set_layout)
+		};
+
+		VkPushConstantRange ranges[1] {};
+		ranges[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		ranges[0].size = sizeof (glm::mat4);
+
+		VkPipelineLayoutCreateInfo layout_ci {};
+		layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layout_ci.setLayoutCount = 1;
+		layout_ci.pSetLayouts = layouts;
+		layout_ci.pushConstantRangeCount = 1;
+		layout_ci.pPushConstantRanges = ranges;
+
+		VkResult result = vkCreatePipelineLayout (LGE::gVkDevice,
+			&layout_ci, nullptr, &m_layout);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error ("vkCreatePipelineLayout failed");
+
+		LGE::ShaderReloadWatch (position_color_vert, "Example/position_color.vert");
+		LGE::ShaderReloadWatch (position_color_frag, "Example/position_color.frag");
+	}
+
+	~BenchPipeline (void)
+	{
+		LGE::ShaderReloadForget (this);
+		vkDestroyPipelineLayout (LGE::gVkDevice, m_layout, nullptr);
+	}
+
+	virtual void
+	Create (void) override
+	{
+		VkVertexInputBindingDescription vertex_input_bindings[1] {};
+		vertex_input_bindings[0].binding = 0;
+		vertex_input_bindings[0].stride = 8 * sizeof (float);
+		vertex_input_bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		VkVertexInputAttributeDescription vertex_input_attributes[2] {};
+		vertex_input_attributes[0].location = 0;
+		vertex_input_attributes[0].binding = 0;
+		vertex_input_attributes[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		vertex_input_attributes[0].offset = 0;
+		vertex_input_attributes[1].location = 1;
+		vertex_input_attributes[1].binding = 0;
+		vertex_input_attributes[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		vertex_input_attributes[1].offset = 4 * sizeof (float);
+
+		VkPipelineVertexInputStateCreateInfo vertex_input_state {};
+		vertex_input_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertex_input_state.vertexBindingDescriptionCount = 1;
+		vertex_input_state.pVertexBindingDescriptions = vertex_input_bindings;
+		vertex_input_state.vertexAttributeDescriptionCount = 2;
+		vertex_input_state.pVertexAttributeDescriptions = vertex_input_attributes;
+
+		VkPipelineInputAssemblyStateCreateInfo input_assembly_state {};
+		input_assembly_state.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		input_assembly_state.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+		VkPipelineViewportStateCreateInfo viewport_state {};
+		viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewport_state.viewportCount = 1;
+		viewport_state.scissorCount = 1;
+
+		VkPipelineRasterizationStateCreateInfo rasterization_state {};
+		rasterization_state.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterization_state.cullMode = m_cullMode;
+		rasterization_state.frontFace = VK_FRONT_FACE_CLOCKWISE;
+		rasterization_state.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisample_state {};
+		multisample_state.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisample_state.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+		multisample_state.minSampleShading = 1.0f;
+
+		VkPipelineColorBlendAttachmentState color_blend_attachment_state {};
+		color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+		color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		color_blend_attachment_state.colorWriteMask =
+			VK_COLOR_COMPONENT_R_BIT
+			| VK_COLOR_COMPONENT_G_BIT
+			| VK_COLOR_COMPONENT_B_BIT
+			| VK_COLOR_COMPONENT_A_BIT;
+
+		VkPipelineColorBlendStateCreateInfo color_blend_state {};
+		color_blend_state.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		color_blend_state.logicOp = VK_LOGIC_OP_COPY;
+		color_blend_state.attachmentCount = 1;
+		color_blend_state.pAttachments = &color_blend_attachment_state;
+
+		VkDynamicState dynamic_state_list[2] = {
+			VK_DYNAMIC_STATE_VIEWPORT,
+			VK_DYNAMIC_STATE_SCISSOR
+		};
+
+		VkPipelineDynamicStateCreateInfo dynamic_state {};
+		dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamic_state.dynamicStateCount = 2;
+		dynamic_state.pDynamicStates = dynamic_state_list;
+
+		VkGraphicsPipelineCreateInfo pipeline_ci {};
+		pipeline_ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipeline_ci.pVertexInputState = &vertex_input_state;
+		pipeline_ci.pInputAssemblyState = &input_assembly_state;
+		pipeline_ci.pViewportState = &viewport_state;
+		pipeline_ci.pRasterizationState = &rasterization_state;
+		pipeline_ci.pMultisampleState = &multisample_state;
+		pipeline_ci.pColorBlendState = &color_blend_state;
+		pipeline_ci.pDynamicState = &dynamic_state;
+		pipeline_ci.layout = m_layout;
+		pipeline_ci.renderPass = m_targetRenderPass;
+		pipeline_ci.basePipelineIndex = -1;
+
+		LGE::ShaderModuleInfo shader_module_info[2] {};
+		shader_module_info[0].code = position_color_vert;
+		shader_module_info[0].size = sizeof (position_color_vert);
+		shader_module_info[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		shader_module_info[1].code = position_color_frag;
+		shader_module_info[1].size = sizeof (position_color_frag);
+		shader_module_info[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		LGE::LinkShaderModules (&pipeline_ci, 2, shader_module_info);
+		VkResult result = vkCreateGraphicsPipelines (LGE::gVkDevice,
+			LGE::gPipelineCache, 1, &pipeline_ci, nullptr, &m_pipeline);
+		LGE::FreeShaderModules (&pipeline_ci);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error ("vkCreateGraphicsPipelines failed");
+	}
+};
+
+static const float quad_data[] = {
+	-1.0f,	-1.0f,	0.0f,	1.0f,	1.0f,	0.0f,	0.0f,	1.0f,
+	-1.0f,	1.0f,	0.0f,	1.0f,	0.0f,	1.0f,	0.0f,	1.0f,
+	1.0f,	-1.0f,	0.0f,	1.0f,	0.0f,	0.0f,	1.0f,	1.0f,
+	1.0f,	-1.0f,	0.0f,	1.0f,	0.0f,	0.0f,	1.0f,	1.0f,
+	-1.0f,	1.0f,	0.0f,	1.0f,	0.0f,	1.0f,	0.0f,	1.0f,
+	1.0f,	1.0f,	0.0f,	1.0f,	1.0f,	1.0f,	1.0f,	1.0f,
+};
+
+struct FrameRow {
+	uint64_t frame;
+	double cpu_frame_ms = -1.0;
+	double cpu_draw_ms = -1.0;
+	double gpu_frame_ms = -1.0;
+	double gpu_draw_ms = -1.0;
+	uint64_t stats[LGE::NUM_STATS] {};
+};
+
+class BenchApplication : public LGE::Application {
+private:
+	BenchPipeline *m_pipelines[2] = { nullptr, nullptr };
+	LGE::GPUBuffer m_quad;
+	LGE::GPUBuffer m_uploadTarget;
+	std::vector<uint8_t> m_uploadData;
+
+	std::vector<FrameRow> m_rows;
+	uint64_t m_prevDrawStart = 0;
+	bool m_done = false;
+
+	/**
+	 * Get the row of a measured frame, or nullptr if the frame is not
+	 * measured.
+	 */
+	FrameRow *
+	get_row (uint64_t frame)
+	{
+		if (frame <= config.warmup || frame > (uint64_t) config.warmup + config.measure)
+			return nullptr;
+
+		return &m_rows[frame - config.warmup - 1];
+	}
+
+	void
+	collect (uint64_t frame, uint64_t now)
+	{
+		// The statistics and the CPU frame time of the previous frame are
+		// complete once the next frame has started.
+		FrameRow *row = get_row (frame - 1);
+		if (row) {
+			row->cpu_frame_ms = 1.0e-6 * (double) (now - m_prevDrawStart);
+			::memcpy (row->stats, LGE::StatsGetLastFrame (), sizeof (row->stats));
+		}
+
+		// GPU results arrive CPU_RENDER_AHEAD frames late.
+		const LGE::GPUProfilerScope *scopes;
+		size_t count;
+		row = get_row (LGE::GPUProfilerGetResults (&scopes, &count));
+		if (row && count) {
+			row->gpu_frame_ms = scopes[0].duration;
+			for (size_t i = 1; i < count; i++)
+				if (scopes[i].depth == 1 && !::strcmp (scopes[i].name, "Draw"))
+					row->gpu_draw_ms = scopes[i].duration;
+		}
+
+		// Keep going until the GPU results of every measured frame have
+		// had a chance to be resolved.
+		if (frame > (uint64_t) config.warmup + config.measure + LGE::CPU_RENDER_AHEAD + 1)
+			m_done = true;
+	}
+
+	void
+	create_resources (void)
+	{
+		VkDescriptorSetLayoutBinding bindings[1] {};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+		VkDescriptorSetLayoutCreateInfo ci {};
+		ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		ci.bindingCount = 1;
+		ci.pBindings = bindings;
+
+		set_layout = LGE::GetDescriptorSetLayout (&ci);
+
+		m_pipelines[0] = new BenchPipeline (VK_CULL_MODE_NONE);
+		m_pipelines[1] = new BenchPipeline (VK_CULL_MODE_BACK_BIT);
+
+		m_quad = LGE::MMCreateMeshGPUBuffer (quad_data,
+			sizeof (quad_data), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+		if (config.uploads) {
+			m_uploadData.resize (config.upload_size);
+			for (size_t i = 0; i < m_uploadData.size (); i++)
+				m_uploadData[i] = (uint8_t) (i * 2654435761u >> 24);
+
+			m_uploadTarget = LGE::MMCreateMeshGPUBuffer (nullptr, config.upload_size,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+		}
+
+		m_rows.resize (config.measure);
+		for (uint32_t i = 0; i < config.measure; i++)
+			m_rows[i].frame = config.warmup + i + 1;
+	}
+
+	void
+	write_results (void)
+	{
+		FILE *f = stdout;
+		if (!config.out) {
+			// Keep queued log messages out of the CSV.
+			LGE::LogFlush ();
+		} else {
+			f = ::fopen (config.out, "w");
+			if (!f) {
+				Log ("Failed to open %s", config.out);
+				LGE::gExitCode = 1;
+				return;
+			}
+		}
+
+		::fprintf (f, "frame,cpu_frame_ms,cpu_draw_ms,gpu_frame_ms,gpu_draw_ms");
+		for (int i = 0; i < LGE::NUM_STATS; i++)
+			::fprintf (f, ",%s", LGE::StatGetName ((LGE::StatCounter) i));
+		::fprintf (f, "\n");
+
+		// Missing values, such as GPU timings on devices without
+		// timestamp support, are left empty.
+		auto field = [&](double value) {
+			if (value >= 0.0)
+				::fprintf (f, ",%.4f", value);
+			else
+				::fprintf (f, ",");
+		};
+
+		for (const FrameRow &row : m_rows) {
+			::fprintf (f, "%llu", (unsigned long long) row.frame);
+			field (row.cpu_frame_ms);
+			field (row.cpu_draw_ms);
+			field (row.gpu_frame_ms);
+			field (row.gpu_draw_ms);
+			for (int i = 0; i < LGE::NUM_STATS; i++)
+				::fprintf (f, ",%llu", (unsigned long long) row.stats[i]);
+			::fprintf (f, "\n");
+		}
+
+		if (f != stdout)
+			::fclose (f);
+
+		auto summarize = [&](const char *name, double FrameRow::*member) {
+			std::vector<double> values;
+			for (const FrameRow &row : m_rows)
+				if (row.*member >= 0.0)
+					values.push_back (row.*member);
+
+			if (values.empty ())
+				return;
+
+			std::sort (values.begin (), values.end ());
+			double sum = 0.0;
+			for (double v : values)
+				sum += v;
+
+			Log ("%-12s  mean %8.4f  median %8.4f  p95 %8.4f  max %8.4f ms", name,
+				sum / values.size (), values[values.size () / 2],
+				values[(values.size () * 95) / 100], values.back ());
+		};
+
+		summarize ("cpu_frame", &FrameRow::cpu_frame_ms);
+		summarize ("cpu_draw", &FrameRow::cpu_draw_ms);
+		summarize ("gpu_frame", &FrameRow::gpu_frame_ms);
+		summarize ("gpu_draw", &FrameRow::gpu_draw_ms);
+	}
+
+public:
+	virtual const char *
+	GetUserFriendlyName (void) override
+	{
+		return "Bench";
+	}
+
+	virtual bool
+	KeepRunning (void) override
+	{
+		return !m_done && LGE::Application::KeepRunning ();
+	}
+
+	virtual void
+	Draw (VkCommandBuffer cmd) override
+	{
+		uint64_t start = LGE::TraceNow ();
+		uint64_t frame = LGE::GPUProfilerGetFrameNumber ();
+		collect (frame, start);
+		m_prevDrawStart = start;
+
+		if (!set_layout)
+			create_resources ();
+
+		for (uint32_t i = 0; i < config.uploads; i++)
+			LGE::MMCopyToGPUBuffer (m_uploadTarget, m_uploadData.data (), m_uploadData.size (), 0);
+
+		glm::mat4 view_projection = glm::perspective (1.2f,
+			(float) m_extent.width / (float) m_extent.height, 0.1f, 100.0f)
+			* glm::lookAt (glm::vec3 (0.0f, 0.0f, -40.0f),
+			glm::vec3 (0.0f, 0.0f, 0.0f), glm::vec3 (0.0f, 1.0f, 0.0f));
+
+		// At least one uniform buffer and descriptor set are needed to
+		// draw anything.
+		uint32_t num_uniforms = std::max (config.uniforms, 1u);
+		uint32_t num_sets = std::max (config.sets, 1u);
+
+		std::vector<VkBuffer> uniforms (num_uniforms);
+		for (uint32_t i = 0; i < num_uniforms; i++) {
+			glm::mat4 m = glm::translate (view_projection, glm::vec3 (0.0f, 0.0f, 0.01f * i));
+			uniforms[i] = LGE::MMCreateTemporaryGPUBuffer (&m, sizeof (m),
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+		}
+
+		std::vector<VkDescriptorSet> sets (num_sets);
+		for (uint32_t i = 0; i < num_sets; i++) {
+			VkDescriptorBufferInfo buffer_info {};
+			buffer_info.buffer = uniforms[i % num_uniforms];
+			buffer_info.range = VK_WHOLE_SIZE;
+
+			sets[i] = LGE::CreateTemporaryDescriptorSet (set_layout);
+			VkWriteDescriptorSet writes[1] {};
+			writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[0].dstSet = sets[i];
+			writes[0].dstBinding = 0;
+			writes[0].descriptorCount = 1;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			writes[0].pBufferInfo = &buffer_info;
+			vkUpdateDescriptorSets (LGE::gVkDevice, 1, writes, 0, nullptr);
+		}
+
+		VkViewport viewport {};
+		viewport.width = (float) m_extent.width;
+		viewport.height = (float) m_extent.height;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport (cmd, 0, 1, &viewport);
+
+		VkRect2D scissor {};
+		scissor.extent = m_extent;
+		vkCmdSetScissor (cmd, 0, 1, &scissor);
+
+		BenchPipeline *pipeline = m_pipelines[0];
+		pipeline->Bind (cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
+		vkCmdBindDescriptorSets (cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+			pipeline->m_layout, 0, 1, &sets[0], 0, nullptr);
+
+		VkDeviceSize offsets[1] = { 0 };
+		vkCmdBindVertexBuffers (cmd, 0, 1, &m_quad.m_buffer, offsets);
+
+		// Interleave pipeline binds, descriptor set binds and draws, so
+		// that none of them are trivially redundant.
+		uint32_t steps = std::max ({ config.draws, config.binds, config.sets });
+		float angle = 0.01f * (float) frame;
+		for (uint32_t i = 0; i < steps; i++) {
+			if (i < config.binds) {
+				pipeline = m_pipelines[(i + 1) & 1];
+				pipeline->Bind (cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
+			}
+
+			if (i < config.sets)
+				vkCmdBindDescriptorSets (cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+					pipeline->m_layout, 0, 1, &sets[i], 0, nullptr);
+
+			if (i < config.draws) {
+				glm::mat4 model = glm::translate (glm::identity<glm::mat4> (),
+					glm::vec3 ((float) (i % 32) - 16.0f, (float) ((i / 32) % 32) - 16.0f, 0.0f));
+				model = glm::rotate (model, angle + 0.1f * i, glm::vec3 (0.0f, 0.0f, 1.0f));
+				model = glm::scale (model, glm::vec3 (0.4f));
+
+				vkCmdPushConstants (cmd, pipeline->m_layout,
+					VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof (glm::mat4), &model);
+				vkCmdDraw (cmd, sizeof (quad_data) / (8 * sizeof (float)), 1, 0, 0);
+			}
+		}
+
+		for (uint32_t i = 0; i < config.text; i++)
+			LGE::DebugUIPrintf (20 + 240 * (i / 40), 20 + 12 * (i % 40), LGE::DebugUICorner::TOP_RIGHT,
+				1.0f, 1.0f, 1.0f, 1.0f, "bench string %u, frame %llu", i, (unsigned long long) frame);
+
+		FrameRow *row = get_row (frame);
+		if (row)
+			row->cpu_draw_ms = 1.0e-6 * (double) (LGE::TraceNow () - start);
+	}
+
+	virtual void
+	Cleanup (void) override
+	{
+		if (m_done)
+			write_results ();
+
+		for (BenchPipeline *&pipeline : m_pipelines) {
+			delete pipeline;
+			pipeline = nullptr;
+		}
+
+		if (m_quad)
+			LGE::MMDestroyGPUBuffer (m_quad);
+		if (m_uploadTarget)
+			LGE::MMDestroyGPUBuffer (m_uploadTarget);
+
+		LGE::Application::Cleanup ();
+	}
+};
+
+/**
+ * Parse a "key=value" argument for the benchmark.
+ *
+ * @return true if the argument was consumed.
+ */
+static bool
+parse_arg (const char *arg)
+{
+	static const struct {
+		const char *key;
+		uint32_t BenchConfig::*value;
+	} options[] = {
+		{ "draws=", &BenchConfig::draws },
+		{ "uniforms=", &BenchConfig::uniforms },
+		{ "sets=", &BenchConfig::sets },
+		{ "binds=", &BenchConfig::binds },
+		{ "uploads=", &BenchConfig::uploads },
+		{ "upload-size=", &BenchConfig::upload_size },
+		{ "text=", &BenchConfig::text },
+		{ "warmup=", &BenchConfig::warmup },
+		{ "measure=", &BenchConfig::measure },
+	};
+
+	for (const auto &option : options) {
+		size_t len = ::strlen (option.key);
+		if (!::strncmp (arg, option.key, len)) {
+			config.*option.value = ::strtoul (arg + len, nullptr, 10);
+			return true;
+		}
+	}
+
+	if (!::strncmp (arg, "out=", 4)) {
+		config.out = arg + 4;
+		return true;
+	}
+
+	return false;
+}
+
+int
+main (int argc, const char *argv[])
+{
+	// Pass everything that is not a benchmark option on to LGEMain.
+	std::vector<const char *> lge_argv;
+	for (int i = 0; i < argc; i++)
+		if (!i || !parse_arg (argv[i]))
+			lge_argv.push_back (argv[i]);
+	lge_argv.push_back (nullptr);
+
+	if (!config.measure) {
+		Log ("measure must be at least 1");
+		return 1;
+	}
+
+	BenchApplication app;
+	return LGE::LGEMain (app, lge_argv.data ());
+}
@@ -6,9 +6,11 @@
 
 #include <LGE/Application.h>
 #include <LGE/Descriptor.h>
+#include <LGE/GeometryArena.h>
 #include <LGE/GPUMemory.h>
 #include <LGE/Init.h>
 #include <LGE/Pipeline.h>
+#include <LGE/ShaderReload.h>
 #include <LGE/VulkanFunctions.h>
 
 #include <LGE/Math.h>
@@ -48,10 +50,14 @@ public:
 
 		if (result != VK_SUCCESS)
 			throw std::runtime_error ("vkCreatePipelineLayout failed");
+
+		LGE::ShaderReloadWatch (position_color_vert, "Example/position_color.vert");
+		LGE::ShaderReloadWatch (position_color_frag, "Example/position_color.frag");
 	}
 
 	~HelloTrianglePipeline (void)
 	{
+		LGE::ShaderReloadForget (this);
 		vkDestroyPipelineLayout (LGE::gVkDevice, m_layout, nullptr);
 	}
 
@@ -142,11 +148,11 @@ public:
 		pipeline_ci.basePipelineIndex = -1;
 
 		LGE::ShaderModuleInfo shader_module_info[2] {};
-		shader_module_info[0].code = vertex_shader;
-		shader_module_info[0].size = sizeof (vertex_shader);
+		shader_module_info[0].code = position_color_vert;
+		shader_module_info[0].size = sizeof (position_color_vert);
 		shader_module_info[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-		shader_module_info[1].code = fragment_shader;
-		shader_module_info[1].size = sizeof (fragment_shader);
+		shader_module_info[1].code = position_color_frag;
+		shader_module_info[1].size = sizeof (position_color_frag);
 		shader_module_info[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
 
 		LGE::LinkShaderModules (&pipeline_ci, 2, shader_module_info);
@@ -160,7 +166,8 @@ public:
 };
 
 static HelloTrianglePipeline *hello_triangle = nullptr;
-static LGE::GPUBuffer hello_buffer;
+static LGE::GeometryArena *hello_arena = nullptr;
+static LGE::GeometryRange hello_mesh;
 
 static const float buffer_data[] = {
 	// front
@@ -241,9 +248,12 @@ public:
 		if (!hello_triangle)
 			hello_triangle = new HelloTrianglePipeline;
 
-		if (!hello_buffer)
-			hello_buffer = LGE::MMCreateMeshGPUBuffer (buffer_data,
-				sizeof (buffer_data), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+		if (!hello_arena) {
+			hello_arena = new LGE::GeometryArena (8 * sizeof (float), 4096, 0);
+			if (!hello_arena->Allocate (buffer_data, sizeof (buffer_data) / (8 * sizeof (float)),
+					nullptr, 0, hello_mesh))
+				throw std::runtime_error ("GeometryArena is full");
+		}
 
 		VkViewport viewport {};
 		viewport.x = 0.0f;
@@ -300,10 +310,8 @@ public:
 		vkCmdBindDescriptorSets (cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
 			hello_triangle->m_layout, 0, 1, &set, 0, nullptr);
 
-		VkDeviceSize offsets[1] = { 0 };
-		VkBuffer buffers[1] = { hello_buffer.m_buffer };
-		vkCmdBindVertexBuffers (cmd, 0, 1, buffers, offsets);
-		vkCmdDraw (cmd, sizeof (buffer_data) / 8 * sizeof (float), 1, 0, 0);
+		hello_arena->Bind (cmd);
+		hello_arena->Draw (cmd, hello_mesh);
 	}
 
 	virtual void
@@ -314,8 +322,11 @@ public:
 			hello_triangle = nullptr;
 		}
 
-		if (hello_buffer)
-			LGE::MMDestroyGPUBuffer (hello_buffer);
+		if (hello_arena) {
+			hello_arena->Free (hello_mesh);
+			delete hello_arena;
+			hello_arena = nullptr;
+		}
 
 		LGE::Application::Cleanup ();
 	}
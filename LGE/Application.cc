@@ -7,7 +7,14 @@
 #include <LGE/Application.h>
 #include <LGE/DebugUI.h>
 #include <LGE/GPUMemory.h>
+#include <LGE/GPUProfiler.h>
 #include <LGE/Log.h>
+#include <LGE/Pipeline.h>
+#include <LGE/ProfilerOverlay.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/Stats.h>
+#include <LGE/TextureStreaming.h>
+#include <LGE/Trace.h>
 #include <LGE/Vulkan.h>
 #include <LGE/Window.h>
 
@@ -20,7 +27,12 @@ namespace LGE {
 
 Application *gApplication;
 
-Application::~Application (void) {}
+Application::~Application (void)
+{
+	DebugUIDestroyText (m_frameRateText);
+	DebugUIDestroyText (m_frameTimeText);
+}
+
 Application::Application (void) {}
 
 const char *Application::GetUserFriendlyName (void)
@@ -62,6 +74,7 @@ Application::HandleEvent (const VKFWevent &e)
 void
 Application::Render (void)
 {
+	LGE_TRACE_SCOPE ("Render");
 	VkResult result;
 
 	if (m_commandPools[m_frameIndex] == VK_NULL_HANDLE) {
@@ -130,6 +143,7 @@ Application::Render (void)
 		return;
 
 	if (m_renderPass == VK_NULL_HANDLE || m_format != gWindow->GetSwapchainFormat ()) {
+		ShaderReloadPause pause;
 		if (m_renderPass != VK_NULL_HANDLE) {
 			::vkDestroyRenderPass (gVkDevice, m_renderPass, nullptr);
 			m_renderPass = VK_NULL_HANDLE;
@@ -169,10 +183,31 @@ Application::Render (void)
 	m_frameIndex++;
 	if (m_frameIndex >= CPU_RENDER_AHEAD)
 		m_frameIndex = 0;
+	StatsNextFrame ();
 	MMNextFrame ();
+	PipelineNextFrame ();
+	DebugUINextFrame ();
+	GPUProfilerNextFrame (cmd);
+	ProfilerOverlayNextFrame ();
+	TextureStreamingNextFrame (cmd);
+	ShaderReloadNextFrame ();
+
+	ProfileScopeBegin (cmd, "PrepareDraw");
+	{
+		LGE_TRACE_SCOPE ("PrepareDraw");
+		this->PrepareDraw (cmd);
+	}
+	ProfileScopeEnd (cmd);
 
+	DebugUIUploadGlyphs (cmd);
 	this->BeginRendering (cmd, m_renderPass, m_framebuffer, gWindow->GetImageView (swapchain_index));
-	this->Draw (cmd);
+
+	ProfileScopeBegin (cmd, "Draw");
+	{
+		LGE_TRACE_SCOPE ("Draw");
+		this->Draw (cmd);
+	}
+	ProfileScopeEnd (cmd);
 
 	uint64_t frame_time = vkfwGetTime ();
 	float delta_ms = (float) (frame_time - m_prevFrameTime) / 1000.0f;
@@ -181,19 +216,32 @@ Application::Render (void)
 	m_averagedFrameTime += delta_ms;
 	m_numFpsFrames++;
 
+	if (!m_frameRateText) {
+		m_frameRateText = DebugUICreateText ();
+		m_frameTimeText = DebugUICreateText ();
+	}
+
 	if (m_averagedFrameTime >= 50.0f) {
 		m_displayedFrameTime = m_averagedFrameTime / m_numFpsFrames;
 		m_averagedFrameTime = 0.0f;
 		m_numFpsFrames = 0;
+
+		DebugUISetTextPrintf (m_frameRateText, 20, 60, DebugUICorner::TOP_LEFT,
+			0.0f, 1.0f, 0.0f, 1.0f, "framerate: %.1f", 1000.0f / m_displayedFrameTime);
+		DebugUISetTextPrintf (m_frameTimeText, 20, 60 + DebugUIGetLineHeight (), DebugUICorner::TOP_LEFT,
+			0.0f, 1.0f, 0.0f, 1.0f, "frametime: %.2f ms", m_displayedFrameTime);
 	}
+	// Below the framerate and frametime lines, with half a line of space.
+	int line_height = DebugUIGetLineHeight ();
+	GPUProfilerDrawDebugUI (20, 60 + 2 * line_height + line_height / 2, DebugUICorner::TOP_LEFT);
+	ProfilerOverlayDraw (20, 20, DebugUICorner::TOP_RIGHT);
 
-	DebugUIPrintf (20, 60, DebugUICorner::TOP_LEFT, 0.0f, 1.0f, 0.0f, 1.0f,
-		"framerate: %.1f", 1000.0f / m_displayedFrameTime);
-	DebugUIPrintf (20, 72, DebugUICorner::TOP_LEFT, 0.0f, 1.0f, 0.0f, 1.0f,
-		"frametime: %.2f ms", m_displayedFrameTime);
+	ProfileScopeBegin (cmd, "DebugUI");
 	DebugUIDraw (cmd);
+	ProfileScopeEnd (cmd);
 
 	::vkCmdEndRenderPass (cmd);
+	GPUProfilerEndFrame (cmd);
 
 	result = ::vkEndCommandBuffer (cmd);
 	if (result != VK_SUCCESS)
@@ -232,7 +280,7 @@ Application::CreateRenderPass (void)
 	ad.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	ad.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	ad.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	ad.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	ad.finalLayout = gWindow->GetPresentLayout ();
 
 	VkAttachmentReference ar {};
 	ar.attachment = 0;
@@ -328,6 +376,10 @@ Application::BeginRendering (VkCommandBuffer cmd, VkRenderPass rp, VkFramebuffer
 	::vkCmdBeginRenderPass (cmd, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
 }
 
+void
+Application::PrepareDraw (VkCommandBuffer cmd)
+{}
+
 void
 Application::Draw (VkCommandBuffer cmd)
 {}
@@ -0,0 +1,314 @@
+/**
+ * Memory-mapped asset packs.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEAssetPack"
+
+#include <LGE/AssetPack.h>
+#include <LGE/GPUDecompress.h>
+#include <LGE/LZ.h>
+#include <LGE/Trace.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace LGE {
+
+/**
+ * Smaller entries decode faster on the CPU than with one serial shader
+ * invocation per chunk.
+ */
+static constexpr uint64_t GPU_DECOMPRESSION_MIN_SIZE = 1 << 20;
+
+[[noreturn]] static void
+fail (const std::string &path, const char *what)
+{
+	throw std::runtime_error ("AssetPack: " + path + ": " + what);
+}
+
+static bool
+in_range (uint64_t offset, uint64_t size, uint64_t limit)
+{
+	return offset <= limit && size <= limit - offset;
+}
+
+static bool
+entry_less (const AssetPackEntry &a, std::string_view a_name,
+	const AssetPackEntry &b, std::string_view b_name)
+{
+	if (a.m_nameHash != b.m_nameHash)
+		return a.m_nameHash < b.m_nameHash;
+
+	return a_name < b_name;
+}
+
+AssetPack::AssetPack (const char *path)
+	: m_path (path)
+{
+	int fd = ::open (path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		fail (m_path, "cannot open file");
+
+	struct stat st;
+	if (::fstat (fd, &st) || st.st_size < (off_t) sizeof (AssetPackHeader)) {
+		::close (fd);
+		fail (m_path, "file is too small");
+	}
+
+	// The mapping keeps the file open.
+	m_size = (size_t) st.st_size;
+	void *data = ::mmap (nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close (fd);
+	if (data == MAP_FAILED)
+		fail (m_path, "cannot map file");
+
+	m_data = (const uint8_t *) data;
+
+	try {
+		AssetPackHeader header;
+		::memcpy (&header, m_data, sizeof (header));
+		if (::memcmp (header.m_magic, ASSET_PACK_MAGIC, sizeof (ASSET_PACK_MAGIC)))
+			fail (m_path, "not an asset pack");
+
+		if (!in_range (header.m_tocOffset, (uint64_t) header.m_numEntries * sizeof (AssetPackEntry), m_size)
+			|| header.m_tocOffset % alignof (AssetPackEntry))
+			fail (m_path, "invalid table of contents");
+		if (!in_range (header.m_namesOffset, header.m_namesSize, m_size))
+			fail (m_path, "invalid names");
+
+		m_entries = (const AssetPackEntry *) (m_data + header.m_tocOffset);
+		m_numEntries = header.m_numEntries;
+		m_names = (const char *) (m_data + header.m_namesOffset);
+
+		for (uint32_t i = 0; i < m_numEntries; i++) {
+			const AssetPackEntry &entry = m_entries[i];
+			if (!in_range (entry.m_nameOffset, entry.m_nameLength, header.m_namesSize))
+				fail (m_path, "entry name is outside of the names");
+			if (!in_range (entry.m_offset, entry.m_size, m_size)
+				|| entry.m_offset % ASSET_PACK_ALIGNMENT)
+				fail (m_path, "entry data is outside of the file");
+			if (entry.m_type > ASSET_PACK_TEXTURE || entry.m_compression > ASSET_PACK_LZ)
+				fail (m_path, "unknown entry type or compression");
+			if (entry.m_compression == ASSET_PACK_UNCOMPRESSED
+				&& entry.m_size != entry.m_uncompressedSize)
+				fail (m_path, "entry size does not match");
+
+			// Find depends on the order.
+			if (i && !entry_less (m_entries[i - 1], GetName (m_entries[i - 1]),
+					entry, GetName (entry)))
+				fail (m_path, "table of contents is not sorted");
+		}
+	} catch (...) {
+		::munmap (data, m_size);
+		throw;
+	}
+}
+
+AssetPack::~AssetPack (void)
+{
+	::munmap ((void *) m_data, m_size);
+}
+
+const AssetPackEntry *
+AssetPack::Find (std::string_view name) const
+{
+	uint64_t hash = AssetPackHash (name.data (), name.size ());
+	const AssetPackEntry *end = m_entries + m_numEntries;
+	const AssetPackEntry *it = std::lower_bound (m_entries, end, hash,
+		[] (const AssetPackEntry &entry, uint64_t hash) {
+			return entry.m_nameHash < hash;
+		});
+
+	for (; it != end && it->m_nameHash == hash; it++)
+		if (GetName (*it) == name)
+			return it;
+
+	return nullptr;
+}
+
+void
+AssetPack::Read (const AssetPackEntry &entry, void *data) const
+{
+	LGE_TRACE_SCOPE ("AssetPackRead");
+
+	const uint8_t *src = m_data + entry.m_offset;
+	uint8_t *out = (uint8_t *) data;
+	if (entry.m_compression == ASSET_PACK_UNCOMPRESSED) {
+		::memcpy (out, src, entry.m_size);
+		return;
+	}
+
+	uint64_t num_chunks = AssetPackNumChunks (entry.m_uncompressedSize);
+	uint64_t table_size = (num_chunks + 1) * sizeof (uint32_t);
+	if (table_size > entry.m_size)
+		fail (m_path, "truncated chunk table");
+
+	// Matches read back the output. data is often write-combined staging
+	// memory, which is very slow to read, so every chunk is decompressed
+	// into a buffer that stays in the cache, and then copied out.
+	static thread_local uint8_t chunk[ASSET_PACK_CHUNK_SIZE];
+
+	for (uint64_t i = 0; i < num_chunks; i++) {
+		uint32_t begin, end;
+		::memcpy (&begin, src + i * sizeof (uint32_t), sizeof (begin));
+		::memcpy (&end, src + (i + 1) * sizeof (uint32_t), sizeof (end));
+		if (begin < table_size || begin > end || end > entry.m_size)
+			fail (m_path, "corrupt chunk table");
+
+		uint64_t offset = i * ASSET_PACK_CHUNK_SIZE;
+		size_t chunk_size = (size_t) std::min<uint64_t> (ASSET_PACK_CHUNK_SIZE,
+			entry.m_uncompressedSize - offset);
+
+		if (end - begin == chunk_size) {
+			::memcpy (out + offset, src + begin, chunk_size);
+			continue;
+		}
+
+		if (!LZDecompress (src + begin, end - begin, chunk, chunk_size))
+			fail (m_path, "corrupt compressed data");
+
+		::memcpy (out + offset, chunk, chunk_size);
+	}
+}
+
+bool
+AssetPack::UseGPUDecompression (const AssetPackEntry &entry) const
+{
+	return m_gpuDecompression && entry.m_compression == ASSET_PACK_LZ
+		&& entry.m_uncompressedSize >= GPU_DECOMPRESSION_MIN_SIZE
+		&& GPUDecompressSupported (entry.m_size, entry.m_uncompressedSize);
+}
+
+struct EntryWrite {
+	const AssetPack *m_pack;
+	const AssetPackEntry *m_entry;
+};
+
+static void
+write_entry (void *mapped, size_t size, void *user)
+{
+	(void) size;
+
+	const EntryWrite *write = (const EntryWrite *) user;
+	write->m_pack->Read (*write->m_entry, mapped);
+}
+
+void
+AssetPack::LoadBuffers (const AssetPackEntry *const *entries, uint32_t count,
+	VkBufferUsageFlags usage, GPUBuffer *buffers, MMMemoryClass memory_class) const
+{
+	LGE_TRACE_SCOPE ("AssetPackLoadBuffers");
+
+	GPUDecompressBatch batch;
+	uint32_t created = 0;
+	try {
+		while (created < count) {
+			const AssetPackEntry &entry = *entries[created];
+			if (!entry.m_uncompressedSize)
+				fail (m_path, "cannot create an empty buffer");
+
+			bool gpu = UseGPUDecompression (entry);
+			VkBufferUsageFlags buffer_usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			size_t size = entry.m_uncompressedSize;
+			if (gpu) {
+				// The shader writes whole words.
+				buffer_usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+				size = (size + 3) & ~(size_t) 3;
+			}
+
+			GPUBuffer &buffer = buffers[created];
+			buffer = MMCreateMeshGPUBuffer (nullptr, size, buffer_usage, memory_class);
+			created++;
+
+			if (gpu) {
+				batch.AddBuffer (m_data + entry.m_offset, entry.m_size,
+					entry.m_uncompressedSize, buffer, 0);
+			} else {
+				EntryWrite write { this, &entry };
+				MMUploadToGPUBuffer (buffer, entry.m_uncompressedSize, 0, write_entry, &write);
+			}
+		}
+
+		batch.Submit ();
+	} catch (...) {
+		for (uint32_t i = 0; i < created; i++)
+			MMDestroyGPUBuffer (buffers[i]);
+
+		throw;
+	}
+}
+
+GPUBuffer
+AssetPack::LoadBuffer (const AssetPackEntry &entry, VkBufferUsageFlags usage,
+	MMMemoryClass memory_class) const
+{
+	const AssetPackEntry *entries[1] = { &entry };
+	GPUBuffer buffer;
+	LoadBuffers (entries, 1, usage, &buffer, memory_class);
+	return buffer;
+}
+
+void
+AssetPack::LoadTextures (const AssetPackEntry *const *entries, uint32_t count,
+	GPUImage *images) const
+{
+	LGE_TRACE_SCOPE ("AssetPackLoadTextures");
+
+	GPUDecompressBatch batch;
+	uint32_t created = 0;
+	try {
+		for (; created < count; created++) {
+			const AssetPackEntry &entry = *entries[created];
+			if (entry.m_type != ASSET_PACK_TEXTURE)
+				fail (m_path, "entry is not a texture");
+
+			VkFormat format = (VkFormat) entry.m_format;
+			VkExtent3D extent = { entry.m_width, entry.m_height, 1 };
+			if (!extent.width || !extent.height || !entry.m_layers || !entry.m_levels
+				|| entry.m_levels > MMGetMipLevelCount (extent))
+				fail (m_path, "invalid texture entry");
+
+			VkDeviceSize layer_size = 0;
+			for (uint32_t level = 0; level < entry.m_levels; level++)
+				layer_size += MMGetMipLevelSize (format, extent, level);
+
+			if (layer_size * entry.m_layers != entry.m_uncompressedSize)
+				fail (m_path, "texture size does not match its format");
+
+			if (UseGPUDecompression (entry)) {
+				images[created] = batch.AddTexture2DArray (m_data + entry.m_offset,
+					entry.m_size, entry.m_uncompressedSize, format,
+					{ extent.width, extent.height }, entry.m_layers, entry.m_levels,
+					entry.m_flags);
+			} else {
+				EntryWrite write { this, &entry };
+				images[created] = MMUploadTexture2DArray (format, { extent.width, extent.height },
+					entry.m_layers, write_entry, &write, entry.m_levels, false, entry.m_flags);
+			}
+		}
+
+		batch.Submit ();
+	} catch (...) {
+		for (uint32_t i = 0; i < created; i++)
+			MMDestroyGPUImage (images[i]);
+
+		throw;
+	}
+}
+
+GPUImage
+AssetPack::LoadTexture (const AssetPackEntry &entry) const
+{
+	const AssetPackEntry *entries[1] = { &entry };
+	GPUImage image;
+	LoadTextures (entries, 1, &image);
+	return image;
+}
+
+}
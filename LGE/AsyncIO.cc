@@ -0,0 +1,640 @@
+/**
+ * Asynchronous file I/O.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEAsyncIO"
+
+#include <LGE/AsyncIO.h>
+#include <LGE/Log.h>
+#include <LGE/Trace.h>
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LGE {
+
+enum class Backend {
+	NONE,
+	IO_URING,
+	THREADS
+};
+
+static Backend backend = Backend::NONE;
+
+static constexpr unsigned QUEUE_DEPTH = 128;
+static constexpr unsigned NUM_THREADS = 4;
+
+/** Times AsyncIOWait retries a busy io_uring_enter that completes nothing. */
+static constexpr unsigned MAX_BUSY_RETRIES = 1000;
+
+/** Longer reads are split, as if the kernel had returned a short read. */
+static constexpr size_t MAX_READ_SIZE = (size_t) 1 << 30;
+
+struct Request {
+	AsyncIORead m_read;
+	size_t m_done;
+
+	/** Index of the registered buffer that holds m_buffer, or -1. */
+	int m_bufferIndex;
+};
+
+/** Requests by slot. Only used by the submitting thread. */
+static std::vector<Request> requests;
+static std::vector<uint32_t> free_slots;
+static uint32_t num_outstanding = 0;
+
+/** Requests that are submitted to the kernel or the thread pool. */
+static uint32_t in_flight = 0;
+
+static struct iovec buffers[ASYNC_IO_MAX_BUFFERS];
+static uint32_t num_buffers = 0;
+static bool buffers_registered = false;
+
+static bool
+read_fully (int fd, void *data, size_t size, uint64_t offset)
+{
+	uint8_t *p = (uint8_t *) data;
+	while (size) {
+		ssize_t n = ::pread (fd, p, std::min (size, MAX_READ_SIZE), (off_t) offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+
+		p += n;
+		size -= (size_t) n;
+		offset += (uint64_t) n;
+	}
+
+	return true;
+}
+
+static int
+find_buffer (const void *data, size_t size)
+{
+	if (!buffers_registered)
+		return -1;
+
+	uintptr_t begin = (uintptr_t) data;
+	for (uint32_t i = 0; i < num_buffers; i++) {
+		uintptr_t base = (uintptr_t) buffers[i].iov_base;
+		if (begin >= base && begin - base <= buffers[i].iov_len
+			&& size <= buffers[i].iov_len - (begin - base))
+			return (int) i;
+	}
+
+	return -1;
+}
+
+static uint32_t
+alloc_slot (const AsyncIORead &read)
+{
+	uint32_t slot;
+	if (free_slots.empty ()) {
+		slot = (uint32_t) requests.size ();
+		requests.emplace_back ();
+	} else {
+		slot = free_slots.back ();
+		free_slots.pop_back ();
+	}
+
+	Request &request = requests[slot];
+	request.m_read = read;
+	request.m_done = 0;
+	request.m_bufferIndex = find_buffer (read.m_buffer, read.m_size);
+	num_outstanding++;
+	return slot;
+}
+
+static void
+finish (uint32_t slot, bool ok)
+{
+	// The callback may submit more reads, which can reallocate requests.
+	AsyncIORead read = requests[slot].m_read;
+	free_slots.push_back (slot);
+	num_outstanding--;
+
+	read.m_callback (read.m_user, ok);
+}
+
+/*
+ * io_uring backend. liburing is not used; the rings are set up with the
+ * system calls directly, which is all that LGE needs.
+ */
+
+struct Ring {
+	int m_fd = -1;
+
+	void *m_sq = nullptr;
+	size_t m_sqSize = 0;
+	void *m_cq = nullptr;
+	size_t m_cqSize = 0;
+	io_uring_sqe *m_sqes = nullptr;
+	size_t m_sqesSize = 0;
+
+	unsigned *m_sqHead, *m_sqTail, *m_sqArray;
+	unsigned m_sqMask, m_sqEntries;
+
+	unsigned *m_cqHead, *m_cqTail;
+	io_uring_cqe *m_cqes;
+	unsigned m_cqMask, m_cqEntries;
+
+	/** Submission queue entries that the kernel has not consumed yet. */
+	unsigned m_toSubmit = 0;
+};
+
+static Ring ring;
+
+/** Slots that wait for room in the submission queue. */
+static std::vector<uint32_t> pending;
+
+static int
+sys_io_uring_setup (unsigned entries, io_uring_params *params)
+{
+	return (int) ::syscall (__NR_io_uring_setup, entries, params);
+}
+
+static int
+sys_io_uring_enter (int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+	return (int) ::syscall (__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+static int
+sys_io_uring_register (int fd, unsigned opcode, const void *arg, unsigned nr_args)
+{
+	return (int) ::syscall (__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void
+ring_terminate (void)
+{
+	if (ring.m_sqes)
+		::munmap (ring.m_sqes, ring.m_sqesSize);
+	if (ring.m_cq && ring.m_cq != ring.m_sq)
+		::munmap (ring.m_cq, ring.m_cqSize);
+	if (ring.m_sq)
+		::munmap (ring.m_sq, ring.m_sqSize);
+	if (ring.m_fd >= 0)
+		::close (ring.m_fd);
+
+	ring = {};
+}
+
+static void *
+map_ring (size_t size, off_t offset)
+{
+	void *p = ::mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		ring.m_fd, offset);
+	return (p == MAP_FAILED) ? nullptr : p;
+}
+
+static bool
+ring_init (void)
+{
+	io_uring_params params {};
+	ring.m_fd = sys_io_uring_setup (QUEUE_DEPTH, &params);
+	if (ring.m_fd < 0) {
+		Log ("io_uring is not available (%s)", ::strerror (errno));
+		ring = {};
+		return false;
+	}
+
+	// IORING_OP_READ appeared together with this feature, in Linux 5.6.
+	if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+		Log ("io_uring does not support IORING_OP_READ");
+		ring_terminate ();
+		return false;
+	}
+
+	ring.m_sqSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+	ring.m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof (io_uring_cqe);
+	bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+	if (single_mmap)
+		ring.m_sqSize = ring.m_cqSize = std::max (ring.m_sqSize, ring.m_cqSize);
+
+	ring.m_sq = map_ring (ring.m_sqSize, IORING_OFF_SQ_RING);
+	if (ring.m_sq)
+		ring.m_cq = single_mmap ? ring.m_sq : map_ring (ring.m_cqSize, IORING_OFF_CQ_RING);
+
+	ring.m_sqesSize = params.sq_entries * sizeof (io_uring_sqe);
+	if (ring.m_cq)
+		ring.m_sqes = (io_uring_sqe *) map_ring (ring.m_sqesSize, IORING_OFF_SQES);
+
+	if (!ring.m_sqes) {
+		Log ("Cannot map the io_uring rings (%s)", ::strerror (errno));
+		ring_terminate ();
+		return false;
+	}
+
+	uint8_t *sq = (uint8_t *) ring.m_sq;
+	ring.m_sqHead = (unsigned *) (sq + params.sq_off.head);
+	ring.m_sqTail = (unsigned *) (sq + params.sq_off.tail);
+	ring.m_sqArray = (unsigned *) (sq + params.sq_off.array);
+	ring.m_sqMask = *(unsigned *) (sq + params.sq_off.ring_mask);
+	ring.m_sqEntries = params.sq_entries;
+
+	uint8_t *cq = (uint8_t *) ring.m_cq;
+	ring.m_cqHead = (unsigned *) (cq + params.cq_off.head);
+	ring.m_cqTail = (unsigned *) (cq + params.cq_off.tail);
+	ring.m_cqes = (io_uring_cqe *) (cq + params.cq_off.cqes);
+	ring.m_cqMask = *(unsigned *) (cq + params.cq_off.ring_mask);
+	ring.m_cqEntries = params.cq_entries;
+	return true;
+}
+
+/**
+ * Put the rest of a request into the submission queue. Returns false if
+ * there is no room, either in the submission queue or for its completion.
+ */
+static bool
+ring_queue (uint32_t slot)
+{
+	unsigned tail = *ring.m_sqTail;
+	unsigned head = __atomic_load_n (ring.m_sqHead, __ATOMIC_ACQUIRE);
+	if (tail - head >= ring.m_sqEntries || in_flight >= ring.m_cqEntries)
+		return false;
+
+	const Request &request = requests[slot];
+	const AsyncIORead &read = request.m_read;
+	unsigned index = tail & ring.m_sqMask;
+
+	io_uring_sqe *sqe = &ring.m_sqes[index];
+	::memset (sqe, 0, sizeof (*sqe));
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = read.m_fd;
+	sqe->off = read.m_offset + request.m_done;
+	sqe->addr = (uint64_t) (uintptr_t) ((uint8_t *) read.m_buffer + request.m_done);
+	sqe->len = (uint32_t) std::min (read.m_size - request.m_done, MAX_READ_SIZE);
+	sqe->user_data = slot;
+	if (request.m_bufferIndex >= 0) {
+		sqe->opcode = IORING_OP_READ_FIXED;
+		sqe->buf_index = (uint16_t) request.m_bufferIndex;
+	}
+
+	ring.m_sqArray[index] = index;
+	__atomic_store_n (ring.m_sqTail, tail + 1, __ATOMIC_RELEASE);
+	ring.m_toSubmit++;
+	in_flight++;
+	return true;
+}
+
+/**
+ * Submit the queued entries, and wait for min_complete completions. Returns
+ * false if the kernel is busy: it is out of resources for now, or the
+ * completion queue has overflowed. The entries stay queued, and are submitted
+ * by the next call.
+ */
+static bool
+ring_enter (unsigned min_complete)
+{
+	unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+	for (;;) {
+		int ret = sys_io_uring_enter (ring.m_fd, ring.m_toSubmit, min_complete, flags);
+		if (ret >= 0) {
+			ring.m_toSubmit -= (unsigned) ret;
+			return true;
+		}
+
+		if (errno == EINTR)
+			continue;
+
+		if (errno == EAGAIN || errno == EBUSY)
+			return false;
+
+		throw std::runtime_error (std::string ("io_uring_enter failed: ") + ::strerror (errno));
+	}
+}
+
+static void
+ring_flush (void)
+{
+	size_t queued = 0;
+	while (queued < pending.size () && ring_queue (pending[queued]))
+		queued++;
+
+	pending.erase (pending.begin (), pending.begin () + queued);
+	if (ring.m_toSubmit)
+		ring_enter (0);
+}
+
+static uint32_t
+ring_reap (void)
+{
+	struct Completion {
+		uint32_t m_slot;
+		int m_result;
+	};
+
+	// Consume the completions before calling any callbacks, which may
+	// submit more reads.
+	std::vector<Completion> completions;
+	unsigned head = *ring.m_cqHead;
+	unsigned tail = __atomic_load_n (ring.m_cqTail, __ATOMIC_ACQUIRE);
+	for (; head != tail; head++) {
+		const io_uring_cqe &cqe = ring.m_cqes[head & ring.m_cqMask];
+		completions.push_back ({ (uint32_t) cqe.user_data, cqe.res });
+	}
+
+	__atomic_store_n (ring.m_cqHead, head, __ATOMIC_RELEASE);
+	in_flight -= (uint32_t) completions.size ();
+
+	uint32_t finished = 0;
+	for (const Completion &completion : completions) {
+		Request &request = requests[completion.m_slot];
+		int result = completion.m_result;
+		if (result == -EINTR || result == -EAGAIN) {
+			pending.push_back (completion.m_slot);
+			continue;
+		}
+
+		if (result > 0) {
+			request.m_done += (size_t) result;
+			if (request.m_done < request.m_read.m_size) {
+				pending.push_back (completion.m_slot);
+				continue;
+			}
+		}
+
+		finish (completion.m_slot, result >= 0 && request.m_done == request.m_read.m_size);
+		finished++;
+	}
+
+	return finished;
+}
+
+/*
+ * Thread pool backend, for kernels without io_uring, or where it is
+ * disabled.
+ */
+
+struct PoolJob {
+	uint32_t m_slot;
+	AsyncIORead m_read;
+};
+
+struct PoolResult {
+	uint32_t m_slot;
+	bool m_ok;
+};
+
+static std::mutex pool_lock;
+static std::condition_variable pool_cond;
+static std::condition_variable pool_done_cond;
+static std::deque<PoolJob> pool_jobs;
+static std::vector<PoolResult> pool_results;
+static bool pool_exit = false;
+static std::thread pool_threads[NUM_THREADS];
+
+static void
+pool_main (void)
+{
+	TraceSetThreadName ("AsyncIO");
+
+	std::unique_lock<std::mutex> lock (pool_lock);
+	for (;;) {
+		pool_cond.wait (lock, [] { return pool_exit || !pool_jobs.empty (); });
+		if (pool_exit)
+			return;
+
+		PoolJob job = pool_jobs.front ();
+		pool_jobs.pop_front ();
+		lock.unlock ();
+
+		bool ok;
+		{
+			LGE_TRACE_SCOPE ("AsyncIORead");
+			ok = read_fully (job.m_read.m_fd, job.m_read.m_buffer, job.m_read.m_size,
+				job.m_read.m_offset);
+		}
+
+		lock.lock ();
+		pool_results.push_back ({ job.m_slot, ok });
+		pool_done_cond.notify_one ();
+	}
+}
+
+static uint32_t
+pool_reap (bool wait)
+{
+	std::vector<PoolResult> results;
+	{
+		std::unique_lock<std::mutex> lock (pool_lock);
+		if (wait)
+			pool_done_cond.wait (lock, [] { return !pool_results.empty (); });
+
+		results.swap (pool_results);
+	}
+
+	in_flight -= (uint32_t) results.size ();
+	for (const PoolResult &result : results)
+		finish (result.m_slot, result.m_ok);
+
+	return (uint32_t) results.size ();
+}
+
+static void
+pool_terminate (void)
+{
+	{
+		std::lock_guard<std::mutex> lock (pool_lock);
+		pool_exit = true;
+	}
+
+	pool_cond.notify_all ();
+	for (std::thread &thread : pool_threads)
+		if (thread.joinable ())
+			thread.join ();
+}
+
+static void
+start (void)
+{
+	if (ring_init ()) {
+		Log ("Using io_uring for asynchronous I/O");
+		backend = Backend::IO_URING;
+		return;
+	}
+
+	Log ("Using a thread pool for asynchronous I/O");
+	backend = Backend::THREADS;
+	pool_exit = false;
+	for (std::thread &thread : pool_threads)
+		thread = std::thread (pool_main);
+}
+
+void
+AsyncIOSubmit (const AsyncIORead *reads, uint32_t count)
+{
+	if (backend == Backend::NONE)
+		start ();
+
+	if (backend == Backend::IO_URING) {
+		for (uint32_t i = 0; i < count; i++)
+			pending.push_back (alloc_slot (reads[i]));
+
+		ring_flush ();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock (pool_lock);
+		for (uint32_t i = 0; i < count; i++)
+			pool_jobs.push_back ({ alloc_slot (reads[i]), reads[i] });
+	}
+
+	in_flight += count;
+	pool_cond.notify_all ();
+}
+
+uint32_t
+AsyncIOPoll (void)
+{
+	if (backend == Backend::IO_URING) {
+		uint32_t finished = ring_reap ();
+		ring_flush ();
+		return finished;
+	}
+
+	if (backend == Backend::THREADS)
+		return pool_reap (false);
+
+	return 0;
+}
+
+void
+AsyncIOWait (void)
+{
+	LGE_TRACE_SCOPE ("AsyncIOWait");
+
+	unsigned busy_retries = 0;
+	while (num_outstanding) {
+		if (backend == Backend::IO_URING) {
+			ring_flush ();
+			if (in_flight && !ring_enter (1)) {
+				// Reaping the completion queue frees the resources
+				// that the kernel is short of. If nothing had
+				// completed, back off before trying again.
+				unsigned head = *ring.m_cqHead;
+				ring_reap ();
+				if (*ring.m_cqHead != head) {
+					busy_retries = 0;
+					continue;
+				}
+
+				if (++busy_retries > MAX_BUSY_RETRIES)
+					throw std::runtime_error ("io_uring_enter stays busy with no completions");
+
+				std::this_thread::sleep_for (std::chrono::microseconds (
+					std::min (busy_retries * 10u, 1000u)));
+				continue;
+			}
+
+			busy_retries = 0;
+			ring_reap ();
+		} else {
+			pool_reap (true);
+		}
+	}
+}
+
+/**
+ * Register the buffer table with the kernel, replacing the previous
+ * registration.
+ */
+static bool
+register_buffers (void)
+{
+	if (backend != Backend::IO_URING)
+		return false;
+
+	if (buffers_registered) {
+		sys_io_uring_register (ring.m_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+		buffers_registered = false;
+	}
+
+	if (!num_buffers)
+		return false;
+
+	if (sys_io_uring_register (ring.m_fd, IORING_REGISTER_BUFFERS, buffers, num_buffers) < 0) {
+		LGE_LOG_WARNING ("Cannot register I/O buffers: %s", ::strerror (errno));
+		return false;
+	}
+
+	buffers_registered = true;
+	return true;
+}
+
+bool
+AsyncIORegisterBuffer (void *data, size_t size)
+{
+	if (backend == Backend::NONE)
+		start ();
+
+	if (backend != Backend::IO_URING || num_buffers == ASYNC_IO_MAX_BUFFERS)
+		return false;
+
+	// Reads in flight refer to buffers by index.
+	AsyncIOWait ();
+
+	buffers[num_buffers].iov_base = data;
+	buffers[num_buffers].iov_len = size;
+	num_buffers++;
+	if (register_buffers ())
+		return true;
+
+	num_buffers--;
+	register_buffers ();
+	return false;
+}
+
+void
+AsyncIOUnregisterBuffer (void *data)
+{
+	for (uint32_t i = 0; i < num_buffers; i++) {
+		if (buffers[i].iov_base != data)
+			continue;
+
+		AsyncIOWait ();
+		std::copy (buffers + i + 1, buffers + num_buffers, buffers + i);
+		num_buffers--;
+		register_buffers ();
+		return;
+	}
+}
+
+void
+AsyncIOTerminate (void)
+{
+	if (backend == Backend::NONE)
+		return;
+
+	AsyncIOWait ();
+	if (backend == Backend::IO_URING)
+		ring_terminate ();
+	else
+		pool_terminate ();
+
+	num_buffers = 0;
+	buffers_registered = false;
+	requests.clear ();
+	free_slots.clear ();
+	backend = Backend::NONE;
+}
+
+}
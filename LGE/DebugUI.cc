@@ -10,13 +10,29 @@
 #include <LGE/GPUMemory.h>
 #include <LGE/Log.h>
 #include <LGE/Pipeline.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/Stats.h>
+#include <LGE/UTF8.h>
 #include <LGE/VulkanFunctions.h>
 #include <LGE/Window.h>
 
+#include <math.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <ft2build.h>
+#include <freetype/freetype.h>
+#include <freetype/ftmodapi.h>
+
+#define STB_RECT_PACK_IMPLEMENTATION 1
+#define STBRP_STATIC 1
+#include "../vendor/stb_rect_pack.h"
+
 #include "DebugUIFont.cc"
 
 
@@ -25,6 +41,14 @@ namespace LGE {
 #include "debugui.frag.txt"
 #include "debugui.vert.txt"
 
+/**
+ * The font atlas. The glyphs baked by generate_font occupy the top left
+ * corner. Glyphs for other code points are rasterized with FreeType when
+ * they are first used, and packed into the rest of the atlas.
+ */
+static constexpr uint32_t ATLAS_SIZE = (DebugUIFont::font_bitmap_size <= 512)
+	? 1024 : 2 * DebugUIFont::font_bitmap_size;
+
 static GPUImage font_image;
 static VkImageView font_image_view;
 
@@ -32,6 +56,111 @@ static VkSampler sampler;
 static DescriptorSetLayout set_layout;
 static VkDescriptorSet descriptor_set;
 
+/**
+ * Every glyph is drawn as one instance. The vertex shader expands it into a
+ * quad using the glyph's entry in the glyph rect buffer. The low 16 bits of
+ * glyph are the glyph index, and bits 16 to 30 are the text scale in units
+ * of 1/256.
+ *
+ * Shapes are instances with SHAPE_BIT set in glyph. The remaining bits hold
+ * two 15-bit sizes in units of 1/SHAPE_UNIT pixels: the width and height of
+ * a rect, or the signed extent of a line when SHAPE_LINE_BIT is set. Shapes
+ * sample the white texel of the atlas through glyph rect SHAPE_GLYPH.
+ */
+struct DebugUIGlyphInstance {
+	float x, y;
+	uint32_t glyph;
+	uint32_t color;
+};
+
+/**
+ * At scale 1, text is drawn with a 12 pixel em size, independently of the
+ * size that the distance field font was generated at.
+ */
+static constexpr float BASE_PIXEL_SIZE = 12.0f;
+static constexpr float BASE_SCALE = BASE_PIXEL_SIZE / DebugUIFont::font_pixel_size;
+
+/** Text scale in units of 1/256. */
+static uint32_t text_scale = 256;
+
+static float
+scale_factor (uint32_t scale)
+{
+	return BASE_SCALE * (float) scale * (1.0f / 256.0f);
+}
+
+static_assert (sizeof (DebugUIGlyphInstance) == 16);
+
+static constexpr uint32_t SHAPE_BIT = 0x80000000u;
+static constexpr uint32_t SHAPE_LINE_BIT = 0x40000000u;
+static constexpr float SHAPE_UNIT = 4.0f;
+static constexpr float MAX_RECT_SIZE = 32767.0f / SHAPE_UNIT;
+static constexpr float MAX_LINE_EXTENT = 16383.0f / SHAPE_UNIT;
+
+/** The NUL character has no glyph, so its rect points at the white texel. */
+static constexpr uint32_t SHAPE_GLYPH = 0;
+
+/**
+ * Glyph rect buffer entry. Offset and size are in atlas pixels, relative to
+ * the pen position at the top of the line. The atlas rect is in normalized
+ * texture coordinates.
+ */
+struct DebugUIGlyphRect {
+	float xoffset, yoffset;
+	float width, height;
+	float u, v;
+	float uwidth, vheight;
+};
+
+/**
+ * Glyph indices below NUM_BAKED_GLYPHS are the baked glyphs, indexed by
+ * character. Rasterized glyphs are appended after them. The glyph index in
+ * an instance is 16 bits wide, but MAX_GLYPHS is well below that, as the
+ * atlas fills up long before.
+ */
+static constexpr uint32_t NUM_BAKED_GLYPHS = DebugUIFont::MAX_CHARSET;
+static constexpr uint32_t MAX_GLYPHS = 4096;
+static constexpr uint32_t MISSING_GLYPH = '?';
+
+static_assert (MAX_GLYPHS <= 0x10000);
+
+/** Layout information for a glyph. */
+struct GlyphInfo {
+	int advance;
+	bool visible;
+};
+
+static std::vector<GlyphInfo> glyph_info;
+static std::unordered_map<uint32_t, uint32_t> glyph_map;
+
+/**
+ * The glyph rect buffer is persistently mapped. Frames in flight only read
+ * the rects of glyphs that already exist, so new rects are written in place.
+ */
+static GPUBuffer glyph_rect_buffer;
+static DebugUIGlyphRect *glyph_rects;
+
+/**
+ * Rasterized glyphs that have not been copied to the atlas yet. Glyphs are
+ * rasterized while text is laid out, and uploaded together by
+ * DebugUIUploadGlyphs, before the render pass of the next frame begins.
+ */
+static std::vector<uint8_t> pending_pixels;
+static std::vector<VkBufferImageCopy> pending_copies;
+static uint32_t first_pending_glyph = NUM_BAKED_GLYPHS;
+
+/** FreeType state for rasterizing glyphs. The font is opened on first use. */
+static FT_Library ft_library;
+static FT_Face ft_face;
+static bool ft_failed = false;
+
+/** Glyph used for code points that the font does not have, or 0. */
+static uint32_t notdef_glyph = 0;
+
+static stbrp_context atlas_packer;
+static stbrp_node atlas_nodes[ATLAS_SIZE];
+static bool atlas_full = false;
+
 class DebugUIPipeline : public Pipeline {
 public:
 	VkPipelineLayout m_layout;
@@ -43,20 +172,31 @@ public:
 			GetVkDescriptorSetLayout (set_layout)
 		};
 
+		VkPushConstantRange push_constant_range {};
+		push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		push_constant_range.offset = 0;
+		push_constant_range.size = 4 * sizeof (float);
+
 		VkPipelineLayoutCreateInfo layout_ci {};
 		layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		layout_ci.setLayoutCount = 1;
 		layout_ci.pSetLayouts = layouts;
+		layout_ci.pushConstantRangeCount = 1;
+		layout_ci.pPushConstantRanges = &push_constant_range;
 
 		VkResult result = vkCreatePipelineLayout (gVkDevice,
 			&layout_ci, nullptr, &m_layout);
 
 		if (result != VK_SUCCESS)
 			throw std::runtime_error (std::string ("vkCreatePipelineLayout returned ") + VulkanTypeToString (result));
+
+		ShaderReloadWatch (debugui_vert, "LGE/debugui.vert");
+		ShaderReloadWatch (debugui_frag, "LGE/debugui.frag");
 	}
 
 	~DebugUIPipeline (void)
 	{
+		ShaderReloadForget (this);
 		vkDestroyPipelineLayout (gVkDevice, m_layout, nullptr);
 	}
 
@@ -65,22 +205,22 @@ public:
 	{
 		VkVertexInputBindingDescription vertex_input_bindings[1] {};
 		vertex_input_bindings[0].binding = 0;
-		vertex_input_bindings[0].stride = 8 * sizeof (float);
-		vertex_input_bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		vertex_input_bindings[0].stride = sizeof (DebugUIGlyphInstance);
+		vertex_input_bindings[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
 		VkVertexInputAttributeDescription vertex_input_attributes[3] {};
 		vertex_input_attributes[0].location = 0;
 		vertex_input_attributes[0].binding = 0;
 		vertex_input_attributes[0].format = VK_FORMAT_R32G32_SFLOAT;
-		vertex_input_attributes[0].offset = 0;
+		vertex_input_attributes[0].offset = offsetof (DebugUIGlyphInstance, x);
 		vertex_input_attributes[1].location = 1;
 		vertex_input_attributes[1].binding = 0;
-		vertex_input_attributes[1].format = VK_FORMAT_R32G32_SFLOAT;
-		vertex_input_attributes[1].offset = 2 * sizeof (float);
+		vertex_input_attributes[1].format = VK_FORMAT_R32_UINT;
+		vertex_input_attributes[1].offset = offsetof (DebugUIGlyphInstance, glyph);
 		vertex_input_attributes[2].location = 2;
 		vertex_input_attributes[2].binding = 0;
-		vertex_input_attributes[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-		vertex_input_attributes[2].offset = 4 * sizeof (float);
+		vertex_input_attributes[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+		vertex_input_attributes[2].offset = offsetof (DebugUIGlyphInstance, color);
 
 		VkPipelineVertexInputStateCreateInfo vertex_input_state {};
 		vertex_input_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -91,7 +231,7 @@ public:
 
 		VkPipelineInputAssemblyStateCreateInfo input_assembly_state {};
 		input_assembly_state.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-		input_assembly_state.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		input_assembly_state.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
 
 		VkPipelineViewportStateCreateInfo viewport_state {};
 		viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
@@ -178,12 +318,12 @@ DebugUIInit (void)
 {
 	VkSamplerCreateInfo sampler_ci {};
 	sampler_ci.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-	sampler_ci.magFilter = VK_FILTER_NEAREST;
-	sampler_ci.minFilter = VK_FILTER_NEAREST;
+	sampler_ci.magFilter = VK_FILTER_LINEAR;
+	sampler_ci.minFilter = VK_FILTER_LINEAR;
 	sampler_ci.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-	sampler_ci.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-	sampler_ci.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-	sampler_ci.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	sampler_ci.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_ci.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_ci.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
 	sampler_ci.mipLodBias = 0.0f;
 	sampler_ci.anisotropyEnable = VK_FALSE;
 	sampler_ci.compareEnable = VK_FALSE;
@@ -194,43 +334,102 @@ DebugUIInit (void)
 	sampler_ci.unnormalizedCoordinates = VK_FALSE;
 	sampler = GetSampler (&sampler_ci);
 
-	VkDescriptorSetLayoutBinding bindings[1] {};
+	VkDescriptorSetLayoutBinding bindings[2] {};
 	bindings[0].binding = 0;
 	bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	bindings[0].descriptorCount = 1;
 	bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[1].descriptorCount = 1;
+	bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
 	VkDescriptorSetLayoutCreateInfo set_layout_ci {};
 	set_layout_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	set_layout_ci.bindingCount = 1;
+	set_layout_ci.bindingCount = 2;
 	set_layout_ci.pBindings = bindings;
 	set_layout = GetDescriptorSetLayout (&set_layout_ci);
 
-	VkExtent2D extent = {
-		DebugUIFont::font_bitmap_size,
-		DebugUIFont::font_bitmap_size
-	};
+	void *mapped;
+	glyph_rect_buffer = MMCreateMappedGPUBuffer (MAX_GLYPHS * sizeof (DebugUIGlyphRect),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, &mapped);
+	glyph_rects = (DebugUIGlyphRect *) mapped;
+
+	float uvscale = 1.0f / (float) ATLAS_SIZE;
+	glyph_info.resize (NUM_BAKED_GLYPHS);
+	for (uint32_t i = 0; i < NUM_BAKED_GLYPHS; i++) {
+		const DebugUIFont::glyph &glyph = DebugUIFont::glyphs[i];
+		glyph_info[i].advance = glyph.exists ? glyph.advance : 0;
+		glyph_info[i].visible = glyph.width && glyph.height;
+
+		DebugUIGlyphRect &rect = glyph_rects[i];
+		rect.xoffset = (float) glyph.xoffset;
+		rect.yoffset = (float) (DebugUIFont::font_ascender - glyph.yoffset);
+		rect.width = (float) glyph.width;
+		rect.height = (float) glyph.height;
+		rect.u = uvscale * glyph.atlas_xoffset;
+		rect.v = uvscale * glyph.atlas_yoffset;
+		rect.uwidth = uvscale * glyph.width;
+		rect.vheight = uvscale * glyph.height;
+	}
+
+	// Reserve the area of the baked glyphs, so that rasterized glyphs are
+	// packed around it.
+	stbrp_init_target (&atlas_packer, ATLAS_SIZE, ATLAS_SIZE, atlas_nodes, ATLAS_SIZE);
+	stbrp_rect baked {};
+	baked.w = DebugUIFont::font_bitmap_size;
+	baked.h = DebugUIFont::font_bitmap_size;
+	stbrp_pack_rects (&atlas_packer, &baked, 1);
+	atlas_full = false;
+
+	stbrp_rect white {};
+	white.w = 4;
+	white.h = 4;
+	stbrp_pack_rects (&atlas_packer, &white, 1);
+
+	// Sample the middle of the white block, so that filtering only sees
+	// white texels.
+	DebugUIGlyphRect &shape_rect = glyph_rects[SHAPE_GLYPH];
+	shape_rect = {};
+	shape_rect.u = uvscale * (white.x + 2);
+	shape_rect.v = uvscale * (white.y + 2);
+
+	MMFlushMappedGPUBuffer (glyph_rect_buffer, 0, NUM_BAKED_GLYPHS * sizeof (DebugUIGlyphRect));
+	first_pending_glyph = NUM_BAKED_GLYPHS;
+
+	VkExtent2D extent = { ATLAS_SIZE, ATLAS_SIZE };
+
+	try {
+		std::vector<uint8_t> atlas ((size_t) ATLAS_SIZE * ATLAS_SIZE);
+		for (size_t y = 0; y < DebugUIFont::font_bitmap_size; y++)
+			::memcpy (&atlas[y * ATLAS_SIZE],
+				&DebugUIFont::font_bitmap[y * DebugUIFont::font_bitmap_size],
+				DebugUIFont::font_bitmap_size);
 
-	font_image = MMUploadTexture2D (VK_FORMAT_R8_UNORM, extent,
-		DebugUIFont::font_bitmap);
-
-	VkImageViewCreateInfo view_ci {};
-	view_ci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-	view_ci.image = font_image.m_image;
-	view_ci.viewType = VK_IMAGE_VIEW_TYPE_2D;
-	view_ci.format = VK_FORMAT_R8_UNORM;
-	view_ci.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	view_ci.subresourceRange.levelCount = 1;
-	view_ci.subresourceRange.layerCount = 1;
-	VkResult result = ::vkCreateImageView (gVkDevice, &view_ci, nullptr, &font_image_view);
-	if (result != VK_SUCCESS)
-		throw std::runtime_error (std::string ("vkCreateImageView returned ") + VulkanTypeToString (result));
+		// The distance field is 255 far inside a glyph.
+		for (int y = 0; y < white.h; y++)
+			::memset (&atlas[(size_t) (white.y + y) * ATLAS_SIZE + white.x], 255, white.w);
+
+		font_image = MMUploadTexture2D (VK_FORMAT_R8_UNORM, extent, atlas.data ());
+	} catch (...) {
+		MMDestroyGPUBuffer (glyph_rect_buffer);
+		throw;
+	}
+
+	try {
+		font_image_view = MMCreateImageView (font_image);
+	} catch (...) {
+		MMDestroyGPUImage (font_image);
+		MMDestroyGPUBuffer (glyph_rect_buffer);
+		throw;
+	}
 
 	try {
 		descriptor_set = CreateDescriptorSet (set_layout);
 	} catch (...) {
 		::vkDestroyImageView (gVkDevice, font_image_view, nullptr);
 		MMDestroyGPUImage (font_image);
+		MMDestroyGPUBuffer (glyph_rect_buffer);
 		throw;
 	}
 
@@ -239,23 +438,121 @@ DebugUIInit (void)
 	im.imageView = font_image_view;
 	im.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-	VkWriteDescriptorSet wr {};
-	wr.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	wr.dstSet = descriptor_set;
-	wr.descriptorCount = 1;
-	wr.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	wr.pImageInfo = &im;
-
-	vkUpdateDescriptorSets (gVkDevice, 1, &wr, 0, nullptr);
+	VkDescriptorBufferInfo bi {};
+	bi.buffer = glyph_rect_buffer.m_buffer;
+	bi.offset = 0;
+	bi.range = VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet wr[2] {};
+	wr[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	wr[0].dstSet = descriptor_set;
+	wr[0].dstBinding = 0;
+	wr[0].descriptorCount = 1;
+	wr[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	wr[0].pImageInfo = &im;
+	wr[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	wr[1].dstSet = descriptor_set;
+	wr[1].dstBinding = 1;
+	wr[1].descriptorCount = 1;
+	wr[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	wr[1].pBufferInfo = &bi;
+
+	vkUpdateDescriptorSets (gVkDevice, 2, wr, 0, nullptr);
 }
 
-struct DebugUIVertex {
-	float x, y;
-	float u, v;
-	float r, g, b, a;
+/**
+ * Glyph instances are written directly into a persistently mapped buffer.
+ * There is one buffer per frame in flight, and a buffer is only written to
+ * once the frame that last used it has completed rendering.
+ */
+struct InstanceBuffer {
+	GPUBuffer m_buffer;
+	DebugUIGlyphInstance *m_data = nullptr;
+	size_t m_capacity = 0;
+};
+
+static constexpr size_t MIN_INSTANCE_CAPACITY = 4096;
+
+static InstanceBuffer instance_buffers[CPU_RENDER_AHEAD];
+static size_t instance_buffer_index = 0;
+
+/** Number of instances written to the current buffer. */
+static size_t num_instances = 0;
+
+/** Number of instances in the current buffer that have already been drawn. */
+static size_t num_drawn = 0;
+
+/**
+ * Retained text. The glyph instances of a text are only regenerated when it
+ * changes, or when the swapchain is resized and the text is not positioned
+ * relative to the top left corner.
+ */
+struct DebugUIText_T {
+	std::string m_text;
+	int m_x = 0, m_y = 0;
+	DebugUICorner m_corner = DebugUICorner::TOP_LEFT;
+	uint32_t m_scale = 256;
+	uint32_t m_color = 0;
+
+	std::vector<DebugUIGlyphInstance> m_instances;
+	bool m_dirty = false;
 };
 
-static std::vector<DebugUIVertex> vertices;
+static std::vector<DebugUIText> retained_texts;
+
+/**
+ * The glyph instances of all retained texts. This is rebuilt when any text
+ * changes, which bumps retained_generation. Every frame in flight has its own
+ * copy in GPU memory, which is refreshed when its generation is out of date.
+ */
+static std::vector<DebugUIGlyphInstance> retained_instances;
+static bool retained_dirty = false;
+static uint64_t retained_generation = 1;
+static VkExtent2D retained_extent = { 0, 0 };
+
+static InstanceBuffer retained_buffers[CPU_RENDER_AHEAD];
+static uint64_t retained_buffer_generations[CPU_RENDER_AHEAD] = { 0 };
+
+/** Whether retained text has been drawn in the current frame. */
+static bool retained_drawn = false;
+
+/**
+ * Make sure the instance buffer has room for count more instances after the
+ * first used ones, which are copied to the new buffer. The old buffer might
+ * be in use by the current frame, so it is released, not destroyed.
+ */
+static void
+reserve_instances (InstanceBuffer &ib, size_t used, size_t count)
+{
+	if (used + count <= ib.m_capacity)
+		return;
+
+	size_t capacity = ib.m_capacity ? ib.m_capacity : MIN_INSTANCE_CAPACITY;
+	while (capacity < used + count)
+		capacity *= 2;
+
+	void *mapped;
+	GPUBuffer buffer = MMCreateMappedGPUBuffer (capacity * sizeof (DebugUIGlyphInstance),
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, &mapped);
+
+	if (ib.m_buffer) {
+		::memcpy (mapped, ib.m_data, used * sizeof (DebugUIGlyphInstance));
+		MMReleaseGPUBuffer (ib.m_buffer);
+	}
+
+	ib.m_buffer = buffer;
+	ib.m_data = (DebugUIGlyphInstance *) mapped;
+	ib.m_capacity = capacity;
+}
+
+static void
+destroy_instance_buffer (InstanceBuffer &ib)
+{
+	if (ib.m_buffer)
+		MMDestroyGPUBuffer (ib.m_buffer);
+	ib.m_data = nullptr;
+	ib.m_capacity = 0;
+}
 
 void
 DebugUITerminate (void)
@@ -265,30 +562,343 @@ DebugUITerminate (void)
 		pipeline = nullptr;
 	}
 
+	for (size_t i = 0; i < CPU_RENDER_AHEAD; i++) {
+		destroy_instance_buffer (instance_buffers[i]);
+		destroy_instance_buffer (retained_buffers[i]);
+		retained_buffer_generations[i] = 0;
+	}
+
+	num_instances = 0;
+	num_drawn = 0;
+
 	::vkDestroyImageView (gVkDevice, font_image_view, nullptr);
 	MMDestroyGPUImage (font_image);
+	MMDestroyGPUBuffer (glyph_rect_buffer);
+	glyph_rects = nullptr;
+
+	// Rasterized glyphs are lost with the atlas. Retained text refers to
+	// them by index, so it is laid out again after DebugUIInit.
+	glyph_info.clear ();
+	glyph_map.clear ();
+	pending_pixels.clear ();
+	pending_copies.clear ();
+	notdef_glyph = 0;
+
+	for (DebugUIText text : retained_texts)
+		text->m_dirty = true;
+	retained_dirty = true;
+
+	if (ft_face) {
+		FT_Done_Face (ft_face);
+		ft_face = nullptr;
+	}
 
-	vertices.clear ();
+	if (ft_library) {
+		FT_Done_FreeType (ft_library);
+		ft_library = nullptr;
+	}
+
+	ft_failed = false;
+}
+
+void
+DebugUINextFrame (void)
+{
+	const DebugUIGlyphInstance *pending = instance_buffers[instance_buffer_index].m_data + num_drawn;
+	size_t num_pending = num_instances - num_drawn;
+
+	instance_buffer_index++;
+	if (instance_buffer_index >= CPU_RENDER_AHEAD)
+		instance_buffer_index = 0;
+
+	num_instances = 0;
+	num_drawn = 0;
+	retained_drawn = false;
+
+	// Glyphs that were added after the last DebugUIDraw belong to the new
+	// frame.
+	if (num_pending) {
+		InstanceBuffer &ib = instance_buffers[instance_buffer_index];
+		reserve_instances (ib, 0, num_pending);
+		::memcpy (ib.m_data, pending, num_pending * sizeof (DebugUIGlyphInstance));
+		num_instances = num_pending;
+	}
+}
+
+static uint32_t
+pack_color (float r, float g, float b, float a)
+{
+	auto to_unorm8 = [](float v) -> uint32_t {
+		v = (v < 0.0f) ? 0.0f : (v > 1.0f) ? 1.0f : v;
+		return (uint32_t) (v * 255.0f + 0.5f);
+	};
+
+	return to_unorm8 (r) | (to_unorm8 (g) << 8) | (to_unorm8 (b) << 16) | (to_unorm8 (a) << 24);
+}
+
+void
+DebugUISetScale (float scale)
+{
+	if (scale < 1.0f / 256.0f)
+		scale = 1.0f / 256.0f;
+	else if (scale > 127.0f)
+		scale = 127.0f;
+
+	text_scale = (uint32_t) (scale * 256.0f + 0.5f);
+}
+
+float
+DebugUIGetScale (void)
+{
+	return (float) text_scale * (1.0f / 256.0f);
+}
+
+static int
+line_height (uint32_t scale)
+{
+	return (int) ::ceilf (DebugUIFont::font_line_height * scale_factor (scale));
 }
 
+int
+DebugUIGetLineHeight (void)
+{
+	return line_height (text_scale);
+}
+
+static bool
+open_font (void)
+{
+	if (ft_face)
+		return true;
+	if (ft_failed)
+		return false;
+
+	FT_Error e = FT_Init_FreeType (&ft_library);
+	if (e != FT_Err_Ok) {
+		LGE_LOG_WARNING ("FT_Init_FreeType returned %d", (int) e);
+		ft_library = nullptr;
+		ft_failed = true;
+		return false;
+	}
+
+	FT_Int spread = DebugUIFont::font_sdf_spread;
+	e = FT_Property_Set (ft_library, "sdf", "spread", &spread);
+	if (e == FT_Err_Ok)
+		e = FT_New_Memory_Face (ft_library, DebugUIFont::font_data,
+			DebugUIFont::font_data_size, 0, &ft_face);
+	if (e == FT_Err_Ok)
+		e = FT_Set_Pixel_Sizes (ft_face, 0, DebugUIFont::font_pixel_size);
+
+	if (e != FT_Err_Ok) {
+		LGE_LOG_WARNING ("cannot open %s (FreeType error %d), only ASCII text is available",
+			DebugUIFont::font_name, (int) e);
+		if (ft_face) {
+			FT_Done_Face (ft_face);
+			ft_face = nullptr;
+		}
+
+		FT_Done_FreeType (ft_library);
+		ft_library = nullptr;
+		ft_failed = true;
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Rasterize a glyph of the font, and queue it for upload to the atlas.
+ *
+ * @return the new glyph index, or MISSING_GLYPH on failure.
+ */
+static uint32_t
+rasterize_glyph (FT_UInt index, uint32_t codepoint)
+{
+	if (glyph_info.size () >= MAX_GLYPHS || atlas_full)
+		return MISSING_GLYPH;
+
+	FT_Error e = FT_Load_Glyph (ft_face, index, FT_LOAD_DEFAULT);
+	if (e == FT_Err_Ok)
+		e = FT_Render_Glyph (ft_face->glyph, FT_RENDER_MODE_SDF);
+
+	if (e != FT_Err_Ok) {
+		LGE_LOG_WARNING ("cannot rasterize U+%04X (FreeType error %d)", codepoint, (int) e);
+		return MISSING_GLYPH;
+	}
+
+	FT_GlyphSlot slot = ft_face->glyph;
+	uint32_t width = slot->bitmap.width, height = slot->bitmap.rows;
+
+	GlyphInfo info;
+	info.advance = slot->advance.x / 64;
+	info.visible = width && height;
+
+	uint32_t glyph = glyph_info.size ();
+	if (info.visible) {
+		// Leave an empty border, like generate_font does.
+		stbrp_rect r {};
+		r.w = width + 1;
+		r.h = height + 1;
+		stbrp_pack_rects (&atlas_packer, &r, 1);
+		if (!r.was_packed) {
+			LGE_LOG_WARNING ("the DebugUI font atlas is full");
+			atlas_full = true;
+			return MISSING_GLYPH;
+		}
+
+		// Keep buffer offsets 4-byte aligned.
+		size_t offset = (pending_pixels.size () + 3) & ~(size_t) 3;
+		pending_pixels.resize (offset + (size_t) width * height);
+		for (uint32_t y = 0; y < height; y++)
+			::memcpy (&pending_pixels[offset + y * width],
+				&slot->bitmap.buffer[(ptrdiff_t) y * slot->bitmap.pitch], width);
+
+		VkBufferImageCopy copy {};
+		copy.bufferOffset = offset;
+		copy.bufferRowLength = width;
+		copy.bufferImageHeight = height;
+		copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.imageSubresource.layerCount = 1;
+		copy.imageOffset.x = r.x + 1;
+		copy.imageOffset.y = r.y + 1;
+		copy.imageExtent.width = width;
+		copy.imageExtent.height = height;
+		copy.imageExtent.depth = 1;
+		pending_copies.push_back (copy);
+
+		float uvscale = 1.0f / (float) ATLAS_SIZE;
+		DebugUIGlyphRect &rect = glyph_rects[glyph];
+		rect.xoffset = (float) slot->bitmap_left;
+		rect.yoffset = (float) (DebugUIFont::font_ascender - slot->bitmap_top);
+		rect.width = (float) width;
+		rect.height = (float) height;
+		rect.u = uvscale * (r.x + 1);
+		rect.v = uvscale * (r.y + 1);
+		rect.uwidth = uvscale * width;
+		rect.vheight = uvscale * height;
+	}
+
+	glyph_info.push_back (info);
+	return glyph;
+}
+
+/**
+ * Get the glyph index for a code point, rasterizing the glyph if it is not
+ * in the atlas yet.
+ */
+static uint32_t
+lookup_glyph (uint32_t codepoint)
+{
+	if (codepoint < 128)
+		return codepoint;
+
+	auto it = glyph_map.find (codepoint);
+	if (it != glyph_map.end ())
+		return it->second;
+
+	uint32_t glyph = MISSING_GLYPH;
+	if (open_font ()) {
+		FT_UInt index = FT_Get_Char_Index (ft_face, codepoint);
+		if (index) {
+			glyph = rasterize_glyph (index, codepoint);
+		} else {
+			if (!notdef_glyph)
+				notdef_glyph = rasterize_glyph (0, codepoint);
+			glyph = notdef_glyph;
+		}
+	}
+
+	glyph_map.emplace (codepoint, glyph);
+	return glyph;
+}
+
+/** Make the rects of glyphs rasterized since the last call visible to the GPU. */
 static void
-measure_text (const char *text, int &width, int &height)
+flush_glyph_rects (void)
 {
-	width = 0;
-	height = 12;
-	for (; *text; text++) {
-		DebugUIFont::glyph glyph = DebugUIFont::glyphs[*text];
-		if (!glyph.exists)
-			continue;
+	uint32_t num_glyphs = glyph_info.size ();
+	if (first_pending_glyph != num_glyphs) {
+		MMFlushMappedGPUBuffer (glyph_rect_buffer,
+			first_pending_glyph * sizeof (DebugUIGlyphRect),
+			(num_glyphs - first_pending_glyph) * sizeof (DebugUIGlyphRect));
+		first_pending_glyph = num_glyphs;
+	}
+}
 
-		width += glyph.advance;
+static void
+measure_text (const char *text, uint32_t scale, int &width, int &height)
+{
+	int advance = 0;
+	while (*text)
+		advance += glyph_info[lookup_glyph (UTF8Decode (text))].advance;
+
+	width = (int) ::ceilf (advance * scale_factor (scale));
+	height = line_height (scale);
+}
+
+/**
+ * Convert the position of a box relative to a corner into a position of its
+ * top left corner relative to the top left corner of the screen.
+ */
+static void
+place_box (DebugUICorner corner, int width, int height, int &x, int &y)
+{
+	switch (corner) {
+	case DebugUICorner::TOP_RIGHT:
+		x = gWindow->GetSwapchainExtent ().width - x - width;
+		break;
+	case DebugUICorner::BOTTOM_LEFT:
+		y = gWindow->GetSwapchainExtent ().height - y - height;
+		break;
+	case DebugUICorner::BOTTOM_RIGHT:
+		x = gWindow->GetSwapchainExtent ().width - x - width;
+		y = gWindow->GetSwapchainExtent ().height - y - height;
+		break;
+	default:;
 	}
 }
 
 /**
- * This is a very limited text drawing function. It currently only handles the
- * intersection of what the font supports and ASCII.
+ * Generate glyph instances for UTF-8 text. This is a very limited text
+ * layout function: there is no kerning, shaping or line breaking.
+ *
+ * @param out receives the instances. Must have room for strlen (text).
+ *
+ * @return the number of instances generated.
  */
+static size_t
+generate_glyphs (const char *text, int x, int y, DebugUICorner corner,
+	uint32_t scale, uint32_t color, DebugUIGlyphInstance *out)
+{
+	if (!*text)
+		return 0;
+
+	if (corner != DebugUICorner::TOP_LEFT) {
+		int width, height;
+		measure_text (text, scale, width, height);
+		place_box (corner, width, height, x, y);
+	}
+
+	size_t count = 0;
+	float factor = scale_factor (scale);
+	float pen = (float) x;
+	while (*text) {
+		uint32_t glyph = lookup_glyph (UTF8Decode (text));
+		const GlyphInfo &info = glyph_info[glyph];
+		if (info.visible) {
+			out[count].x = pen;
+			out[count].y = (float) y;
+			out[count].glyph = glyph | (scale << 16);
+			out[count].color = color;
+			count++;
+		}
+		pen += factor * info.advance;
+	}
+
+	StatAdd (STAT_DEBUGUI_GLYPHS, count);
+	return count;
+}
+
 void
 DebugUIDrawText (const char *text, int x, int y, DebugUICorner corner,
 	float r, float g, float b, float a)
@@ -296,115 +906,419 @@ DebugUIDrawText (const char *text, int x, int y, DebugUICorner corner,
 	if (!*text)
 		return;
 
-	if (corner != DebugUICorner::TOP_LEFT) {
-		int width, height;
-		measure_text (text, width, height);
+	InstanceBuffer &ib = instance_buffers[instance_buffer_index];
+	reserve_instances (ib, num_instances, ::strlen (text));
+	num_instances += generate_glyphs (text, x, y, corner, text_scale,
+		pack_color (r, g, b, a), ib.m_data + num_instances);
+}
 
-		switch (corner) {
-		case DebugUICorner::TOP_RIGHT:
-			x = gWindow->GetSwapchainExtent ().width - x - width;
-			break;
-		case DebugUICorner::BOTTOM_LEFT:
-			y = gWindow->GetSwapchainExtent ().height - y - height;
-			break;
-		case DebugUICorner::BOTTOM_RIGHT:
-			x = gWindow->GetSwapchainExtent ().width - x - width;
-			y = gWindow->GetSwapchainExtent ().height - y - height;
+/** Format text of any length. Short text is formatted on the stack. */
+static std::string
+format_text (const char *fmt, va_list args)
+{
+	char buf[256];
+	va_list copy;
+	va_copy (copy, args);
+	int n = vsnprintf (buf, sizeof (buf), fmt, copy);
+	va_end (copy);
+
+	if (n < 0)
+		return std::string ();
+	if ((size_t) n < sizeof (buf))
+		return std::string (buf, n);
+
+	std::string text (n, '\0');
+	vsnprintf (text.data (), text.size () + 1, fmt, args);
+	return text;
+}
+
+void
+DebugUIPrintf (int x, int y, DebugUICorner corner,
+	float r, float g, float b, float a,
+	const char *fmt, ...)
+{
+	va_list args;
+	va_start (args, fmt);
+	std::string text = format_text (fmt, args);
+	va_end (args);
+
+	DebugUIDrawText (text.c_str (), x, y, corner, r, g, b, a);
+}
+
+/**
+ * Make room for count immediate instances, and return a pointer to them.
+ * They are counted as written right away.
+ */
+static DebugUIGlyphInstance *
+add_instances (size_t count)
+{
+	InstanceBuffer &ib = instance_buffers[instance_buffer_index];
+	reserve_instances (ib, num_instances, count);
+
+	DebugUIGlyphInstance *out = ib.m_data + num_instances;
+	num_instances += count;
+	return out;
+}
+
+static uint32_t
+shape_size (float size, float max)
+{
+	size = (size < 0.0f) ? 0.0f : (size > max) ? max : size;
+	return (uint32_t) (size * SHAPE_UNIT + 0.5f);
+}
+
+static uint32_t
+shape_extent (float extent)
+{
+	int32_t v = (int32_t) ::lroundf (extent * SHAPE_UNIT);
+	return (uint32_t) v & 0x7fffu;
+}
+
+static void
+make_rect (DebugUIGlyphInstance &out, float x, float y, float width, float height,
+	uint32_t color)
+{
+	out.x = x;
+	out.y = y;
+	out.glyph = SHAPE_BIT | shape_size (width, MAX_RECT_SIZE)
+		| (shape_size (height, MAX_RECT_SIZE) << 15);
+	out.color = color;
+}
+
+/**
+ * Add a one pixel wide line between two points relative to the top left
+ * corner. Lines that are too long for one instance are split.
+ */
+static void
+add_line (float x0, float y0, float x1, float y1, uint32_t color)
+{
+	float dx = x1 - x0, dy = y1 - y0;
+	float longest = ::fmaxf (::fabsf (dx), ::fabsf (dy));
+	size_t count = (size_t) ::ceilf (longest / MAX_LINE_EXTENT);
+	if (!count)
+		return;
+
+	dx /= (float) count;
+	dy /= (float) count;
+	uint32_t extent = SHAPE_BIT | SHAPE_LINE_BIT
+		| shape_extent (dx) | (shape_extent (dy) << 15);
+
+	DebugUIGlyphInstance *out = add_instances (count);
+	for (size_t i = 0; i < count; i++) {
+		out[i].x = x0 + dx * (float) i;
+		out[i].y = y0 + dy * (float) i;
+		out[i].glyph = extent;
+		out[i].color = color;
+	}
+
+	StatAdd (STAT_DEBUGUI_SHAPES, count);
+}
+
+void
+DebugUIDrawRect (int x, int y, int width, int height, DebugUICorner corner,
+	float r, float g, float b, float a)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	place_box (corner, width, height, x, y);
+	make_rect (*add_instances (1), (float) x, (float) y,
+		(float) width, (float) height, pack_color (r, g, b, a));
+	StatAdd (STAT_DEBUGUI_SHAPES);
+}
+
+void
+DebugUIDrawRectOutline (int x, int y, int width, int height, DebugUICorner corner,
+	float r, float g, float b, float a)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	if (width <= 2 || height <= 2) {
+		DebugUIDrawRect (x, y, width, height, corner, r, g, b, a);
+		return;
+	}
+
+	place_box (corner, width, height, x, y);
+
+	uint32_t color = pack_color (r, g, b, a);
+	float fx = (float) x, fy = (float) y;
+	float fw = (float) width, fh = (float) height;
+	DebugUIGlyphInstance *out = add_instances (4);
+	make_rect (out[0], fx, fy, fw, 1.0f, color);
+	make_rect (out[1], fx, fy + fh - 1.0f, fw, 1.0f, color);
+	make_rect (out[2], fx, fy + 1.0f, 1.0f, fh - 2.0f, color);
+	make_rect (out[3], fx + fw - 1.0f, fy + 1.0f, 1.0f, fh - 2.0f, color);
+	StatAdd (STAT_DEBUGUI_SHAPES, 4);
+}
+
+void
+DebugUIDrawLine (int x0, int y0, int x1, int y1, DebugUICorner corner,
+	float r, float g, float b, float a)
+{
+	place_box (corner, 0, 0, x0, y0);
+	place_box (corner, 0, 0, x1, y1);
+
+	// Pixel centers, so that horizontal and vertical lines cover exactly
+	// one row or column of pixels.
+	add_line ((float) x0 + 0.5f, (float) y0 + 0.5f,
+		(float) x1 + 0.5f, (float) y1 + 0.5f, pack_color (r, g, b, a));
+}
+
+void
+DebugUIDrawGraph (int x, int y, int width, int height, DebugUICorner corner,
+	const float *values, size_t count, size_t first, float min, float max,
+	float r, float g, float b, float a)
+{
+	if (count < 2 || width <= 0 || height <= 0)
+		return;
+
+	place_box (corner, width, height, x, y);
+
+	uint32_t color = pack_color (r, g, b, a);
+	float range = (max > min) ? max - min : 1.0f;
+	float step = (float) (width - 1) / (float) (count - 1);
+
+	auto point_y = [&](size_t i) -> float {
+		float v = (values[(first + i) % count] - min) / range;
+		v = (v < 0.0f) ? 0.0f : (v > 1.0f) ? 1.0f : v;
+		return (float) y + 0.5f + (1.0f - v) * (float) (height - 1);
+	};
+
+	float prev_x = (float) x + 0.5f, prev_y = point_y (0);
+	for (size_t i = 1; i < count; i++) {
+		float next_x = (float) x + 0.5f + step * (float) i, next_y = point_y (i);
+		add_line (prev_x, prev_y, next_x, next_y, color);
+		prev_x = next_x;
+		prev_y = next_y;
+	}
+}
+
+void
+DebugUIDrawStackedBar (int x, int y, int width, int height, DebugUICorner corner,
+	const float *values, const DebugUIColor *colors, size_t count, float max)
+{
+	if (!count || width <= 0 || height <= 0 || max <= 0.0f)
+		return;
+
+	place_box (corner, width, height, x, y);
+
+	DebugUIGlyphInstance *out = add_instances (count);
+	float scale = (float) width / max;
+	float pen = (float) x, end = (float) (x + width);
+	size_t n = 0;
+	for (size_t i = 0; i < count && pen < end; i++) {
+		float w = (values[i] > 0.0f) ? values[i] * scale : 0.0f;
+		if (w > end - pen)
+			w = end - pen;
+		if (w <= 0.0f)
+			continue;
+
+		make_rect (out[n++], pen, (float) y, w, (float) height,
+			pack_color (colors[i].r, colors[i].g, colors[i].b, colors[i].a));
+		pen += w;
+	}
+
+	// Give back the instances of empty segments.
+	num_instances -= count - n;
+	StatAdd (STAT_DEBUGUI_SHAPES, n);
+}
+
+DebugUIText
+DebugUICreateText (void)
+{
+	DebugUIText text = new DebugUIText_T;
+	try {
+		retained_texts.push_back (text);
+	} catch (...) {
+		delete text;
+		throw;
+	}
+
+	return text;
+}
+
+void
+DebugUIDestroyText (DebugUIText text)
+{
+	if (!text)
+		return;
+
+	for (size_t i = 0; i < retained_texts.size (); i++) {
+		if (retained_texts[i] == text) {
+			retained_texts.erase (retained_texts.begin () + i);
 			break;
-		default:;
 		}
 	}
 
-	float xscale = 1.0f / (float) gWindow->GetSwapchainExtent ().width;
-	float yscale = 1.0f / (float) gWindow->GetSwapchainExtent ().height;
-	float uvscale = 1.0f / (float) DebugUIFont::font_bitmap_size;
-
-	float x_ = xscale * x, y_ = yscale * y;
-	do {
-		DebugUIFont::glyph glyph = DebugUIFont::glyphs[*text];
-		if (glyph.width && glyph.height) {
-			DebugUIVertex topleft, topright, bottomleft, bottomright;
-
-			float left = x_ + xscale * glyph.xoffset;
-			float top = y_ + yscale * (12 - glyph.yoffset);
-			float right = left + xscale * glyph.width;
-			float bottom = top + yscale * glyph.height;
-			float uvleft = glyph.atlas_xoffset * uvscale;
-			float uvtop = glyph.atlas_yoffset * uvscale;
-			float uvright = uvleft + uvscale * glyph.width;
-			float uvbottom = uvtop + uvscale * glyph.height;
-
-			topleft.x = left;
-			topleft.y = top;
-			topleft.u = uvleft;
-			topleft.v = uvtop;
-			topleft.r = r;
-			topleft.g = g;
-			topleft.b = b;
-			topleft.a = a;
-			topright.x = right;
-			topright.y = top;
-			topright.u = uvright;
-			topright.v = uvtop;
-			topright.r = r;
-			topright.g = g;
-			topright.b = b;
-			topright.a = a;
-			bottomleft.x = left;
-			bottomleft.y = bottom;
-			bottomleft.u = uvleft;
-			bottomleft.v = uvbottom;
-			bottomleft.r = r;
-			bottomleft.g = g;
-			bottomleft.b = b;
-			bottomleft.a = a;
-			bottomright.x = right;
-			bottomright.y = bottom;
-			bottomright.u = uvright;
-			bottomright.v = uvbottom;
-			bottomright.r = r;
-			bottomright.g = g;
-			bottomright.b = b;
-			bottomright.a = a;
-
-			DebugUIVertex new_verts[6] = {
-				topleft, topright, bottomleft,
-				bottomleft, topright, bottomright
-			};
-
-			vertices.insert (vertices.end (), &new_verts[0], &new_verts[6]);
-		}
-		x_ += xscale * glyph.advance;
-	} while (*(++text));
+	if (!text->m_instances.empty ())
+		retained_dirty = true;
+	delete text;
 }
 
 void
-DebugUIPrintf (int x, int y, DebugUICorner corner,
+DebugUISetText (DebugUIText text, const char *str, int x, int y, DebugUICorner corner,
+	float r, float g, float b, float a)
+{
+	uint32_t color = pack_color (r, g, b, a);
+	if (text->m_x == x && text->m_y == y && text->m_corner == corner
+			&& text->m_scale == text_scale && text->m_color == color
+			&& text->m_text == str)
+		return;
+
+	text->m_text = str;
+	text->m_x = x;
+	text->m_y = y;
+	text->m_corner = corner;
+	text->m_scale = text_scale;
+	text->m_color = color;
+	text->m_dirty = true;
+	retained_dirty = true;
+}
+
+void
+DebugUISetTextPrintf (DebugUIText text, int x, int y, DebugUICorner corner,
 	float r, float g, float b, float a,
 	const char *fmt, ...)
 {
-	char buf[128];
 	va_list args;
 	va_start (args, fmt);
-	vsnprintf (buf, sizeof (buf), fmt, args);
+	std::string str = format_text (fmt, args);
 	va_end (args);
 
-	buf[sizeof (buf) - 1] = 0;
-	DebugUIDrawText (buf, x, y, corner, r, g, b, a);
+	DebugUISetText (text, str.c_str (), x, y, corner, r, g, b, a);
+}
+
+/**
+ * Bring the retained glyph instances and the GPU copy for the current frame
+ * up to date.
+ *
+ * @return the instance buffer to draw retained text from.
+ */
+static InstanceBuffer &
+update_retained (void)
+{
+	VkExtent2D extent = gWindow->GetSwapchainExtent ();
+	if (extent.width != retained_extent.width || extent.height != retained_extent.height) {
+		for (DebugUIText text : retained_texts) {
+			if (text->m_corner != DebugUICorner::TOP_LEFT) {
+				text->m_dirty = true;
+				retained_dirty = true;
+			}
+		}
+
+		retained_extent = extent;
+	}
+
+	if (retained_dirty) {
+		retained_instances.clear ();
+		for (DebugUIText text : retained_texts) {
+			if (text->m_dirty) {
+				text->m_instances.resize (text->m_text.size ());
+				size_t count = generate_glyphs (text->m_text.c_str (),
+					text->m_x, text->m_y, text->m_corner, text->m_scale,
+					text->m_color, text->m_instances.data ());
+				text->m_instances.resize (count);
+				text->m_dirty = false;
+			}
+
+			retained_instances.insert (retained_instances.end (),
+				text->m_instances.begin (), text->m_instances.end ());
+		}
+
+		retained_dirty = false;
+		retained_generation++;
+	}
+
+	InstanceBuffer &ib = retained_buffers[instance_buffer_index];
+	uint64_t &generation = retained_buffer_generations[instance_buffer_index];
+	if (generation != retained_generation) {
+		size_t size = retained_instances.size () * sizeof (DebugUIGlyphInstance);
+		reserve_instances (ib, 0, retained_instances.size ());
+		if (size) {
+			::memcpy (ib.m_data, retained_instances.data (), size);
+			MMFlushMappedGPUBuffer (ib.m_buffer, 0, size);
+		}
+
+		generation = retained_generation;
+	}
+
+	return ib;
 }
 
 void
-DebugUIDraw (VkCommandBuffer cmd)
+DebugUIUploadGlyphs (VkCommandBuffer cmd)
 {
-	if (vertices.empty ())
+	// Lay out retained text now, so that its new glyphs are drawn in this
+	// frame. DebugUIDraw lays out text that changes after this again.
+	if (!retained_drawn)
+		update_retained ();
+
+	if (pending_copies.empty ())
 		return;
 
-	size_t vertex_count = vertices.size ();
-	VkBuffer vbuf = MMCreateTemporaryGPUBuffer (
-		vertices.data (), vertex_count * sizeof (DebugUIVertex),
-		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	VkBuffer staging = MMCreateTemporaryGPUBuffer (pending_pixels.data (),
+		pending_pixels.size (), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+	// The atlas is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL between
+	// frames, and previous frames may still sample it. New glyphs go to
+	// regions that no drawn glyph uses, so only an execution dependency is
+	// needed before the copy.
+	VkImageMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = font_image.m_image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	vkCmdCopyBufferToImage (cmd, staging, font_image.m_image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		pending_copies.size (), pending_copies.data ());
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	pending_pixels.clear ();
+	pending_copies.clear ();
+}
+
+void
+DebugUIDraw (VkCommandBuffer cmd)
+{
+	InstanceBuffer *retained = nullptr;
+	if (!retained_drawn) {
+		retained_drawn = true;
+		InstanceBuffer &ib = update_retained ();
+		if (!retained_instances.empty ())
+			retained = &ib;
+	}
+
+	if (!retained && num_instances == num_drawn)
+		return;
 
-	vertices.clear ();
+	flush_glyph_rects ();
 
 	if (!pipeline)
 		pipeline = new DebugUIPipeline;
@@ -427,9 +1341,29 @@ DebugUIDraw (VkCommandBuffer cmd)
 	vkCmdBindDescriptorSets (cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
 		pipeline->m_layout, 0, 1, &descriptor_set, 0, nullptr);
 
+	float push_constants[4] = {
+		1.0f / viewport.width, 1.0f / viewport.height,
+		BASE_SCALE / 256.0f, 0.0f
+	};
+
+	vkCmdPushConstants (cmd, pipeline->m_layout, VK_SHADER_STAGE_VERTEX_BIT,
+		0, sizeof (push_constants), push_constants);
+
 	VkDeviceSize offsets[1] = { 0 };
-	vkCmdBindVertexBuffers (cmd, 0, 1, &vbuf, offsets);
-	vkCmdDraw (cmd, vertex_count, 1, 0, 0);
+	if (retained) {
+		vkCmdBindVertexBuffers (cmd, 0, 1, &retained->m_buffer.m_buffer, offsets);
+		vkCmdDraw (cmd, 4, retained_instances.size (), 0, 0);
+	}
+
+	if (num_instances != num_drawn) {
+		InstanceBuffer &ib = instance_buffers[instance_buffer_index];
+		MMFlushMappedGPUBuffer (ib.m_buffer, num_drawn * sizeof (DebugUIGlyphInstance),
+			(num_instances - num_drawn) * sizeof (DebugUIGlyphInstance));
+
+		vkCmdBindVertexBuffers (cmd, 0, 1, &ib.m_buffer.m_buffer, offsets);
+		vkCmdDraw (cmd, 4, num_instances - num_drawn, 0, num_drawn);
+		num_drawn = num_instances;
+	}
 }
 
 }
@@ -1,990 +0,0 @@
-/**
- * Font data for /usr/share/fonts/noto/NotoSans-Regular.ttf, generated by scripts/generate_font.
- * Copyright (C) 2024  dbstream
- *
- * /usr/share/fonts/noto/NotoSans-Regular.ttf is Copyright (C) its authors
- */
-#include <stdint.h>
-#include <stddef.h>
-
-namespace LGE::DebugUIFont {
-
-static constexpr size_t font_bitmap_size = 128;
-static const uint8_t font_bitmap[font_bitmap_size * font_bitmap_size] = {
-  0,  2,198, 14, 32,192,  0,  0,228, 48,  0,  0,102,211,239,230,150, 14,  0,  0,  0,  0,196,  0,  0,  0,  0,  0,114,227, 40,143,200, 41,  0,  0,  0, 32,216, 11, 89,174,  0,  0, 12,255,236,151,165,236,252,  0,  0, 11,125,214,237,232,173, 46,  0,  0,  0,  0,  0,  0,  0,180, 92,  0, 52,208,238,167,150, 92,  0, 54,207,239,165,149, 92,205, 80,  0,  0, 47,236,  5,252, 20,  0,  0,  0,  0,252, 20,  0,  0,  0,  0,252, 16,  0,  0,  0,  0,239, 90,227,231,127,  0,  0, 26,198,236,117,  2,198, 14,252, 20,  0,  2,255, 57,
-  0,  0,  0,  0, 32,192,  0,  0,228, 48,  0,113,221, 53,  2, 19,156,196,  2,  0, 89,199,246,200,126,  0,  0, 27,242, 26,  0,  0,127,171,  0,  0,  0,167,104,  0,  0,207, 64,  0, 12,252,  0,  0,  0, 12,252,  0, 15,205,136, 28,  0,  4, 77,216, 57,  0,  0,  0,  0,  0,  0,180, 92,  4,225, 90,  0, 68,251, 92,  6,227, 93,  0, 71,252, 92,109,170,  0,  0,131,151,  0,252, 20,  0,  0,  0,  0,252, 20,  0,  0,  0,  0,252, 16,  0,  0,  0,  0,252,150,  4, 28,224, 77,  0,136,148,  0,  6,  0,  0,  0,252, 20,  0,  0,245, 44,
-  0,  0,  0,  0, 32,192,  0,  0,228, 48,  4,238, 70,  0,  0,  0,  3,224, 75, 29,236, 59,200, 47, 74,  0,  0, 52,216,  0,  0,  0, 72,196,  0,  0, 17,242, 14,  0,  0,110,164,  0, 12,252,  0,  0,  0, 12,252,  0,153,110, 22,183,235,227, 84, 43,196,  0,  0,  0,  0,  0,  0,180, 92, 56,224,  0,  0,  0,200, 92, 57,225,  0,  0,  0,206, 92, 20,240, 13,  0,216, 61,  0,252, 19,  0,  0,  0,  0,252, 20,  0,  0,  0,  0,252, 16,  0,  0,  0,  0,252, 43,  0,  0,128,153,  0,171, 94,  0,  0,  0,  0,  0,252, 20,  0,  0,233, 31,
-  0,  0,252, 20, 32,192,  0,  0,228, 48, 45,250,  2,  0,  0,  0,  0,156,139, 48,224,  5,196,  0,  0,  0,  0, 52,215,  0,  0,  0, 71,196,  0,  0, 76,197,  0,  0,  0, 46,228,  0, 12,252,  0,  0,  0, 12,252, 10,219,  1,164,125,  0,124,105,  0,207,  6,  0, 57,209,238,164,179, 92, 80,198,  0,  0,  0,176, 92, 80,198,  0,  0,  0,180, 92,  0,175, 93, 45,225,  1,  0,252,104,227,231,127,  0,252,107,224,236,153,  1,252, 16,  0,140,174,  2,252, 23,  0,  0,104,176,146,247,243,232,  0,  0,252, 20,252, 20,  0,  0,220, 19,
-  0,  0,252, 20, 32,192,  0,  0,228, 48, 63,231,  0,  0,  0,  0,  0,135,157,  1,176,220,219, 37,  0,  0,  1,117,180,  0,  0,  0, 39,233, 28,  0,113,158,  0,  0,  0,  7,255, 12, 12,252,  0,  0,  0, 12,252, 57,165,  0,223, 20,  0,142, 93,  0,208, 11,  7,228, 93,  0, 68,253, 92, 58,222,  0,  0,  0,194, 92, 59,222,  0,  0,  0,200, 92,  0, 80,180,127,136,  0,  0,252,152,  4, 25,220, 76,252,157,  6, 18,220, 70,252, 16,105,200,  9,  0,252, 48,  0,  0,135,152,  0,176, 92,  0,  0,  0,252, 20,252, 20,  0,  0,207,  6,
-  0,  0,252, 20, 32,192,  0,  0,228, 48, 45,250,  2,  0,  0,  0,  0,157,136,  0,  0, 64,237,235,150,  0,164,228, 41,  0,  0,  0,  0,126,254, 52,127,144,  0,  0,  0,  0,248, 26, 12,252,  0,  0,  0, 12,252, 70,153,  0,197, 70, 17,203,119, 48,203,  0, 58,225,  0,  0,  0,205, 92,  6,228, 88,  0, 60,251, 92,  8,230, 87,  0, 61,252, 92,  0,  5,225,205, 45,  0,  0,252, 45,  0,  0,126,152,252, 46,  0,  0,157,107,252, 84,218, 21,  0,  0,252,160,  5, 26,234, 73,  0,176, 92,  0,  0,  0,252, 20,252, 20,  0,  0,188,  0,
-  0,  0,252, 20, 32,192,  0,  0,228, 48,  3,238, 69,  0,  0,  0,  3,225, 73,  0,  0,  0,196, 14,237, 34,  0,114,184,  0,  0,  0, 40,232, 25,  0,115,157,  0,  0,  0,  6,255, 13, 12,252,  0,  0,  0, 12,252, 44,188,  0, 59,217,215, 50,198,208, 50,  0, 80,198,  0,  0,  0,180, 92,  0, 56,210,239,175,183, 92,  0, 60,211,238,167,182, 92,  0,  0,146,210,  0,  0,  0,252, 25,  0,  0,102,176,252, 22,  0,  0,152,112,252,222,212,  7,  0,  0,252,109,228,229,125,  0,  0,176, 92,  0,  0,  0,252, 20,252, 20,  0,  0,  0,  0,
-  0,  0,252, 20, 32,192,  0,  0,228, 48,  0,113,219, 51,  1, 19,156,197,  3, 29, 62, 14,200, 69,237, 14,  0, 52,215,  0,  0,  0, 71,196,  0,  0, 78,196,  0,  0,  0, 45,232,  0, 12,252,  0,  0,  0, 12,252,  1,219, 42,  0,  0,  0,  0,  0,  0,  0,  0, 59,221,  0,  0,  0,199, 92,  0,  0,  0,  0,  0,191, 74,  0,  0,  0,  0,  0,180, 92,  0,  0,151,119,  0,  0,  0,252, 47,  0,  0,127,152,252, 20,  0,  0,152,112,252, 42,176,142,  0,  0,252, 19,  0,  0,  0,  0,  0,176, 92,  0,  0,  0,252, 20,252, 20,  0, 11,188, 45,
-  0,  0,252, 20, 32,192,  0,  0,228, 48,  0,  0,102,212,241,255,166, 19,  0, 38,202,241,251,197, 68,  0,  0, 51,216,  0,  0,  0, 72,195,  0,  0, 20,243, 13,  0,  0,110,167,  0, 12,252,  0,  0,  0, 12,252,  0, 74,220, 83, 19,  6, 45, 94,  0,  0,  0,  8,230, 85,  0, 61,252, 92,  0, 63,  9,  0, 61,241, 24,  0,  0,  0,  0,  0,180, 92,  0, 44,239, 23,  0,  0,  0,252,158,  5, 25,221, 75,252, 20,  0,  0,152,112,252, 16, 22,232, 66,  0,252, 20,  0,  0,  0,  0,  0,176, 92,  0,  0,  0,252, 20,252, 20,  0, 16,227, 58,
-  0,  0,252, 20, 32,192,  0,  0,234, 39,  0,  0,  0,  0,  0,153,193,  9,  0,  0,  0,  0,196,  0,  0,  0,  0, 26,243, 33,  0,  1,133,167,  0,  0,  0,170,105,  0,  0,207, 66,  0, 12,252,  0,  0,  0, 12,252,  0,  0, 55,173,225,232,202,105,  0,  0,  0,  0, 60,211,238,167,152, 92,  0,155,234,237,214, 81,  0,  0,  0,  0,  0,  0,180, 92,205,230, 86,  0,  0,  0,  0,222,103,230,231,126,  0,252, 20,  0,  0,152,112,252, 16,  0, 80,226, 16,252, 20,  0,  0,  0,  0,  0,176, 92,  0,  0,  0,252, 20,252, 20,  0, 20,230, 54,
-  0,  0,252, 19, 32,192,  3, 53,240,  7,  0,  0,  0,  0,  0,  5,189,179,  5,  0,  0,  0, 94,  0,  0,  0,  0,  0,108,221, 40,141,188, 34,  0,  0,  0, 32,214, 11, 85,172,  0,  0, 11,243,236,151,165,236,240,188, 98,  0,  0, 40,255, 60,  0,  0, 63,223,  2,171,233,102,  0,  0, 92,143,  0,  0,  0, 27,194,241,214, 54,  0,  0,  0,216,235,  5,  0,  0,  0, 17,249,184,  0,  0,102,211,239,230,150, 14,  0,  0,  0, 38,184,  0,142, 69,  0,  0,  0,  0,215,127,  0,  0,  0,  0,  0, 77,199,238,237,192, 16,  0,  0, 13,188, 40,
-  0, 30,250,  4, 32,192,216,217, 79,  0,216,241,238,236,175, 46,  0,  0,  0,  0, 60,182,234,238,218,101,212, 74,  0,  0,  0, 28,247, 15,  0, 52,208,241,191, 27,  0,  7,126,228,237,187, 31,  0,  0,  0,  0,124,161,  0,  0,111,233,134,  0,  0,124,158, 57,180, 15,220,  3,  5,209, 21,  0,  0,  0,129,158,  5,121,169,  0,  0,  0,216,213, 76,  0,  0,  0,104,213,184,  0,113,221, 53,  2, 19,156,198,  2,  0,  0, 97,123,  0,198, 13,  0,  0,  0, 55,210,220,  1,  0,  0,  0, 90,231, 72,  4, 12, 81,  0,  0,  0,  0,  0,  0,
-152,239,125,  0, 32,192,  0,  0,  0,  0,216, 64,  0, 15,112,240, 46,  0,  0, 77,235, 89,  9,  0, 36, 36,125,161,  0,  0,  0,113,176,  0,  2,222, 87,  3,128,172,  0, 20,142, 26,  1,137,176,  0,  0,  0,  0, 59,224,  0,  0,183,122,208,  0,  0,185, 93, 94,126,  0,196, 24,107,129,  0,  0,  0,  0, 88,196, 13,173,111,  0,  0,  0,216,130,168,  0,  0,  0,197,128,184,  4,238, 70,  0,  0,  0,  3,224, 76, 59,236,247,241,237,251,236,103,  0,  0,150,108,196, 61,  0,  0,  2,229, 85,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- 19,149,233,236,194, 40,  0,  0,  0,  0,216, 64,  0,  0,  0,138,177,  0,  1,223, 92,  0,  0,  0,  0,  0, 38,240,  6,  0,  0,198, 89,  0, 52,219,  0,  0, 12,244, 15,  0,  0,  0,  0, 60,219,  0,  0,  0,  0,  5,245, 30,  7,239, 13,232, 27,  3,242, 28, 92,127,  0,197, 34,212,125,229,145,  0,  0,  0,199,245,105,  0,  0,  0,  0,216, 53,237, 13,  0, 34,209, 87,184, 45,250,  2,  0,  0,  0,  0,156,139,  0,  0,190, 22, 50,170,  0,  0,  0,  7,232, 19,102,156,  0,  0, 42,252,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
- 24,118, 17,  0,123,192,  0,  0,  0,  0,216, 64,  0,  0,  0, 61,240,  0, 41,251,  5,  0,  0,  0,  0,  0,  0,207, 77,  0, 29,245, 12,  0, 90,180,  0,  0,  0,221, 47,  0,  0,  0,  0,115,172,  0,  0,  0,  0,  0,186, 93, 69,190,  0,163,100, 52,219,  0, 50,185, 23,221,125,122,219, 15,194, 43,  0,156,241,228,181,  4,  5,243, 24,216, 40,170, 95,  0,127,117, 88,184, 63,231,  0,  0,  0,  0,  0,135,158,  0,  0,214,  0, 96,124,  0,  0,  0, 84,174,  0, 15,233,  9,  0, 62,231,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0, 54,223,  0,  0,  0,  0,216, 64,  0,  0,  0, 37,255,  3, 62,227,  0,  0, 25,236,238,209,  0,120,163,  0,113,171,  0,  0, 99,168,  0,  0,  0,208, 66,  0,  0,  0, 30,231, 39,  0,  0,  0,  0,  0,122,154,139,119,  0, 92,172,112,154,  0,  0,153,226,114,211, 42,187,  0,132, 87, 51,243, 38, 32,222,162, 79,202,  0,216, 40, 79,186,  0,216, 27, 88,184, 45,250,  2,  0,  0,  0,  0,157,139,165,238,250,236,247,241,236,  7,  0,179,245,236,236,252, 90,  0, 44,251,  3,  0,  0,  0,  0,  0,  0,  0, 27,253, 22,
-  0,  0,  0, 25,176,133,  0,  0,  0,  0,216, 64,  0,  0,  0, 65,238,  0, 43,244,  3,  0,  0,  0, 60,216,  0, 33,240,  7,198, 84,  0,  0, 81,180,  0,  0,  0,221, 56,  0,  0, 19,213, 91,  0,  0,  0,  0,  0,  0, 57,208,201, 48,  0, 21,232,171, 89,  0,  0,  0,  0,137,101, 33,186,  0,132, 88, 81,198,  0,  0, 29,219,244, 78,  0,216, 40,  6,234, 82,187,  0, 88,184,  3,238, 69,  0,  0,  0,  3,225, 76,  0, 69,147,  0,182, 37,  0,  0, 22,235, 28, 24, 24, 99,185,  0,  3,236, 78,  0,  0,  0,  0,  0,  0,  0, 77,194,  0,
-  0, 36,238,255,186, 22,  0,  0,  0,  0,216, 64,  0,  0,  0,152,171,  0,  2,233, 73,  0,  0,  0, 60,216,  0,  0,202, 96,242,  9,  0,  0, 44,219,  0,  0, 12,249, 18,  0, 13,202,110,  0,  0,  0,  0,  0,  0,  0,  4,237,221,  1,  0,  0,204,237, 25,  0,  0,  0, 26,208,  4,  6,216, 10,191, 48, 34,243, 53,  0, 43,209,248,110,  0,216, 40,  0,153,237, 94,  0, 88,184,  0,113,219, 51,  1, 19,156,197,  2,  0,107,109,  0,215,  3,  0,  0,113,157,  0,  0,  0,  9,240, 27,  0,111,227, 63,  3,  1, 34,  0,  0,  0,132, 92,  0,
-  0,  0,  0,  9,108,223,  6,  0,  0,  0,216, 64,  0, 21,128,238, 41,  0,  0,100,229, 68,  1,  0, 73,216,  0,  0,115,223,166,  0,  0,  0,  0,211, 87,  3,128,188,  0,  8,190,119,  0,  0,  0,  0,  0,  0,  0,  0,  0,184,163,  0,  0,  0,132,216,  0,  0,  0,  0,152, 87,  0,  0,109,234,160,  0,  0, 93,220,237,214, 93, 47,238, 84,216, 40,  0, 62,245, 12,  0, 88,184,  0,  0,102,212,239,230,150, 14,  0,  0,145, 71,  9,207,  0,  0,  0,208, 68,  0,  0,  0,  0,161,120,  0,  0,104,213,241,236,175,  0,  0,  0, 17,229, 60,
-  0,  0,  0,  0,  0,248, 38,  0,  0,  0,216,241,240,234,168, 39,  0,  0,  0,  0, 87,204,240,233,223,146,  0,  0, 29,254, 79,  0,  0,  0,  0, 49,209,241,194, 32,  0,103,254,236,236,236,236, 55,  0,  0,  0, 27,240, 96,  0,  0,196,239,236,236,136,  0,  0,  1,115,219,235,149,  0,110,236,236,236,236,253, 69,  0, 72,209,234,204, 56,  0,  0, 75,217,238,181, 23,  0,216,241,235,231,175, 30,  0,216, 64,  0,  0,  0, 92,184,216, 64,  0,  0,100,207, 12,216,185,  0,  0,  0, 12,244,216,241,236,227,146,  5,  0, 11,187, 44,
- 43, 35,  0,  2,105,232,  7,  0, 77,218,239,228,126,  0,206,236,240,253,236,236,129,236, 40,  0,  0,  0,100,176,118,183,  0,  0,  0,169,120,190,111,  0,  0,  0,165,137,216,241,237,225,139,  4,  0,  0,  0,180,214, 96,  0,  0,218, 34,  0,  0,  0,  0,  0,120,194, 29,  0,  0,  0,  0,  0,  0,  0, 32,235, 10, 13,244, 51,  0, 91,218,  0, 22,238, 55,  1,138,181,  0,216, 64,  0,  9,158,175,  0,216, 64,  0,  0,  0, 92,184,216, 64,  0, 67,222, 27,  0,216,234, 95,  0,  0, 12,244,216, 64,  0, 20,200,113,  0,  0,  0,  0,
- 70,215,239,238,191, 50,  0, 33,243, 43,  0, 30, 57,  0,  0,  0, 52,224,  0,  0,  0,236, 40,  0,  0,  0,100,176,  4,211, 80,  0, 65,212,  5, 58,233, 12,  0, 46,239, 19,216, 64,  0, 27,207,110,  0,  0, 93,171,161, 96,  0,  0,240, 11,  0,  0,  0,  0,  2,224, 27,  0,  0,  0,  0,  0,  0,  0,  0,140,141,  0, 19,245,  6,  0, 36,226,  0, 87,183,  0,  0,  5,245, 20,216, 64,  0,  0, 74,209,  0,216, 64,  0,  0,  0, 92,184,216, 64, 40,225, 46,  0,  0,216,105,237, 22,  0, 12,244,216, 64,  0,  0,131,149,  0,  0,  0,  0,
- 95,236,236,236,237,255, 68, 59,227,  0,  0,  0,  0,  0,  0,  0, 52,224,  0,  0,  0,236, 40,  0,  0,  0,100,176,  0, 59,222, 14,212, 61,  0,  0,183,125,  0,181,127,  0,216, 64,  0,  0,133,154,  0, 23,216, 21,164, 96,  0,  3,249,224,235,185, 41,  0, 50,207,131,232,213, 73,  0,  0,  0,  0, 11,237, 35,  0,  0,145,181, 72,196, 91,  0, 90,177,  0,  0,  0,231, 51,216, 64,  0, 13,163,131,  0,216, 64,  0,  0,  0, 92,184,216, 85,219, 70,  0,  0,  0,216, 37,174,169,  0, 12,244,216, 64,  0, 35,212, 80,  0,  0,  0,  0,
-  0,  0,  0,  0,100,209,  4, 10,225,160, 28,  0,  0,  0,  0,  0, 52,224,  0,  0,  0,236, 40,  0,  0,  0,100,176,  0,  0,156,212,157,  0,  0,  0, 51,240, 79,236, 14,  0,216, 64,  2, 46,218, 91,  0,173, 85,  0,164, 96,  0,  0, 26,  5,  8,130,218,  1, 74,248, 95,  1, 70,239, 16,  0,  0,  0,107,180,  0,  0,  0, 39,227,225,195, 24,  0, 35,240, 50, 11,119,250, 45,216,241,236,254,191, 20,  0,216,241,236,236,236,243,184,216,230,239, 80,  0,  0,  0,216, 40, 29,243, 79, 12,244,216,241,239,254, 89,  0,  0, 11,189, 45,
-  0,  0,  0, 20,235, 57,  0,  0, 29,168,247,159, 22,  0,  0,  0, 52,224,  0,  0,  0,236, 40,  0,  0,  0,100,176,  0,  0, 72,255, 77,  0,  0,  0,  0,175,250,118,  0,  0,216,241,235,207,108,  0, 87,170,  0,  0,164, 96,  0,  0,  0,  0,  0,  2,247, 32, 80,206,  0,  0,  0,206, 61,  0,  0,  1,216, 71,  0,  0, 24,221, 50,  2,107,213,  8,  0, 92,217,227,109,235, 23,216, 64,  0,  6,117,214,  4,216, 64,  0,  0,  0, 92,184,216, 99, 78,234, 22,  0,  0,216, 40,  0,115,229, 24,244,216, 64,  0,196,102,  0,  0, 16,227, 58,
-  0,  0,  0,161,153,  0,  0,  0,  0,  0, 28,174,197,  0,  0,  0, 52,224,  0,  0,  0,234, 40,  0,  0,  0,100,175,  0,  3,208,133,213,  5,  0,  0,  0, 55,247, 10,  0,  0,216, 64,  0,  0,  0,  0,190,242,236,236,248,243,147,  0,  0,  0,  0,  4,249, 19, 47,227,  0,  0,  0,211, 52,  0,  0, 74,217,  1,  0,  0, 88,171,  0,  0,  0,210, 58,  0,  0,  0,  0, 47,220,  0,216, 64,  0,  0, 11,255, 30,216, 64,  0,  0,  0, 92,184,216, 64,  0,154,177,  0,  0,216, 40,  0,  4,209,154,242,216, 64,  0, 64,229,  9,  0,  0,  0,  0,
-  0,  0, 63,232, 17,  0,  0,  0,  0,  0,  0, 33,252,  1,  0,  0, 52,224,  0,  0,  0,205, 69,  0,  0,  0,131,150,  0,112,168,  0,178,118,  0,  0,  0, 36,240,  0,  0,  0,216, 64,  0,  0,  0,  0, 18, 24, 24, 24,172,111, 15, 31, 55,  2,  6,135,190,  0,  1,210,113,  0, 74,227,  8,  0,  0,185,110,  0,  0,  0, 55,228, 32,  0, 54,238, 21,  0,  3,  0, 38,208, 93,  0,216, 64,  0,  1,112,233,  3,216, 64,  0,  0,  0, 92,184,216, 64,  0, 11,218, 98,  0,216, 40,  0,  0, 58,253,243,216, 64,  0,  0,189,121,  0,  0,  0,  0,
-  0,  6,215, 92,  0,  0,  0, 35, 37,  1,  2,116,198,  0,  0,  0, 52,224,  0,  0,  0,116,196, 26,  0, 49,231, 58, 25,230, 28,  0, 35,237, 29,  0,  0, 36,240,  0,  0,  0,216, 64,  0,  0,  0,  0,  0,  0,  0,  0,164, 96,  0, 37,205,239,229,166, 23,  0,  0, 36,194,237,206, 56,  0,  0, 41,242, 14,  0,  0,  0,  0,110,222,236,210, 75,  0,  0,189,236,212, 97,  0,  0,216,241,236,238,195, 54,  0,216, 64,  0,  0,  0, 92,184,216, 64,  0,  0, 54,238, 32,216, 40,  0,  0,  0,155,244,216, 64,  0,  0, 58,239, 18,  0,  0,  0,
-  0,124,189,  0,  0,  0,  0, 67,219,241,231,176, 32,  0,  0,  0, 52,224,  0,  0,  0,  4,126,222,238,212, 87,  0,166,123,  0,  0,  0,135,174,  0,  0, 36,240,  0,  0,  0,216, 64,  0,  0,  0,  0,  0,  0,  0,221, 42,116,220,236,207, 52,216,241,236,236,224,216,241,236,236,224,216, 64,  0,  0,  0,179, 85,  0,  0,  0,  0, 69, 20,  0,  0,  0, 73,240, 68, 93,235,237,105,237,102,228,236,111,100,225,236,125,  0,192, 85,  0,  7,245,111,  0,  0,231, 42,  0,  0,  0,  0,  0,  7, 14, 20,  2,  0,  0,  0,  0,  0,  0,  0,  0,
- 35,239, 38,  0,  0,  0,  0,  0, 42,199,239,198, 37,  0,  0, 40,190,236,218, 83,  0, 12,255,  4,  0,  0,168,100,211, 74,  0,  0, 51,231,  3, 90,210,  4,  0,124,177,  0,  0, 95,215,237,202, 38,  0,  0, 56,207,  0, 59, 25,  0, 92,197,216, 64,  0,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0, 88,176,  0,  0,  0,  0,198, 40,  0,  0,116,205,210, 68,  0,132,144,  0,252,146,  3, 50,250,160,  5, 34,245, 26,127,146,  0, 71,214,183,  0, 37,233,  0,  0,  0,  0,  7,107,212, 44, 76,205, 87,  2,  0,  0,  0,  0,  0,  0,
-136,251,236,236,236,236, 92,  3,219, 96,  0,110,199,  0,  4,218, 96,  1, 49,236, 41, 12,255,  4,  0,  0,168,100,122,159,  0,  0,136,145,  0,  0,179,119, 34,231, 26,  0,  0, 52, 27,  0,142,162,  0,  0,147,116,  0,  0,  0,  0, 52,207,216, 64,  0,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0, 10,237, 17,  0,  0,159,253,239,236,  3, 83, 13,196, 68,  0,132,144,  0,252, 43,  0,  0,232, 59,  0,  0,208, 59, 63,207,  0,145,106,235,  8, 99,168,  0,  0,  7,107,205,121, 14,  0,  0, 25,139,200, 87,  2,  0,  0,  0,  0,
-  0, 44,195,239,226, 46,  0, 56,226,  0,  0,  6,253, 20, 54,224,  0,  0,  0,157,126, 12,255,  4,  0,  0,168,100, 34,238,  5,  0,220, 55,  0,  0, 28,231,197,102,  0,  0,  0,  0,  0,  0, 72,194,  0,  3,231, 28,  0,  0,  0, 23,207, 85,216, 64,  0,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0,  0,163,102,  0,  0,  0,228, 40,  0,  0,  0,  0,196, 68,  0,132,144,  0,252, 21,  0,  0,228, 40,  0,  0,204, 64,  7,244, 15,218, 32,180, 71,160,103,  0, 59,220,110,  8,  0,  0,  0,  0,  0,  0, 17,132,211, 33,  0,  0,  0,
-  4,225, 99,  1, 21,  5,  0, 82,251,236,236,236,243, 37, 81,198,  0,  0,  0,131,148, 12,255,  4,  0,  0,170,100,  0,200, 74, 51,221,  0,  0,  0,  0,159,239,  6,  0,  0,  1,125,216,236,241,196,  0, 72,191,  0,  0,  0,  8,209, 86,  0,216,241,236,236,173,216,241,236,236,169,216, 64,  0,  0,  0,  0, 72,193,  0,  0,  0,228, 40,  0,  0,  0,  0,196, 68,  0,132,144,  0,252, 20,  0,  0,228, 40,  0,  0,204, 64,  0,190,102,212,  0,109,141,219, 38,  0, 22,134,207,122, 22,  0,  0,  0,  0, 33,138,205,117, 11,  0,  0,  0,
- 60,224,  0,  0,  0,  0,  0, 60,216,  0,  0,  0,  0,  0, 58,226,  0,  0,  0,159,119,  8,255,  8,  0,  0,196,100,  0,111,157,134,132,  0,  0,  0, 45,230,176,125,  0,  0, 81,220, 33,  0, 79,196,  0,163,100,  0,  0,  0, 69,156,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0,  0,  4,232, 30,  0,  0,228, 40,  0,  0,  0,  0,196, 68,  0,132,144,  0,252, 20,  0,  0,228, 40,  0,  0,204, 64,  0,125,210,136,  0, 37,214,228,  0,  0,  0,  0,  9,103,207,163, 24, 42,180,195, 85,  3,  0,  0,  0,  0,  0,
- 82,198,  0,  0,  0,  0,  0,  4,222, 98,  1,  1, 42,  0,  4,220,102,  1, 50,236, 35,  0,228, 86,  0, 65,252,100,  0, 24,226,210, 42,  0,  0,  3,202, 93, 21,230, 43,  0, 96,197,  8, 14,176,196, 10,236, 17,  0,  0,  0, 16, 26,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0,  0,  0,147,119,  0,  0,227, 40,  0,  0,  0,  0,196, 68,  0,132,144,  0,252, 20,  0,  0,228, 40,  0,  0,204, 64,  0, 60,255, 61,  0,  0,220,164,  0,  0,  0,  0,  0,  0,  1, 72, 35, 54, 54,  0,  0,  0,  0,  0,  0,  0,  0,
- 62,223,  0,  0,  0,  0,  0,  0, 40,190,238,234,164,  0,  0, 40,194,239,212, 75,  0,  0, 77,222,231,172,153,100,  0,  0,189,208,  0,  0,  0,117,185,  0,  0, 97,200,  3, 12,183,241,213, 86,196, 88,175,  0,  0,  0,  0, 92,150,  0,  0,216, 64,  0,  0,  0,216, 64,  0,  0,  0,216, 67,  4,  4,  3,  0,  0, 56,210,  0,  0,210, 86,  0,  0,  0,  0,196, 68,  0,132,144,  0,237, 97,224,237,153,  1,  6,156,231,237,183,  2, 77,236,236,238,255, 22,234, 68,221,172,  0,  0, 68,207,  0,  0,  0,  0,  0,  4,220,  0,  0,  0,  0,
-  6,229, 95,  1, 16, 16,  0,  0, 54,210,  0,  0,  0, 77,236,236,236,236,236, 40, 47,225,  1,251, 17,  5,250, 44, 47,225, 33,203,227,133, 31, 78, 53, 11,189, 45, 61,233, 18,  0,  0,  0,  0,  0,179, 85,  0,  0,  0,  0,114,183,  0,  0,216,241,236,236,224,216, 64,  0,  0,  0,216,255,255,255,252,  0,  0,  0,220, 46,  0, 87,229,229, 13,  0,  0,196, 68, 92,234,237,105,252,158,  6, 18,220, 69, 81,193,  5,  6, 52,  0,  0,  0,  0,117,177,  0,250,180, 13,  0, 16,  6, 42,183,  0, 24,  0,  0,  0,  4,220,  0,  0,  0,  0,
-  0, 51,202,239,228, 45,  0,  0,163,194, 75,  0,  0,  0,  0,  0,  0,  0,  0,  0, 27,205,  0,228,  1, 47,218,  0, 27,205, 76, 38, 22,138,229,177, 11, 16,227, 58,  0, 90,158,  7,236,236,236,236,236, 84,121,236,236, 92,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,252, 46,  0,  0,157,107, 46,232, 83,  3,  0,  0,  0,  0, 37,230, 25,  0,252, 59,  0,  0,112,242,180,219,204,251,  7, 95,236,236,253,236,236, 55,  0,
-  0,  0,  0,  0,  0,  0,  0, 22,199, 34,192,  0,  0,  0,  0,  0,  0,  0,  0,  0,  6,185,  0,188,  0,103,119,  0,  6,185,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,252, 22,  0,  0,152,112,  0, 58,186,219, 76,  0,  0,  1,193, 97,  0,  0,252, 21,  0,  0,  0, 10,168,230, 66,  3,  0,  0,  0,  4,220,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,125,102,  0,171, 59,  0, 77,236,236,236,236,236, 40,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,252, 20,  0,  0,152,112,  0,  0,  0, 58,242, 18,  0,107,184,  0,  0,  0,252, 20,  0,  0,  0, 68,220, 79,207,  6,  0,  0,  0,  4,220,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  4,215, 12,  0, 54,178,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,252, 20,  0,  0,152,112, 36, 31,  0, 23,234, 26, 31,229, 30,  0,  0,  0,252, 20,  0,  0,  0, 70, 92,  1,140, 19,  0,  0,  0,  4,220,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0, 86,151,  0,  0,  0,193, 44,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,252, 20,  0,  0,152,112, 62,220,238,223,106,  0,132,250,236,236,236, 40,252, 20,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-};
-
-struct glyph {
-	bool exists;
-	int advance;
-	int width, height;
-	int xoffset, yoffset;
-	int atlas_xoffset, atlas_yoffset;
-};
-
-static constexpr int MAX_CHARSET = 256;
-
-static const glyph glyphs[MAX_CHARSET] = {
-	{
-		true,
-		0,
-		0, 0,
-		0, 0,
-		0, 0
-	},
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{
-		true,
-		3,
-		0, 0,
-		0, 0,
-		0, 0
-	},
-	{
-		true,
-		3,
-		3, 9,
-		0, 9,
-		125, 0
-	},
-	{
-		true,
-		5,
-		5, 3,
-		0, 9,
-		20, 36
-	},
-	{
-		true,
-		8,
-		8, 9,
-		0, 9,
-		99, 10
-	},
-	{
-		true,
-		7,
-		7, 11,
-		0, 10,
-		19, 0
-	},
-	{
-		true,
-		10,
-		10, 9,
-		0, 9,
-		62, 10
-	},
-	{
-		true,
-		9,
-		9, 9,
-		0, 9,
-		72, 10
-	},
-	{
-		true,
-		3,
-		2, 3,
-		0, 9,
-		28, 36
-	},
-	{
-		true,
-		4,
-		4, 11,
-		0, 9,
-		36, 0
-	},
-	{
-		true,
-		4,
-		4, 11,
-		0, 9,
-		40, 0
-	},
-	{
-		true,
-		7,
-		7, 6,
-		0, 10,
-		113, 35
-	},
-	{
-		true,
-		7,
-		7, 6,
-		0, 7,
-		120, 35
-	},
-	{
-		true,
-		3,
-		3, 3,
-		0, 1,
-		25, 36
-	},
-	{
-		true,
-		4,
-		4, 1,
-		0, 4,
-		50, 37
-	},
-	{
-		true,
-		3,
-		3, 2,
-		0, 2,
-		37, 36
-	},
-	{
-		true,
-		4,
-		5, 9,
-		0, 9,
-		48, 28
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		34, 11
-	},
-	{
-		true,
-		7,
-		4, 9,
-		1, 9,
-		83, 28
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		41, 11
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		0, 13
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		48, 19
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		55, 19
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		62, 19
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		69, 19
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		76, 19
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		83, 19
-	},
-	{
-		true,
-		3,
-		3, 7,
-		0, 7,
-		125, 18
-	},
-	{
-		true,
-		3,
-		3, 9,
-		0, 7,
-		125, 9
-	},
-	{
-		true,
-		7,
-		7, 7,
-		0, 8,
-		111, 28
-	},
-	{
-		true,
-		7,
-		7, 4,
-		0, 7,
-		13, 36
-	},
-	{
-		true,
-		7,
-		7, 7,
-		0, 8,
-		118, 28
-	},
-	{
-		true,
-		5,
-		5, 9,
-		0, 9,
-		53, 28
-	},
-	{
-		true,
-		11,
-		11, 10,
-		0, 9,
-		51, 0
-	},
-	{
-		true,
-		8,
-		8, 9,
-		0, 9,
-		107, 10
-	},
-	{
-		true,
-		8,
-		7, 9,
-		1, 9,
-		90, 19
-	},
-	{
-		true,
-		8,
-		8, 9,
-		0, 9,
-		115, 10
-	},
-	{
-		true,
-		9,
-		8, 9,
-		1, 9,
-		10, 11
-	},
-	{
-		true,
-		7,
-		5, 9,
-		1, 9,
-		58, 28
-	},
-	{
-		true,
-		6,
-		5, 9,
-		1, 9,
-		63, 28
-	},
-	{
-		true,
-		9,
-		8, 9,
-		0, 9,
-		18, 11
-	},
-	{
-		true,
-		9,
-		7, 9,
-		1, 9,
-		97, 19
-	},
-	{
-		true,
-		4,
-		4, 9,
-		0, 9,
-		87, 28
-	},
-	{
-		true,
-		3,
-		4, 12,
-		-1, 9,
-		6, 0
-	},
-	{
-		true,
-		7,
-		7, 9,
-		1, 9,
-		104, 19
-	},
-	{
-		true,
-		6,
-		5, 9,
-		1, 9,
-		68, 28
-	},
-	{
-		true,
-		11,
-		9, 9,
-		1, 9,
-		81, 10
-	},
-	{
-		true,
-		9,
-		7, 9,
-		1, 9,
-		111, 19
-	},
-	{
-		true,
-		9,
-		9, 9,
-		0, 9,
-		90, 10
-	},
-	{
-		true,
-		7,
-		6, 9,
-		1, 9,
-		42, 20
-	},
-	{
-		true,
-		9,
-		9, 11,
-		0, 9,
-		10, 0
-	},
-	{
-		true,
-		7,
-		7, 9,
-		1, 9,
-		118, 19
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		7, 20
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		14, 20
-	},
-	{
-		true,
-		9,
-		7, 9,
-		1, 9,
-		21, 20
-	},
-	{
-		true,
-		7,
-		8, 9,
-		0, 9,
-		26, 11
-	},
-	{
-		true,
-		11,
-		11, 9,
-		0, 9,
-		51, 10
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		28, 20
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		35, 20
-	},
-	{
-		true,
-		7,
-		7, 9,
-		0, 9,
-		0, 22
-	},
-	{
-		true,
-		4,
-		4, 11,
-		0, 9,
-		44, 0
-	},
-	{
-		true,
-		4,
-		5, 9,
-		0, 9,
-		73, 28
-	},
-	{
-		true,
-		4,
-		3, 11,
-		0, 9,
-		48, 0
-	},
-	{
-		true,
-		7,
-		7, 6,
-		0, 9,
-		6, 36
-	},
-	{
-		true,
-		5,
-		7, 1,
-		-1, -1,
-		43, 37
-	},
-	{
-		true,
-		3,
-		3, 2,
-		0, 10,
-		40, 36
-	},
-	{
-		true,
-		7,
-		6, 7,
-		0, 7,
-		42, 29
-	},
-	{
-		true,
-		7,
-		6, 10,
-		1, 10,
-		90, 0
-	},
-	{
-		true,
-		6,
-		6, 7,
-		0, 7,
-		0, 31
-	},
-	{
-		true,
-		7,
-		7, 10,
-		0, 10,
-		62, 0
-	},
-	{
-		true,
-		7,
-		7, 7,
-		0, 7,
-		7, 29
-	},
-	{
-		true,
-		4,
-		5, 10,
-		0, 10,
-		114, 0
-	},
-	{
-		true,
-		7,
-		7, 10,
-		0, 7,
-		69, 0
-	},
-	{
-		true,
-		7,
-		6, 10,
-		1, 10,
-		96, 0
-	},
-	{
-		true,
-		3,
-		3, 10,
-		0, 10,
-		119, 0
-	},
-	{
-		true,
-		3,
-		4, 13,
-		-1, 10,
-		0, 0
-	},
-	{
-		true,
-		6,
-		6, 10,
-		1, 10,
-		102, 0
-	},
-	{
-		true,
-		3,
-		2, 10,
-		1, 10,
-		122, 0
-	},
-	{
-		true,
-		11,
-		10, 7,
-		1, 7,
-		91, 28
-	},
-	{
-		true,
-		7,
-		6, 7,
-		1, 7,
-		91, 35
-	},
-	{
-		true,
-		7,
-		7, 7,
-		0, 7,
-		14, 29
-	},
-	{
-		true,
-		7,
-		6, 10,
-		1, 7,
-		108, 0
-	},
-	{
-		true,
-		7,
-		7, 10,
-		0, 7,
-		76, 0
-	},
-	{
-		true,
-		5,
-		4, 7,
-		1, 7,
-		109, 35
-	},
-	{
-		true,
-		6,
-		6, 7,
-		0, 7,
-		97, 35
-	},
-	{
-		true,
-		4,
-		5, 9,
-		0, 9,
-		78, 28
-	},
-	{
-		true,
-		7,
-		7, 7,
-		0, 7,
-		21, 29
-	},
-	{
-		true,
-		6,
-		7, 7,
-		0, 7,
-		28, 29
-	},
-	{
-		true,
-		9,
-		10, 7,
-		0, 7,
-		101, 28
-	},
-	{
-		true,
-		6,
-		7, 7,
-		0, 7,
-		35, 29
-	},
-	{
-		true,
-		6,
-		7, 10,
-		0, 7,
-		83, 0
-	},
-	{
-		true,
-		6,
-		6, 7,
-		0, 7,
-		103, 35
-	},
-	{
-		true,
-		5,
-		5, 11,
-		0, 9,
-		26, 0
-	},
-	{
-		true,
-		7,
-		2, 13,
-		2, 10,
-		4, 0
-	},
-	{
-		true,
-		5,
-		5, 11,
-		0, 9,
-		31, 0
-	},
-	{
-		true,
-		7,
-		7, 2,
-		0, 6,
-		30, 36
-	},
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-	{ 0 },
-};
-
-}
-
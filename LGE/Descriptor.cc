@@ -7,6 +7,8 @@
 #include <LGE/Application.h>
 #include <LGE/Descriptor.h>
 #include <LGE/Log.h>
+#include <LGE/Stats.h>
+#include <LGE/Trace.h>
 #include <LGE/VulkanFunctions.h>
 
 #include <map>
@@ -197,6 +199,8 @@ CreateDescriptorSet (DescriptorSetLayout l)
 		if (result != VK_SUCCESS)
 			throw std::runtime_error (std::string ("vkCreateDescriptorPool returned ") + VulkanTypeToString (result));
 
+		StatAdd (STAT_DESCRIPTOR_POOLS);
+
 		try {
 			l->m_old_pools.push_back (pool);
 		} catch (...) {
@@ -230,6 +234,7 @@ CreateDescriptorSet (DescriptorSetLayout l)
 
 	VkDescriptorSet set = l->m_set_freelist.back ();
 	l->m_set_freelist.pop_back ();
+	StatAdd (STAT_DESCRIPTOR_SETS);
 	return set;
 }
 
@@ -250,6 +255,8 @@ CreateTemporaryDescriptorSet (DescriptorSetLayout l)
 void
 DescriptorNextFrame (void)
 {
+	LGE_TRACE_SCOPE ("DescriptorNextFrame");
+
 	for (DescriptorSetLayout l : layouts) {
 		l->m_stash_index++;
 		if (l->m_stash_index >= CPU_RENDER_AHEAD)
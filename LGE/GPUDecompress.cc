@@ -0,0 +1,555 @@
+/**
+ * GPU decompression.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEGPUDecompress"
+
+#include <LGE/AssetPackFormat.h>
+#include <LGE/Descriptor.h>
+#include <LGE/GPUDecompress.h>
+#include <LGE/Pipeline.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/Trace.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace LGE {
+
+#include "lz_decompress.comp.txt"
+
+static constexpr uint32_t DECOMPRESS_GROUP_SIZE = 32;
+
+struct DecompressPushConstants {
+	uint32_t num_chunks;
+	uint32_t last_chunk_size;
+	uint32_t src_offset;
+	uint32_t dst_offset;
+};
+
+class GPUDecompressPipeline : public Pipeline {
+public:
+	VkPipelineLayout m_layout;
+
+	GPUDecompressPipeline (DescriptorSetLayout set_layout)
+		: Pipeline ()
+	{
+		VkDescriptorSetLayout layouts[1] = {
+			GetVkDescriptorSetLayout (set_layout)
+		};
+
+		VkPushConstantRange push_constant_range {};
+		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		push_constant_range.offset = 0;
+		push_constant_range.size = sizeof (DecompressPushConstants);
+
+		VkPipelineLayoutCreateInfo layout_ci {};
+		layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layout_ci.setLayoutCount = 1;
+		layout_ci.pSetLayouts = layouts;
+		layout_ci.pushConstantRangeCount = 1;
+		layout_ci.pPushConstantRanges = &push_constant_range;
+
+		VkResult result = vkCreatePipelineLayout (gVkDevice,
+			&layout_ci, nullptr, &m_layout);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vkCreatePipelineLayout returned ") + VulkanTypeToString (result));
+
+		ShaderReloadWatch (lz_decompress_comp, "LGE/lz_decompress.comp");
+	}
+
+	~GPUDecompressPipeline (void)
+	{
+		ShaderReloadForget (this);
+		vkDestroyPipelineLayout (gVkDevice, m_layout, nullptr);
+	}
+
+	virtual void
+	Create (void) override
+	{
+		VkComputePipelineCreateInfo pipeline_ci {};
+		pipeline_ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipeline_ci.layout = m_layout;
+		pipeline_ci.basePipelineIndex = -1;
+
+		ShaderModuleInfo shader_module_info {};
+		shader_module_info.code = lz_decompress_comp;
+		shader_module_info.size = sizeof (lz_decompress_comp);
+		shader_module_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		LinkShaderModules (&pipeline_ci, shader_module_info);
+		VkResult result = vkCreateComputePipelines (gVkDevice,
+			gPipelineCache, 1, &pipeline_ci, nullptr, &m_pipeline);
+		FreeShaderModules (&pipeline_ci);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vkCreateComputePipelines returned ") + VulkanTypeToString (result));
+	}
+};
+
+/** Descriptor set layouts live until DescriptorTerminate. */
+static DescriptorSetLayout set_layout = nullptr;
+static GPUDecompressPipeline *pipeline = nullptr;
+
+static VkDeviceSize max_storage_range = 0;
+static VkDeviceSize storage_offset_alignment = 0;
+
+static void
+query_limits (void)
+{
+	if (max_storage_range)
+		return;
+
+	VkPhysicalDeviceProperties props;
+	::vkGetPhysicalDeviceProperties (gVkPhysicalDevice, &props);
+	max_storage_range = props.limits.maxStorageBufferRange;
+	storage_offset_alignment = props.limits.minStorageBufferOffsetAlignment;
+}
+
+static void
+create_pipeline (void)
+{
+	if (!set_layout) {
+		VkDescriptorSetLayoutBinding bindings[2] {};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[0].descriptorCount = 1;
+		bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkDescriptorSetLayoutCreateInfo set_layout_ci {};
+		set_layout_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		set_layout_ci.bindingCount = 2;
+		set_layout_ci.pBindings = bindings;
+		set_layout = GetDescriptorSetLayout (&set_layout_ci);
+	}
+
+	pipeline = new GPUDecompressPipeline (set_layout);
+}
+
+static VkDeviceSize
+align_up (VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+bool
+GPUDecompressSupported (uint64_t compressed_size, uint64_t uncompressed_size)
+{
+	query_limits ();
+
+	// Descriptors start at an aligned offset at or below the data.
+	VkDeviceSize slack = storage_offset_alignment + 4;
+	return compressed_size + slack <= max_storage_range
+		&& uncompressed_size + slack <= max_storage_range;
+}
+
+/**
+ * The range of a buffer that a storage buffer descriptor covers, for the
+ * regions that share it.
+ */
+struct StorageRange {
+	VkDeviceSize m_begin = UINT64_MAX;
+	VkDeviceSize m_end = 0;
+
+	/**
+	 * Extend the range to size bytes at offset, starting at an offset that
+	 * storage buffer descriptors can use. Returns false, and leaves the
+	 * range as it is, if the range would become too large.
+	 */
+	bool
+	extend (VkDeviceSize offset, VkDeviceSize size)
+	{
+		VkDeviceSize begin = std::min (m_begin, offset / storage_offset_alignment * storage_offset_alignment);
+		VkDeviceSize end = std::max (m_end, align_up (offset + size, 4));
+		if (end - begin > max_storage_range)
+			return false;
+
+		m_begin = begin;
+		m_end = end;
+		return true;
+	}
+
+	/** @return offset in the range, in words. */
+	uint32_t
+	word (VkDeviceSize offset) const
+	{
+		return (uint32_t) ((offset - m_begin) / 4);
+	}
+};
+
+void
+GPUDecompressCmd (VkCommandBuffer cmd, VkBuffer src, VkBuffer dst,
+	const GPUDecompressRegion *regions, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		const GPUDecompressRegion &region = regions[i];
+		if ((region.m_srcOffset | region.m_dstOffset) % 4)
+			throw std::runtime_error ("GPUDecompressCmd: offsets must be multiples of 4");
+		if (!GPUDecompressSupported (region.m_srcSize, region.m_uncompressedSize))
+			throw std::runtime_error ("GPUDecompressCmd: data is too large for a storage buffer");
+	}
+
+	if (!pipeline)
+		create_pipeline ();
+
+	pipeline->Bind (cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+	uint32_t i = 0;
+	while (i < count) {
+		// Give one descriptor set to as many regions as it can reach.
+		// Every region fits on its own, so each set gets at least one.
+		StorageRange src_range, dst_range;
+		uint32_t first = i;
+		for (; i < count; i++) {
+			const GPUDecompressRegion &region = regions[i];
+			StorageRange s = src_range, d = dst_range;
+			if (!s.extend (region.m_srcOffset, region.m_srcSize)
+				|| !d.extend (region.m_dstOffset, region.m_uncompressedSize))
+				break;
+
+			src_range = s;
+			dst_range = d;
+		}
+
+		VkDescriptorBufferInfo bi[2] {};
+		bi[0].buffer = src;
+		bi[0].offset = src_range.m_begin;
+		bi[0].range = src_range.m_end - src_range.m_begin;
+		bi[1].buffer = dst;
+		bi[1].offset = dst_range.m_begin;
+		bi[1].range = dst_range.m_end - dst_range.m_begin;
+
+		VkDescriptorSet set = CreateTemporaryDescriptorSet (set_layout);
+		VkWriteDescriptorSet wr[2] {};
+		for (uint32_t j = 0; j < 2; j++) {
+			wr[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			wr[j].dstSet = set;
+			wr[j].dstBinding = j;
+			wr[j].descriptorCount = 1;
+			wr[j].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			wr[j].pBufferInfo = &bi[j];
+		}
+
+		vkUpdateDescriptorSets (gVkDevice, 2, wr, 0, nullptr);
+		vkCmdBindDescriptorSets (cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+			pipeline->m_layout, 0, 1, &set, 0, nullptr);
+
+		for (uint32_t j = first; j < i; j++) {
+			const GPUDecompressRegion &region = regions[j];
+			uint64_t num_chunks = AssetPackNumChunks (region.m_uncompressedSize);
+			if (!num_chunks)
+				continue;
+
+			DecompressPushConstants pc {};
+			pc.num_chunks = (uint32_t) num_chunks;
+			pc.last_chunk_size = (uint32_t) (region.m_uncompressedSize
+				- (num_chunks - 1) * ASSET_PACK_CHUNK_SIZE);
+			pc.src_offset = src_range.word (region.m_srcOffset);
+			pc.dst_offset = dst_range.word (region.m_dstOffset);
+
+			vkCmdPushConstants (cmd, pipeline->m_layout, VK_SHADER_STAGE_COMPUTE_BIT,
+				0, sizeof (pc), &pc);
+			vkCmdDispatch (cmd, (pc.num_chunks + DECOMPRESS_GROUP_SIZE - 1) / DECOMPRESS_GROUP_SIZE, 1, 1);
+		}
+	}
+}
+
+/**
+ * Check the chunk table, so that the shader stays within the data.
+ */
+static void
+check_chunk_table (const void *data, size_t size, uint64_t uncompressed_size)
+{
+	uint64_t num_chunks = AssetPackNumChunks (uncompressed_size);
+	uint64_t table_size = (num_chunks + 1) * sizeof (uint32_t);
+	if (table_size > size)
+		throw std::runtime_error ("GPUDecompress: truncated chunk table");
+
+	const uint8_t *p = (const uint8_t *) data;
+	uint32_t prev;
+	::memcpy (&prev, p, sizeof (prev));
+	if (prev < table_size)
+		throw std::runtime_error ("GPUDecompress: corrupt chunk table");
+
+	for (uint64_t i = 1; i <= num_chunks; i++) {
+		uint32_t offset;
+		::memcpy (&offset, p + i * sizeof (uint32_t), sizeof (offset));
+		if (offset < prev || offset > size)
+			throw std::runtime_error ("GPUDecompress: corrupt chunk table");
+
+		prev = offset;
+	}
+}
+
+/** A buffer that only lives for the duration of one upload. */
+struct ScratchBuffer {
+	GPUBuffer m_buffer;
+
+	~ScratchBuffer (void)
+	{
+		if (m_buffer)
+			MMDestroyGPUBuffer (m_buffer);
+	}
+
+	VkBuffer
+	create (VkDeviceSize size, VkBufferUsageFlags usage)
+	{
+		m_buffer = MMCreateMeshGPUBuffer (nullptr, align_up (size, 4), usage,
+			MMMemoryClass::DEFAULT);
+		return m_buffer.m_buffer;
+	}
+};
+
+/** Buffers that GPUDecompressBatch::record uses. */
+struct BatchBuffers {
+	const GPUDecompressBatch *m_batch;
+
+	/** Device-local copy of the staging buffer. */
+	VkBuffer m_scratch;
+
+	/** Decoded texels, which are copied to the images from there. */
+	VkBuffer m_texels;
+};
+
+void
+GPUDecompressBatch::add (const void *data, size_t size, uint64_t uncompressed_size)
+{
+	check_chunk_table (data, size, uncompressed_size);
+	if (!GPUDecompressSupported (size, uncompressed_size))
+		throw std::runtime_error ("GPUDecompress: data is too large for a storage buffer");
+
+	Entry entry {};
+	entry.m_data = data;
+	entry.m_size = size;
+	entry.m_uncompressedSize = uncompressed_size;
+	entry.m_srcOffset = align_up (m_size, 4);
+	m_entries.push_back (entry);
+	m_size = entry.m_srcOffset + size;
+}
+
+void
+GPUDecompressBatch::AddBuffer (const void *data, size_t size, uint64_t uncompressed_size,
+	GPUBuffer &target, size_t offset)
+{
+	if (offset % 4)
+		throw std::runtime_error ("GPUDecompress: offset must be a multiple of 4");
+
+	add (data, size, uncompressed_size);
+	m_entries.back ().m_target = target.m_buffer;
+	m_entries.back ().m_dstOffset = offset;
+}
+
+GPUImage
+GPUDecompressBatch::AddTexture2DArray (const void *data, size_t size, uint64_t uncompressed_size,
+	VkFormat format, VkExtent2D extent, uint32_t array_layers, uint32_t mip_levels,
+	VkImageCreateFlags flags)
+{
+	add (data, size, uncompressed_size);
+
+	// The texels are decoded into a scratch buffer, and copied to the image
+	// from there, as buffer to image copies handle every format and tiling.
+	// Copies start at multiples of the texel block size.
+	VkExtent3D extent3d {};
+	extent3d.width = extent.width;
+	extent3d.height = extent.height;
+	extent3d.depth = 1;
+
+	VkDeviceSize block_size = MMGetMipLevelSize (format, { 1, 1, 1 }, 0);
+	VkDeviceSize texel_offset = align_up (m_texelSize, std::lcm (block_size, (VkDeviceSize) 4));
+
+	GPUImage image;
+	try {
+		image = MMCreateGPUImage (VK_IMAGE_TYPE_2D, extent3d, format,
+			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+			MMMemoryClass::TEXTURE, mip_levels, array_layers, flags);
+	} catch (...) {
+		m_size = m_entries.back ().m_srcOffset;
+		m_entries.pop_back ();
+		throw;
+	}
+
+	Entry &entry = m_entries.back ();
+	entry.m_target = VK_NULL_HANDLE;
+	entry.m_dstOffset = texel_offset;
+	entry.m_image = image;
+	m_texelSize = texel_offset + uncompressed_size;
+	return image;
+}
+
+void
+GPUDecompressBatch::write (void *mapped, size_t size, void *user)
+{
+	(void) size;
+
+	const GPUDecompressBatch *batch = (const GPUDecompressBatch *) user;
+	for (const Entry &entry : batch->m_entries)
+		::memcpy ((uint8_t *) mapped + entry.m_srcOffset, entry.m_data, entry.m_size);
+}
+
+void
+GPUDecompressBatch::record (VkCommandBuffer cmd, VkBuffer staging, void *user)
+{
+	const BatchBuffers *buffers = (const BatchBuffers *) user;
+	const std::vector<Entry> &entries = buffers->m_batch->m_entries;
+
+	VkBufferCopy copy {};
+	copy.size = buffers->m_batch->m_size;
+	vkCmdCopyBuffer (cmd, staging, buffers->m_scratch, 1, &copy);
+
+	VkMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+	// Entries that write to the same buffer, such as the texel buffer, are
+	// decoded by one GPUDecompressCmd, so that they share descriptor sets.
+	std::vector<GPUDecompressRegion> regions;
+	std::vector<VkImageMemoryBarrier> image_barriers;
+	for (size_t i = 0; i < entries.size ();) {
+		VkBuffer dst = entries[i].m_target ? entries[i].m_target : buffers->m_texels;
+
+		regions.clear ();
+		for (; i < entries.size (); i++) {
+			const Entry &entry = entries[i];
+			if ((entry.m_target ? entry.m_target : buffers->m_texels) != dst)
+				break;
+
+			regions.push_back ({ entry.m_srcOffset, entry.m_size, entry.m_dstOffset,
+				entry.m_uncompressedSize });
+
+			if (entry.m_target)
+				continue;
+
+			VkImageMemoryBarrier image_barrier {};
+			image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			image_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			image_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			image_barrier.image = entry.m_image.m_image;
+			image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			image_barrier.subresourceRange.levelCount = entry.m_image.m_mipLevels;
+			image_barrier.subresourceRange.layerCount = entry.m_image.m_arrayLayers;
+			image_barriers.push_back (image_barrier);
+		}
+
+		GPUDecompressCmd (cmd, buffers->m_scratch, dst, regions.data (),
+			(uint32_t) regions.size ());
+	}
+
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		(uint32_t) image_barriers.size (), image_barriers.data ());
+
+	if (image_barriers.empty ())
+		return;
+
+	for (const Entry &entry : entries)
+		if (!entry.m_target)
+			MMCmdCopyToTexture2DArray (cmd, buffers->m_texels, entry.m_dstOffset,
+				entry.m_image, entry.m_image.m_mipLevels);
+
+	for (VkImageMemoryBarrier &image_barrier : image_barriers) {
+		image_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		image_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		(uint32_t) image_barriers.size (), image_barriers.data ());
+}
+
+void
+GPUDecompressBatch::Submit (void)
+{
+	LGE_TRACE_SCOPE ("GPUDecompressBatch");
+
+	if (m_entries.empty ())
+		return;
+
+	try {
+		ScratchBuffer scratch, texels;
+		BatchBuffers buffers {};
+		buffers.m_batch = this;
+		buffers.m_scratch = scratch.create (m_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+			| VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+		if (m_texelSize)
+			buffers.m_texels = texels.create (m_texelSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+				| VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+		MMSubmitUpload (m_size, write, this, record, &buffers);
+	} catch (...) {
+		m_entries.clear ();
+		m_size = 0;
+		m_texelSize = 0;
+		throw;
+	}
+
+	m_entries.clear ();
+	m_size = 0;
+	m_texelSize = 0;
+}
+
+void
+GPUDecompressToBuffer (const void *data, size_t size, uint64_t uncompressed_size,
+	GPUBuffer &target, size_t offset)
+{
+	GPUDecompressBatch batch;
+	batch.AddBuffer (data, size, uncompressed_size, target, offset);
+	batch.Submit ();
+}
+
+GPUImage
+GPUDecompressTexture2DArray (const void *data, size_t size, uint64_t uncompressed_size,
+	VkFormat format, VkExtent2D extent, uint32_t array_layers, uint32_t mip_levels,
+	VkImageCreateFlags flags)
+{
+	GPUDecompressBatch batch;
+	GPUImage image = batch.AddTexture2DArray (data, size, uncompressed_size, format,
+		extent, array_layers, mip_levels, flags);
+
+	try {
+		batch.Submit ();
+	} catch (...) {
+		MMDestroyGPUImage (image);
+		throw;
+	}
+
+	return image;
+}
+
+void
+GPUDecompressTerminate (void)
+{
+	delete pipeline;
+	pipeline = nullptr;
+}
+
+}
@@ -0,0 +1,347 @@
+/**
+ * GPU-driven draw lists.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEGPUDrawList"
+
+#include <LGE/Application.h>
+#include <LGE/GPUDrawList.h>
+#include <LGE/Log.h>
+#include <LGE/Pipeline.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace LGE {
+
+#include "drawlist_cull.comp.txt"
+
+static constexpr uint32_t CULL_GROUP_SIZE = 64;
+
+/** Offset of the first draw command in the draw buffer. */
+static constexpr VkDeviceSize DRAW_COMMANDS_OFFSET = sizeof (uint32_t);
+
+struct CullPushConstants {
+	Math::vec4 planes[6];
+	uint32_t object_count;
+	uint32_t compact;
+};
+
+class GPUDrawListPipeline : public Pipeline {
+public:
+	VkPipelineLayout m_layout;
+
+	GPUDrawListPipeline (DescriptorSetLayout set_layout)
+		: Pipeline ()
+	{
+		VkDescriptorSetLayout layouts[1] = {
+			GetVkDescriptorSetLayout (set_layout)
+		};
+
+		VkPushConstantRange push_constant_range {};
+		push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		push_constant_range.offset = 0;
+		push_constant_range.size = sizeof (CullPushConstants);
+
+		VkPipelineLayoutCreateInfo layout_ci {};
+		layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layout_ci.setLayoutCount = 1;
+		layout_ci.pSetLayouts = layouts;
+		layout_ci.pushConstantRangeCount = 1;
+		layout_ci.pPushConstantRanges = &push_constant_range;
+
+		VkResult result = vkCreatePipelineLayout (gVkDevice,
+			&layout_ci, nullptr, &m_layout);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vkCreatePipelineLayout returned ") + VulkanTypeToString (result));
+
+		ShaderReloadWatch (drawlist_cull_comp, "LGE/drawlist_cull.comp");
+	}
+
+	~GPUDrawListPipeline (void)
+	{
+		ShaderReloadForget (this);
+		vkDestroyPipelineLayout (gVkDevice, m_layout, nullptr);
+	}
+
+	virtual void
+	Create (void) override
+	{
+		VkComputePipelineCreateInfo pipeline_ci {};
+		pipeline_ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipeline_ci.layout = m_layout;
+		pipeline_ci.basePipelineIndex = -1;
+
+		ShaderModuleInfo shader_module_info {};
+		shader_module_info.code = drawlist_cull_comp;
+		shader_module_info.size = sizeof (drawlist_cull_comp);
+		shader_module_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		LinkShaderModules (&pipeline_ci, shader_module_info);
+		VkResult result = vkCreateComputePipelines (gVkDevice,
+			gPipelineCache, 1, &pipeline_ci, nullptr, &m_pipeline);
+		FreeShaderModules (&pipeline_ci);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vkCreateComputePipelines returned ") + VulkanTypeToString (result));
+	}
+};
+
+GPUDrawList::GPUDrawList (GeometryArena &arena, uint32_t max_objects)
+	: m_arena (arena), m_maxObjects (max_objects)
+{
+	if (arena.GetIndexBuffer () == VK_NULL_HANDLE)
+		throw std::runtime_error ("GPUDrawList: the geometry arena has no index buffer");
+
+	// The vertex shader finds the object through gl_InstanceIndex.
+	if (!gVkFeatures10.drawIndirectFirstInstance)
+		throw std::runtime_error ("GPUDrawList: drawIndirectFirstInstance is not supported");
+
+	m_compact = gVkFeatures12.drawIndirectCount;
+	if (!m_compact)
+		LGE_LOG_WARNING ("drawIndirectCount is not supported; culled objects are drawn with zero instances");
+
+	VkDescriptorSetLayoutBinding bindings[2] {};
+	bindings[0].binding = 0;
+	bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[0].descriptorCount = 1;
+	bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[1].descriptorCount = 1;
+	bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+	VkDescriptorSetLayoutCreateInfo set_layout_ci {};
+	set_layout_ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	set_layout_ci.bindingCount = 2;
+	set_layout_ci.pBindings = bindings;
+	m_setLayout = GetDescriptorSetLayout (&set_layout_ci);
+
+	try {
+		m_objects.resize (max_objects);
+
+		m_objectBuffer = MMCreateMeshGPUBuffer (nullptr,
+			(size_t) max_objects * sizeof (GPUDrawObject),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+		m_drawBuffer = MMCreateMeshGPUBuffer (nullptr,
+			DRAW_COMMANDS_OFFSET + (size_t) max_objects * sizeof (VkDrawIndexedIndirectCommand),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+			| VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+		m_pipeline = new GPUDrawListPipeline (m_setLayout);
+		m_descriptorSet = CreateDescriptorSet (m_setLayout);
+	} catch (...) {
+		Destroy ();
+		throw;
+	}
+
+	VkDescriptorBufferInfo bi[2] {};
+	bi[0].buffer = m_objectBuffer.m_buffer;
+	bi[0].offset = 0;
+	bi[0].range = VK_WHOLE_SIZE;
+	bi[1].buffer = m_drawBuffer.m_buffer;
+	bi[1].offset = 0;
+	bi[1].range = VK_WHOLE_SIZE;
+
+	VkWriteDescriptorSet wr[2] {};
+	for (uint32_t i = 0; i < 2; i++) {
+		wr[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		wr[i].dstSet = m_descriptorSet;
+		wr[i].dstBinding = i;
+		wr[i].descriptorCount = 1;
+		wr[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		wr[i].pBufferInfo = &bi[i];
+	}
+
+	vkUpdateDescriptorSets (gVkDevice, 2, wr, 0, nullptr);
+}
+
+GPUDrawList::~GPUDrawList (void)
+{
+	Destroy ();
+}
+
+void
+GPUDrawList::Destroy (void)
+{
+	if (m_descriptorSet != VK_NULL_HANDLE)
+		FreeDescriptorSet (m_setLayout, m_descriptorSet);
+
+	delete m_pipeline;
+
+	if (m_drawBuffer)
+		MMReleaseGPUBuffer (m_drawBuffer);
+	if (m_objectBuffer)
+		MMReleaseGPUBuffer (m_objectBuffer);
+}
+
+void
+GPUDrawList::MarkDirty (GPUDrawObjectID id)
+{
+	if (m_dirtyBegin == m_dirtyEnd) {
+		m_dirtyBegin = id;
+		m_dirtyEnd = id + 1;
+		return;
+	}
+
+	if (id < m_dirtyBegin)
+		m_dirtyBegin = id;
+	if (id >= m_dirtyEnd)
+		m_dirtyEnd = id + 1;
+}
+
+GPUDrawObjectID
+GPUDrawList::AddObject (const GeometryRange &range, const Math::mat4 &transform,
+	const Math::vec3 &center, float radius)
+{
+	if (!range.m_indexCount)
+		throw std::runtime_error ("GPUDrawList: only indexed meshes can be drawn");
+
+	GPUDrawObjectID id;
+	if (!m_freeIDs.empty ()) {
+		id = m_freeIDs.back ();
+		m_freeIDs.pop_back ();
+	} else if (m_numObjects < m_maxObjects) {
+		id = m_numObjects++;
+	} else {
+		return UINT32_MAX;
+	}
+
+	GPUDrawObject &obj = m_objects[id];
+	obj.m_transform = transform;
+	obj.m_bounds = Math::vec4 (center, radius);
+	obj.m_firstIndex = range.m_firstIndex;
+	obj.m_indexCount = range.m_indexCount;
+	obj.m_vertexOffset = (int32_t) range.m_firstVertex;
+	obj.m_pad = 0;
+	MarkDirty (id);
+
+	return id;
+}
+
+void
+GPUDrawList::SetTransform (GPUDrawObjectID id, const Math::mat4 &transform)
+{
+	m_objects[id].m_transform = transform;
+	MarkDirty (id);
+}
+
+void
+GPUDrawList::RemoveObject (GPUDrawObjectID id)
+{
+	// The object buffer is only written from the command buffer of a
+	// frame, so the slot can be reused right away.
+	m_objects[id] = {};
+	m_freeIDs.push_back (id);
+	MarkDirty (id);
+}
+
+/**
+ * Extract normalized frustum planes from a world to clip space transform,
+ * for clip space depth in [0, 1].
+ */
+static void
+frustum_planes (const Math::mat4 &m, Math::vec4 planes[6])
+{
+	Math::vec4 row[4];
+	for (int i = 0; i < 4; i++)
+		row[i] = Math::vec4 (m[0][i], m[1][i], m[2][i], m[3][i]);
+
+	planes[0] = row[3] + row[0];
+	planes[1] = row[3] - row[0];
+	planes[2] = row[3] + row[1];
+	planes[3] = row[3] - row[1];
+	planes[4] = row[2];
+	planes[5] = row[3] - row[2];
+
+	for (int i = 0; i < 6; i++)
+		planes[i] /= Math::length (Math::vec3 (planes[i]));
+}
+
+void
+GPUDrawList::Cull (VkCommandBuffer cmd, const Math::mat4 &view_projection)
+{
+	// The previous frame may still read the object and draw buffers.
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+	if (m_dirtyBegin != m_dirtyEnd) {
+		size_t offset = (size_t) m_dirtyBegin * sizeof (GPUDrawObject);
+		size_t size = (size_t) (m_dirtyEnd - m_dirtyBegin) * sizeof (GPUDrawObject);
+		VkBuffer staging = MMCreateTemporaryGPUBuffer (&m_objects[m_dirtyBegin],
+			size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+		VkBufferCopy region {};
+		region.srcOffset = 0;
+		region.dstOffset = offset;
+		region.size = size;
+		vkCmdCopyBuffer (cmd, staging, m_objectBuffer.m_buffer, 1, &region);
+
+		m_dirtyBegin = m_dirtyEnd = 0;
+	}
+
+	if (m_compact)
+		vkCmdFillBuffer (cmd, m_drawBuffer.m_buffer, 0, DRAW_COMMANDS_OFFSET, 0);
+
+	VkMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+	if (m_numObjects) {
+		CullPushConstants pc {};
+		frustum_planes (view_projection, pc.planes);
+		pc.object_count = m_numObjects;
+		pc.compact = m_compact;
+
+		m_pipeline->Bind (cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+		vkCmdBindDescriptorSets (cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+			m_pipeline->m_layout, 0, 1, &m_descriptorSet, 0, nullptr);
+		vkCmdPushConstants (cmd, m_pipeline->m_layout, VK_SHADER_STAGE_COMPUTE_BIT,
+			0, sizeof (pc), &pc);
+		vkCmdDispatch (cmd, (m_numObjects + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+	}
+
+	// Draw reads the commands, and the vertex shader reads the objects.
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+		0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void
+GPUDrawList::Draw (VkCommandBuffer cmd)
+{
+	if (!m_numObjects)
+		return;
+
+	m_arena.Bind (cmd);
+
+	VkBuffer buffer = m_drawBuffer.m_buffer;
+	uint32_t stride = sizeof (VkDrawIndexedIndirectCommand);
+
+	if (m_compact) {
+		vkCmdDrawIndexedIndirectCount (cmd, buffer, DRAW_COMMANDS_OFFSET,
+			buffer, 0, m_numObjects, stride);
+	} else if (gVkFeatures10.multiDrawIndirect) {
+		vkCmdDrawIndexedIndirect (cmd, buffer, DRAW_COMMANDS_OFFSET,
+			m_numObjects, stride);
+	} else {
+		for (uint32_t i = 0; i < m_numObjects; i++)
+			vkCmdDrawIndexedIndirect (cmd, buffer,
+				DRAW_COMMANDS_OFFSET + (VkDeviceSize) i * stride, 1, stride);
+	}
+}
+
+}
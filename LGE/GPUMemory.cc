@@ -8,11 +8,15 @@
 #include <LGE/Descriptor.h>
 #include <LGE/GPUMemory.h>
 #include <LGE/Log.h>
+#include <LGE/Stats.h>
+#include <LGE/Trace.h>
 #include <LGE/VulkanFunctions.h>
 
 #include <stdexcept>
 #include <string.h>
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 #include <vulkan/vulkan_format_traits.hpp>
@@ -22,6 +26,123 @@
 namespace LGE {
 
 static VmaAllocator gAllocator;
+static bool has_memory_budget = false;
+
+static MMOverBudgetCallback over_budget_callback = nullptr;
+static void *over_budget_user = nullptr;
+static float over_budget_threshold = 1.0f;
+static uint32_t over_budget_heaps = 0;
+static MMOverBudgetPolicy over_budget_policy = MMOverBudgetPolicy::ALLOW;
+static uint64_t frame_index = 0;
+static size_t stash_index = 0;
+
+/**
+ * Pools of the memory classes. Meshes get large blocks, so that long-lived
+ * buffers are packed densely. Transient memory is allocated linearly from the
+ * pool of the current frame, and every pool is emptied when its frame has
+ * completed.
+ */
+static constexpr VkDeviceSize MESH_BLOCK_SIZE = 64 << 20;
+static constexpr VkDeviceSize TRANSIENT_BLOCK_SIZE = 4 << 20;
+
+static VmaPool mesh_pool;
+static VmaPool texture_pool;
+static VmaPool transient_pools[CPU_RENDER_AHEAD];
+
+/**
+ * Movable resources live in their own pools, one per memory type, so that
+ * the defragmenter never sees allocations that it cannot move. VMA does not
+ * allow freeing an allocation while a pass is moving it, which would be
+ * impossible to guarantee for temporary buffers.
+ */
+static VmaPool movable_pools[VK_MAX_MEMORY_TYPES];
+
+/**
+ * Allocation flags for long-lived allocations, which are subject to the
+ * over-budget policy.
+ */
+static VmaAllocationCreateFlags
+budget_flags (void)
+{
+	if (over_budget_policy == MMOverBudgetPolicy::FAIL)
+		return VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+	return 0;
+}
+
+static void
+stop_defragmentation (void);
+
+static float
+class_priority (MMMemoryClass memory_class)
+{
+	switch (memory_class) {
+	case MMMemoryClass::MESH:
+		return 0.75f;
+	case MMMemoryClass::TEXTURE:
+		return 0.25f;
+	default:
+		return 0.5f;
+	}
+}
+
+static VmaPool
+class_pool (MMMemoryClass memory_class)
+{
+	switch (memory_class) {
+	case MMMemoryClass::MESH:
+		return mesh_pool;
+	case MMMemoryClass::TEXTURE:
+		return texture_pool;
+	case MMMemoryClass::TRANSIENT:
+		return transient_pools[stash_index];
+	default:
+		return VK_NULL_HANDLE;
+	}
+}
+
+/**
+ * Create a buffer in the pool of a memory class. If the pool cannot hold the
+ * buffer, because its memory type does not suit the buffer or the buffer is
+ * larger than a block, fall back to the default pools.
+ */
+static VkResult
+create_buffer (MMMemoryClass memory_class, const VkBufferCreateInfo &buffer_ci,
+	VmaAllocationCreateInfo alloc_info, GPUBuffer &buffer, VmaAllocationInfo *info)
+{
+	alloc_info.pool = class_pool (memory_class);
+	alloc_info.priority = class_priority (memory_class);
+
+	VkResult result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
+		&buffer.m_buffer, &buffer.m_allocation, info);
+	if (result != VK_SUCCESS && alloc_info.pool != VK_NULL_HANDLE) {
+		alloc_info.pool = VK_NULL_HANDLE;
+		result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
+			&buffer.m_buffer, &buffer.m_allocation, info);
+	}
+
+	return result;
+}
+
+/**
+ * Create an image in the pool of a memory class, like create_buffer.
+ */
+static VkResult
+create_image (MMMemoryClass memory_class, const VkImageCreateInfo &image_ci,
+	VmaAllocationCreateInfo alloc_ci, GPUImage &image)
+{
+	alloc_ci.pool = class_pool (memory_class);
+	alloc_ci.priority = class_priority (memory_class);
+
+	VkResult result = ::vmaCreateImage (gAllocator, &image_ci, &alloc_ci,
+		&image.m_image, &image.m_allocation, nullptr);
+	if (result != VK_SUCCESS && alloc_ci.pool != VK_NULL_HANDLE) {
+		alloc_ci.pool = VK_NULL_HANDLE;
+		result = ::vmaCreateImage (gAllocator, &image_ci, &alloc_ci,
+			&image.m_image, &image.m_allocation, nullptr);
+	}
+
+	return result;
+}
 
 class TemporaryCommandBuffer {
 public:
@@ -68,8 +189,12 @@ public:
 		return m_cmd;
 	}
 
+	/**
+	 * Submit the command buffer. Unless wait is set, the caller must keep
+	 * this object alive until the commands have completed.
+	 */
 	void
-	submit (void)
+	submit (bool wait = true)
 	{
 		VkResult result = ::vkEndCommandBuffer (m_cmd);
 		if (result != VK_SUCCESS)
@@ -83,9 +208,12 @@ public:
 		if (result != VK_SUCCESS)
 			throw std::runtime_error (std::string ("vkQueueSubmit returned ") + VulkanTypeToString (result));
 
+		if (!wait)
+			return;
+
 		result = ::vkQueueWaitIdle (gVkQueue);
 		if (result != VK_SUCCESS)
-			Log ("warning: vkQueueWaitIdle returned %s", VulkanTypeToString (result));
+			LGE_LOG_WARNING ("vkQueueWaitIdle returned %s", VulkanTypeToString (result));
 	}
 };
 
@@ -102,6 +230,19 @@ public:
 
 	VkBuffer
 	create (const void *data, size_t size)
+	{
+		void *mapped;
+		VkBuffer buffer = create (size, &mapped);
+		::memcpy (mapped, data, size);
+		return buffer;
+	}
+
+	/**
+	 * Create a staging buffer without filling it. The caller writes the
+	 * data to *mapped.
+	 */
+	VkBuffer
+	create (size_t size, void **mapped)
 	{
 		VkBufferCreateInfo buffer_ci {};
 		buffer_ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -124,11 +265,166 @@ public:
 		if (result != VK_SUCCESS)
 			throw std::runtime_error (std::string ("vmaCreateBuffer returned ") + VulkanTypeToString (result));
 
-		::memcpy (info.pMappedData, data, size);
+		StatAdd (STAT_GPU_ALLOCATIONS);
+		StatAdd (STAT_STAGING_UPLOADS);
+		StatAdd (STAT_UPLOAD_BYTES, size);
+		*mapped = info.pMappedData;
+		return m_buffer;
+	}
+};
+
+struct ReadbackBuffer {
+public:
+	VkBuffer m_buffer = VK_NULL_HANDLE;
+	VmaAllocation m_allocation = VK_NULL_HANDLE;
+	void *m_data = nullptr;
+
+	~ReadbackBuffer (void)
+	{
+		if (m_allocation != VK_NULL_HANDLE)
+			::vmaDestroyBuffer (gAllocator, m_buffer, m_allocation);
+	}
+
+	VkBuffer
+	create (size_t size)
+	{
+		VkBufferCreateInfo buffer_ci {};
+		buffer_ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		buffer_ci.size = size;
+		buffer_ci.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		buffer_ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		buffer_ci.queueFamilyIndexCount = 1;
+		buffer_ci.pQueueFamilyIndices = &gVkQueueFamily;
+
+		VmaAllocationCreateInfo alloc_info {};
+		alloc_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT
+			| VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+		alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+		alloc_info.priority = 0.5f;
+
+		VmaAllocationInfo info;
+		VkResult result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
+			&m_buffer, &m_allocation, &info);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vmaCreateBuffer returned ") + VulkanTypeToString (result));
+
+		StatAdd (STAT_GPU_ALLOCATIONS);
+		m_data = info.pMappedData;
 		return m_buffer;
 	}
+
+	void
+	read (void *data, size_t size)
+	{
+		VkResult result = ::vmaInvalidateAllocation (gAllocator, m_allocation, 0, size);
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vmaInvalidateAllocation returned ") + VulkanTypeToString (result));
+
+		::memcpy (data, m_data, size);
+	}
 };
 
+static uint32_t
+find_buffer_memory_type (VkBufferUsageFlags usage, VmaAllocationCreateFlags flags)
+{
+	VkBufferCreateInfo buffer_ci {};
+	buffer_ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_ci.size = 65536;
+	buffer_ci.usage = usage;
+	buffer_ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VmaAllocationCreateInfo alloc_info {};
+	alloc_info.flags = flags;
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+
+	uint32_t memory_type;
+	VkResult result = ::vmaFindMemoryTypeIndexForBufferInfo (gAllocator,
+		&buffer_ci, &alloc_info, &memory_type);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaFindMemoryTypeIndexForBufferInfo returned ") + VulkanTypeToString (result));
+
+	return memory_type;
+}
+
+static uint32_t
+find_texture_memory_type (void)
+{
+	VkImageCreateInfo image_ci {};
+	image_ci.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_ci.imageType = VK_IMAGE_TYPE_2D;
+	image_ci.format = VK_FORMAT_R8G8B8A8_UNORM;
+	image_ci.extent = { 256, 256, 1 };
+	image_ci.mipLevels = 1;
+	image_ci.arrayLayers = 1;
+	image_ci.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_ci.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_ci.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	image_ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image_ci.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VmaAllocationCreateInfo alloc_ci {};
+	alloc_ci.usage = VMA_MEMORY_USAGE_AUTO;
+
+	uint32_t memory_type;
+	VkResult result = ::vmaFindMemoryTypeIndexForImageInfo (gAllocator,
+		&image_ci, &alloc_ci, &memory_type);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaFindMemoryTypeIndexForImageInfo returned ") + VulkanTypeToString (result));
+
+	return memory_type;
+}
+
+static VmaPool
+create_pool (uint32_t memory_type, VmaPoolCreateFlags flags, VkDeviceSize block_size,
+	size_t min_blocks, float priority)
+{
+	VmaPoolCreateInfo pool_ci {};
+	pool_ci.memoryTypeIndex = memory_type;
+	pool_ci.flags = flags;
+	pool_ci.blockSize = block_size;
+	pool_ci.minBlockCount = min_blocks;
+	pool_ci.priority = priority;
+
+	VmaPool pool;
+	VkResult result = ::vmaCreatePool (gAllocator, &pool_ci, &pool);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaCreatePool returned ") + VulkanTypeToString (result));
+
+	return pool;
+}
+
+static void
+create_class_pools (void)
+{
+	uint32_t mesh_type = find_buffer_memory_type (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+		| VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+		| VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0);
+	mesh_pool = create_pool (mesh_type, 0, MESH_BLOCK_SIZE, 0,
+		class_priority (MMMemoryClass::MESH));
+
+	texture_pool = create_pool (find_texture_memory_type (),
+		VMA_POOL_CREATE_IGNORE_BUFFER_IMAGE_GRANULARITY_BIT, 0, 0,
+		class_priority (MMMemoryClass::TEXTURE));
+
+	uint32_t transient_type = find_buffer_memory_type (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+		| VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+		| VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+	for (VmaPool &pool : transient_pools)
+		pool = create_pool (transient_type, VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,
+			TRANSIENT_BLOCK_SIZE, 1, class_priority (MMMemoryClass::TRANSIENT));
+}
+
+static void
+destroy_class_pools (void)
+{
+	::vmaDestroyPool (gAllocator, mesh_pool);
+	::vmaDestroyPool (gAllocator, texture_pool);
+	for (VmaPool pool : transient_pools)
+		::vmaDestroyPool (gAllocator, pool);
+}
+
 void
 MMInit (void)
 {
@@ -142,10 +438,26 @@ MMInit (void)
 	if (gVkFeatures12.bufferDeviceAddress)
 		allocator_ci.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
 
+	has_memory_budget = IsDeviceExtensionEnabled (VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (has_memory_budget)
+		allocator_ci.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+	else
+		Log ("VK_EXT_memory_budget is not supported; memory budgets are estimates");
+
+	if (gVkMemoryPriorityFeatures.memoryPriority)
+		allocator_ci.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
+
 	VkResult result = ::vmaCreateAllocator (&allocator_ci, &gAllocator);
 	if (result != VK_SUCCESS)
 		throw std::runtime_error (std::string ("vmaCreateAllocator returned ") + VulkanTypeToString (result));
 
+	try {
+		create_class_pools ();
+	} catch (...) {
+		::vmaDestroyAllocator (gAllocator);
+		throw;
+	}
+
 	DescriptorInit ();
 }
 
@@ -153,11 +465,19 @@ void
 MMTerminate (void)
 {
 	DescriptorTerminate ();
+	stop_defragmentation ();
 
 	// quick and dirty way to flush temporary buffers
 	for (size_t i = 0; i < CPU_RENDER_AHEAD; i++)
 		MMNextFrame ();
 
+	for (VmaPool &pool : movable_pools) {
+		if (pool != VK_NULL_HANDLE)
+			::vmaDestroyPool (gAllocator, pool);
+		pool = VK_NULL_HANDLE;
+	}
+
+	destroy_class_pools ();
 	::vmaDestroyAllocator (gAllocator);
 }
 
@@ -170,10 +490,15 @@ MMDestroyGPUBuffer (GPUBuffer &buffer)
 }
 
 GPUBuffer
-MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage)
+MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage,
+	MMMemoryClass memory_class)
 {
+	LGE_TRACE_SCOPE ("MMCreateMeshGPUBuffer");
+
 	if (size > UINT64_MAX)
 		throw std::runtime_error ("MMCreateMeshGPUBuffer: too large!");
+	if (memory_class == MMMemoryClass::TRANSIENT)
+		throw std::runtime_error ("MMCreateMeshGPUBuffer: transient memory is only for temporary buffers");
 
 	VkBufferCreateInfo buffer_ci {};
 	buffer_ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -188,16 +513,17 @@ MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage)
 		buffer_ci.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
 	VmaAllocationCreateInfo alloc_info {};
+	alloc_info.flags = budget_flags ();
 	alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
-	alloc_info.priority = 0.5f;
 
 	GPUBuffer mesh;
-	VkResult result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
-		&mesh.m_buffer, &mesh.m_allocation, nullptr);
+	VkResult result = create_buffer (memory_class, buffer_ci, alloc_info, mesh, nullptr);
 
 	if (result != VK_SUCCESS)
 		throw std::runtime_error (std::string ("vmaCreateBuffer returned ") + VulkanTypeToString (result));
 
+	StatAdd (STAT_GPU_ALLOCATIONS);
+
 	if (data) {
 		try {
 			Log ("Copy via MMCopyToGPUBuffer");
@@ -212,25 +538,61 @@ MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage)
 	return mesh;
 }
 
+static void
+copy_data (void *mapped, size_t size, void *user)
+{
+	::memcpy (mapped, user, size);
+}
+
 void
 MMCopyToGPUBuffer (GPUBuffer &target, const void *data, size_t size, size_t offset)
 {
-	StagingBuffer stagingmgr;
-	VkBuffer staging = stagingmgr.create (data, size);
+	MMUploadToGPUBuffer (target, size, offset, copy_data, (void *) data);
+}
 
-	TemporaryCommandBuffer cmdmgr;
-	VkCommandBuffer cmd = cmdmgr.create ();
+struct BufferCopy {
+	VkBuffer m_target;
+	size_t m_size;
+	size_t m_offset;
+};
+
+static void
+record_buffer_copy (VkCommandBuffer cmd, VkBuffer staging, void *user)
+{
+	const BufferCopy *copy = (const BufferCopy *) user;
 
 	VkBufferCopy copy_info {};
 	copy_info.srcOffset = 0;
-	copy_info.dstOffset = offset;
-	copy_info.size = size;
-	::vkCmdCopyBuffer (cmd, staging, target.m_buffer, 1, &copy_info);
+	copy_info.dstOffset = copy->m_offset;
+	copy_info.size = copy->m_size;
+	::vkCmdCopyBuffer (cmd, staging, copy->m_target, 1, &copy_info);
+}
+
+void
+MMUploadToGPUBuffer (GPUBuffer &target, size_t size, size_t offset,
+	MMWriteCallback write, void *user)
+{
+	LGE_TRACE_SCOPE ("MMUploadToGPUBuffer");
+
+	BufferCopy copy { target.m_buffer, size, offset };
+	MMSubmitUpload (size, write, user, record_buffer_copy, &copy);
+}
+
+void
+MMSubmitUpload (size_t size, MMWriteCallback write, void *write_user,
+	MMRecordCallback record, void *record_user)
+{
+	StagingBuffer stagingmgr;
+	void *mapped;
+	VkBuffer staging = stagingmgr.create (size, &mapped);
+	write (mapped, size, write_user);
 
+	TemporaryCommandBuffer cmdmgr;
+	VkCommandBuffer cmd = cmdmgr.create ();
+	record (cmd, staging, record_user);
 	cmdmgr.submit ();
 }
 
-static size_t stash_index = 0;
 static std::vector<GPUBuffer> stash[CPU_RENDER_AHEAD];
 
 VkBuffer
@@ -251,12 +613,11 @@ MMCreateTemporaryGPUBuffer (const void *data, size_t size, VkBufferUsageFlags us
 	alloc_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT
 		| VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
 	alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
-	alloc_info.priority = 0.5f;
 
 	GPUBuffer buffer;
 	VmaAllocationInfo info;
-	VkResult result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
-		&buffer.m_buffer, &buffer.m_allocation, &info);
+	VkResult result = create_buffer (MMMemoryClass::TRANSIENT, buffer_ci, alloc_info,
+		buffer, &info);
 
 	if (result != VK_SUCCESS)
 		throw std::runtime_error (std::string ("vmaCreateBuffer returned ") + VulkanTypeToString (result));
@@ -268,10 +629,71 @@ MMCreateTemporaryGPUBuffer (const void *data, size_t size, VkBufferUsageFlags us
 		throw;
 	}
 
+	StatAdd (STAT_GPU_ALLOCATIONS);
+	StatAdd (STAT_TEMPORARY_BUFFERS);
+	StatAdd (STAT_TEMPORARY_BUFFER_BYTES, size);
+
 	::memcpy (info.pMappedData, data, size);
 	return buffer.m_buffer;
 }
 
+GPUBuffer
+MMCreateMappedGPUBuffer (size_t size, VkBufferUsageFlags usage, void **mapped)
+{
+	if (size > UINT64_MAX)
+		throw std::runtime_error ("MMCreateMappedGPUBuffer: too large!");
+
+	VkBufferCreateInfo buffer_ci {};
+	buffer_ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_ci.size = size;
+	buffer_ci.usage = usage;
+	buffer_ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	buffer_ci.queueFamilyIndexCount = 1;
+	buffer_ci.pQueueFamilyIndices = &gVkQueueFamily;
+
+	VmaAllocationCreateInfo alloc_info {};
+	alloc_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT
+		| VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+	alloc_info.priority = 0.5f;
+
+	GPUBuffer buffer;
+	VmaAllocationInfo info;
+	VkResult result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
+		&buffer.m_buffer, &buffer.m_allocation, &info);
+
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaCreateBuffer returned ") + VulkanTypeToString (result));
+
+	StatAdd (STAT_GPU_ALLOCATIONS);
+	*mapped = info.pMappedData;
+	return buffer;
+}
+
+void
+MMFlushMappedGPUBuffer (const GPUBuffer &buffer, size_t offset, size_t size)
+{
+	VkResult result = ::vmaFlushAllocation (gAllocator, buffer.m_allocation, offset, size);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaFlushAllocation returned ") + VulkanTypeToString (result));
+}
+
+void
+MMReleaseGPUBuffer (GPUBuffer &buffer)
+{
+	try {
+		stash[stash_index].push_back (buffer);
+	} catch (...) {
+		// Out of memory. Wait for the GPU instead.
+		::vkDeviceWaitIdle (gVkDevice);
+		MMDestroyGPUBuffer (buffer);
+		return;
+	}
+
+	buffer.m_buffer = VK_NULL_HANDLE;
+	buffer.m_allocation = VK_NULL_HANDLE;
+}
+
 void
 MMDestroyGPUImage (GPUImage &image)
 {
@@ -280,17 +702,19 @@ MMDestroyGPUImage (GPUImage &image)
 	image.m_allocation = VK_NULL_HANDLE;
 }
 
-GPUImage
-MMCreateGPUImage (VkImageType type, VkExtent3D extent, VkFormat format,
-	VkImageUsageFlags usage)
+static VkImageCreateInfo
+image_create_info (VkImageType type, VkExtent3D extent, VkFormat format,
+	VkImageUsageFlags usage, uint32_t mip_levels = 1, uint32_t array_layers = 1,
+	VkImageCreateFlags flags = 0)
 {
 	VkImageCreateInfo image_ci {};
 	image_ci.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_ci.flags = flags;
 	image_ci.imageType = type;
 	image_ci.format = format;
 	image_ci.extent = extent;
-	image_ci.mipLevels = 1;
-	image_ci.arrayLayers = 1;
+	image_ci.mipLevels = mip_levels;
+	image_ci.arrayLayers = array_layers;
 	image_ci.samples = VK_SAMPLE_COUNT_1_BIT;
 	image_ci.tiling = VK_IMAGE_TILING_OPTIMAL;
 	image_ci.usage = usage;
@@ -298,69 +722,339 @@ MMCreateGPUImage (VkImageType type, VkExtent3D extent, VkFormat format,
 	image_ci.queueFamilyIndexCount = 1;
 	image_ci.pQueueFamilyIndices = &gVkQueueFamily;
 	image_ci.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	return image_ci;
+}
+
+uint32_t
+MMGetMipLevelCount (VkExtent3D extent)
+{
+	uint32_t size = std::max ({ extent.width, extent.height, extent.depth });
+
+	uint32_t levels = 1;
+	while (size >>= 1)
+		levels++;
+
+	return levels;
+}
+
+GPUImage
+MMCreateGPUImage (VkImageType type, VkExtent3D extent, VkFormat format,
+	VkImageUsageFlags usage, MMMemoryClass memory_class,
+	uint32_t mip_levels, uint32_t array_layers, VkImageCreateFlags flags)
+{
+	if (memory_class == MMMemoryClass::TRANSIENT)
+		throw std::runtime_error ("MMCreateGPUImage: transient memory is only for temporary buffers");
+
+	VkImageCreateInfo image_ci = image_create_info (type, extent, format, usage,
+		mip_levels, array_layers, flags);
 
 	VmaAllocationCreateInfo alloc_ci {};
+	alloc_ci.flags = budget_flags ();
 	alloc_ci.usage = VMA_MEMORY_USAGE_AUTO;
-	alloc_ci.priority = 0.5f;
 
 	GPUImage image;
-	VkResult result = ::vmaCreateImage (gAllocator, &image_ci, &alloc_ci,
-		&image.m_image, &image.m_allocation, nullptr);
+	VkResult result = create_image (memory_class, image_ci, alloc_ci, image);
 
 	if (result != VK_SUCCESS)
 		throw std::runtime_error (std::string ("vmaCreateImage returned ") + VulkanTypeToString (result));
 
+	StatAdd (STAT_GPU_ALLOCATIONS);
+
+	image.m_type = type;
+	image.m_flags = flags;
+	image.m_format = format;
+	image.m_extent = extent;
+	image.m_mipLevels = mip_levels;
+	image.m_arrayLayers = array_layers;
 	return image;
 }
 
-GPUImage
-MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data)
+static VkExtent3D
+level_extent (VkExtent3D extent, uint32_t level)
 {
-	VkExtent3D extent3d {};
-	extent3d.width = extent.width;
-	extent3d.height = extent.height;
-	extent3d.depth = 1;
-	GPUImage image = MMCreateGPUImage (VK_IMAGE_TYPE_2D, extent3d, format,
-		VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+	VkExtent3D e {};
+	e.width = std::max (extent.width >> level, 1u);
+	e.height = std::max (extent.height >> level, 1u);
+	e.depth = std::max (extent.depth >> level, 1u);
+	return e;
+}
 
-	try {
-		VkDeviceSize size = (VkDeviceSize) extent.width * extent.height
-			* vk::blockSize (static_cast <vk::Format> (format));
-
-		StagingBuffer stagingmgr;
-		VkBuffer staging = stagingmgr.create (data, size);
-
-		TemporaryCommandBuffer cmdmgr;
-		VkCommandBuffer cmd = cmdmgr.create ();
-
-		VkImageMemoryBarrier barrier {};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.image = image.m_image;
-		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		barrier.subresourceRange.levelCount = 1;
-		barrier.subresourceRange.layerCount = 1;
+VkDeviceSize
+MMGetMipLevelSize (VkFormat format, VkExtent3D extent, uint32_t level)
+{
+	// Block-compressed levels are stored in whole blocks, also when the
+	// level is smaller than one block.
+	vk::Format f = static_cast <vk::Format> (format);
+	std::array<uint8_t, 3> block = vk::blockExtent (f);
+
+	VkExtent3D e = level_extent (extent, level);
+	VkDeviceSize blocks_x = (e.width + block[0] - 1) / block[0];
+	VkDeviceSize blocks_y = (e.height + block[1] - 1) / block[1];
+	VkDeviceSize blocks_z = (e.depth + block[2] - 1) / block[2];
+	return blocks_x * blocks_y * blocks_z * vk::blockSize (f);
+}
+
+/**
+ * Test if mip levels of a format can be generated with vkCmdBlitImage, and
+ * pick the filter to do it with.
+ */
+static bool
+blit_supported (VkFormat format, VkFilter *filter)
+{
+	VkFormatProperties props;
+	::vkGetPhysicalDeviceFormatProperties (gVkPhysicalDevice, format, &props);
+
+	VkFormatFeatureFlags flags = props.optimalTilingFeatures;
+	if (!(flags & VK_FORMAT_FEATURE_BLIT_SRC_BIT) || !(flags & VK_FORMAT_FEATURE_BLIT_DST_BIT))
+		return false;
+
+	*filter = (flags & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+		? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+	return true;
+}
+
+/**
+ * Record the generation of mip levels base_level + 1 and up from base_level.
+ * All levels must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, and all of
+ * them are left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+ *
+ * Every level is blitted from the one above it. A level is transitioned to
+ * TRANSFER_SRC once it has been written, and to SHADER_READ_ONLY once the
+ * next level has been read from it.
+ */
+static void
+record_mip_generation (VkCommandBuffer cmd, VkImage image, VkExtent3D extent,
+	uint32_t base_level, uint32_t mip_levels, uint32_t array_layers, VkFilter filter)
+{
+	VkImageMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = array_layers;
+
+	for (uint32_t level = base_level + 1; level < mip_levels; level++) {
+		barrier.subresourceRange.baseMipLevel = level - 1;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
 		vkCmdPipelineBarrier (cmd,
-			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
 			VK_PIPELINE_STAGE_TRANSFER_BIT,
 			0,
 			0, nullptr,
 			0, nullptr,
 			1, &barrier);
 
-		VkBufferImageCopy copy {};
-		copy.bufferRowLength = extent.width;
-		copy.bufferImageHeight = extent.height;
-		copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		copy.imageSubresource.layerCount = 1;
-		copy.imageExtent = extent3d;
-		vkCmdCopyBufferToImage (cmd, staging, image.m_image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
-
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		VkExtent3D src = level_extent (extent, level - 1);
+		VkExtent3D dst = level_extent (extent, level);
+
+		VkImageBlit blit {};
+		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.srcSubresource.mipLevel = level - 1;
+		blit.srcSubresource.layerCount = array_layers;
+		blit.srcOffsets[1] = { (int32_t) src.width, (int32_t) src.height, (int32_t) src.depth };
+		blit.dstSubresource = blit.srcSubresource;
+		blit.dstSubresource.mipLevel = level;
+		blit.dstOffsets[1] = { (int32_t) dst.width, (int32_t) dst.height, (int32_t) dst.depth };
+		vkCmdBlitImage (cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, filter);
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		vkCmdPipelineBarrier (cmd,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier);
+	}
+
+	// The levels above base_level were not read from, and the last level
+	// was only written to.
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkImageMemoryBarrier barriers[2] = { barrier, barrier };
+	uint32_t num_barriers = 0;
+	if (base_level) {
+		barriers[num_barriers].subresourceRange.baseMipLevel = 0;
+		barriers[num_barriers].subresourceRange.levelCount = base_level;
+		num_barriers++;
+	}
+	barriers[num_barriers].subresourceRange.baseMipLevel = mip_levels - 1;
+	barriers[num_barriers].subresourceRange.levelCount = 1;
+	num_barriers++;
+
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		num_barriers, barriers);
+}
+
+void
+MMCmdGenerateMipmaps (VkCommandBuffer cmd, const GPUImage &image, VkImageLayout layout)
+{
+	VkFilter filter;
+	if (!blit_supported (image.m_format, &filter))
+		throw std::runtime_error (std::string ("MMCmdGenerateMipmaps: blits are not supported for ")
+			+ VulkanTypeToString (image.m_format));
+
+	VkImageMemoryBarrier barriers[2] {};
+	for (VkImageMemoryBarrier &b : barriers) {
+		b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		b.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		b.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+		b.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.image = image.m_image;
+		b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		b.subresourceRange.layerCount = image.m_arrayLayers;
+	}
+
+	barriers[0].oldLayout = layout;
+	barriers[0].subresourceRange.levelCount = 1;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[1].subresourceRange.baseMipLevel = 1;
+	barriers[1].subresourceRange.levelCount = image.m_mipLevels - 1;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		(image.m_mipLevels > 1) ? 2 : 1, barriers);
+
+	record_mip_generation (cmd, image.m_image, image.m_extent, 0,
+		image.m_mipLevels, image.m_arrayLayers, filter);
+}
+
+/**
+ * Decide how many mip levels a texture that is uploaded with data_levels
+ * levels gets.
+ */
+static uint32_t
+texture_mip_levels (VkFormat format, VkExtent2D extent, uint32_t data_levels,
+	bool generate_mipmaps, VkFilter *filter)
+{
+	if (vk::isCompressed (static_cast <vk::Format> (format))) {
+		VkFormatProperties props;
+		::vkGetPhysicalDeviceFormatProperties (gVkPhysicalDevice, format, &props);
+		if (!(props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+			throw std::runtime_error (std::string ("Compressed format ")
+				+ VulkanTypeToString (format) + " is not supported");
+	}
+
+	if (!generate_mipmaps)
+		return data_levels;
+
+	if (!blit_supported (format, filter)) {
+		LGE_LOG_WARNING ("Cannot generate mip levels for %s: blits are not supported",
+			VulkanTypeToString (format));
+		return data_levels;
+	}
+
+	return std::max (data_levels, MMGetMipLevelCount ({ extent.width, extent.height, 1 }));
+}
+
+static void
+record_texture_copy (VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize offset,
+	VkImage image, VkFormat format, VkExtent3D extent, uint32_t array_layers,
+	uint32_t data_levels)
+{
+	std::vector<VkBufferImageCopy> copies ((size_t) array_layers * data_levels);
+	for (uint32_t layer = 0; layer < array_layers; layer++) {
+		for (uint32_t level = 0; level < data_levels; level++) {
+			VkBufferImageCopy &copy = copies[layer * data_levels + level];
+			copy = {};
+			copy.bufferOffset = offset;
+			copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			copy.imageSubresource.mipLevel = level;
+			copy.imageSubresource.baseArrayLayer = layer;
+			copy.imageSubresource.layerCount = 1;
+			copy.imageExtent = level_extent (extent, level);
+			offset += MMGetMipLevelSize (format, extent, level);
+		}
+	}
+
+	vkCmdCopyBufferToImage (cmd, buffer, image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t) copies.size (), copies.data ());
+}
+
+void
+MMCmdCopyToTexture2DArray (VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize offset,
+	const GPUImage &image, uint32_t data_levels)
+{
+	record_texture_copy (cmd, buffer, offset, image.m_image, image.m_format, image.m_extent,
+		image.m_arrayLayers, data_levels);
+}
+
+/**
+ * Fill a newly created 2D image, and transition it to
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. Every layer holds the first
+ * data_levels mip levels, tightly packed. All layers are copied from one
+ * staging buffer. The remaining levels up to mip_levels are generated with
+ * filter.
+ */
+static void
+upload_texture_2d (VkImage image, VkFormat format, VkExtent2D extent,
+	uint32_t array_layers, MMWriteCallback write, void *user,
+	uint32_t data_levels, uint32_t mip_levels, VkFilter filter)
+{
+	VkExtent3D extent3d {};
+	extent3d.width = extent.width;
+	extent3d.height = extent.height;
+	extent3d.depth = 1;
+
+	VkDeviceSize layer_size = 0;
+	for (uint32_t level = 0; level < data_levels; level++)
+		layer_size += MMGetMipLevelSize (format, extent3d, level);
+
+	StagingBuffer stagingmgr;
+	void *mapped;
+	VkBuffer staging = stagingmgr.create (layer_size * array_layers, &mapped);
+	write (mapped, layer_size * array_layers, user);
+
+	TemporaryCommandBuffer cmdmgr;
+	VkCommandBuffer cmd = cmdmgr.create ();
+
+	VkImageMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = mip_levels;
+	barrier.subresourceRange.layerCount = array_layers;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	record_texture_copy (cmd, staging, 0, image, format, extent3d, array_layers, data_levels);
+
+	if (mip_levels > data_levels) {
+		record_mip_generation (cmd, image, extent3d, data_levels - 1,
+			mip_levels, array_layers, filter);
+	} else {
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -371,8 +1065,65 @@ MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data)
 			0, nullptr,
 			0, nullptr,
 			1, &barrier);
+	}
+
+	cmdmgr.submit ();
+}
+
+struct LayerData {
+	const void *const *m_layers;
+	uint32_t m_numLayers;
+};
+
+static void
+copy_layers (void *mapped, size_t size, void *user)
+{
+	const LayerData *data = (const LayerData *) user;
+	size_t layer_size = size / data->m_numLayers;
+	for (uint32_t layer = 0; layer < data->m_numLayers; layer++)
+		::memcpy ((uint8_t *) mapped + layer * layer_size, data->m_layers[layer], layer_size);
+}
+
+GPUImage
+MMUploadTexture2DArray (VkFormat format, VkExtent2D extent, uint32_t array_layers,
+	const void *const *layers, uint32_t mip_levels, bool generate_mipmaps,
+	VkImageCreateFlags flags)
+{
+	LayerData data { layers, array_layers };
+	return MMUploadTexture2DArray (format, extent, array_layers, copy_layers, &data,
+		mip_levels, generate_mipmaps, flags);
+}
 
-		cmdmgr.submit ();
+GPUImage
+MMUploadTexture2DArray (VkFormat format, VkExtent2D extent, uint32_t array_layers,
+	MMWriteCallback write, void *user, uint32_t mip_levels, bool generate_mipmaps,
+	VkImageCreateFlags flags)
+{
+	LGE_TRACE_SCOPE ("MMUploadTexture2DArray");
+
+	if (!mip_levels)
+		throw std::runtime_error ("MMUploadTexture2DArray: mip_levels must be at least 1");
+	if ((flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) && (array_layers % 6))
+		throw std::runtime_error ("MMUploadTexture2DArray: cube maps need a multiple of 6 layers");
+
+	VkFilter filter = VK_FILTER_LINEAR;
+	uint32_t levels = texture_mip_levels (format, extent, mip_levels,
+		generate_mipmaps, &filter);
+
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	if (levels > mip_levels)
+		usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+	VkExtent3D extent3d {};
+	extent3d.width = extent.width;
+	extent3d.height = extent.height;
+	extent3d.depth = 1;
+	GPUImage image = MMCreateGPUImage (VK_IMAGE_TYPE_2D, extent3d, format,
+		usage, MMMemoryClass::TEXTURE, levels, array_layers, flags);
+
+	try {
+		upload_texture_2d (image.m_image, format, extent, array_layers, write, user,
+			mip_levels, levels, filter);
 	} catch (...) {
 		MMDestroyGPUImage (image);
 		throw;
@@ -381,11 +1132,856 @@ MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data)
 	return image;
 }
 
+GPUImage
+MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data,
+	uint32_t mip_levels, bool generate_mipmaps)
+{
+	return MMUploadTexture2DArray (format, extent, 1, &data, mip_levels, generate_mipmaps);
+}
+
+GPUImage
+MMUploadTextureCube (VkFormat format, VkExtent2D extent, const void *const faces[6],
+	uint32_t mip_levels, bool generate_mipmaps)
+{
+	return MMUploadTexture2DArray (format, extent, 6, faces, mip_levels, generate_mipmaps,
+		VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
+}
+
+static VkImageAspectFlags
+view_aspect (VkFormat format)
+{
+	switch (format) {
+	case VK_FORMAT_D16_UNORM:
+	case VK_FORMAT_X8_D24_UNORM_PACK32:
+	case VK_FORMAT_D32_SFLOAT:
+	case VK_FORMAT_D16_UNORM_S8_UINT:
+	case VK_FORMAT_D24_UNORM_S8_UINT:
+	case VK_FORMAT_D32_SFLOAT_S8_UINT:
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+	case VK_FORMAT_S8_UINT:
+		return VK_IMAGE_ASPECT_STENCIL_BIT;
+	default:
+		return VK_IMAGE_ASPECT_COLOR_BIT;
+	}
+}
+
+VkImageView
+MMCreateImageView (const GPUImage &image, VkImageViewType type,
+	uint32_t base_level, uint32_t level_count, uint32_t base_layer, uint32_t layer_count)
+{
+	VkImageViewCreateInfo view_ci {};
+	view_ci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	view_ci.image = image.m_image;
+	view_ci.viewType = type;
+	view_ci.format = image.m_format;
+	view_ci.subresourceRange.aspectMask = view_aspect (image.m_format);
+	view_ci.subresourceRange.baseMipLevel = base_level;
+	view_ci.subresourceRange.levelCount = level_count;
+	view_ci.subresourceRange.baseArrayLayer = base_layer;
+	view_ci.subresourceRange.layerCount = layer_count;
+
+	VkImageView view;
+	VkResult result = ::vkCreateImageView (gVkDevice, &view_ci, nullptr, &view);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vkCreateImageView returned ") + VulkanTypeToString (result));
+
+	return view;
+}
+
+VkImageView
+MMCreateImageView (const GPUImage &image)
+{
+	bool arrayed = image.m_arrayLayers > 1;
+
+	VkImageViewType type;
+	if (image.m_type == VK_IMAGE_TYPE_3D)
+		type = VK_IMAGE_VIEW_TYPE_3D;
+	else if (image.m_type == VK_IMAGE_TYPE_1D)
+		type = arrayed ? VK_IMAGE_VIEW_TYPE_1D_ARRAY : VK_IMAGE_VIEW_TYPE_1D;
+	else if (image.m_flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
+		type = (image.m_arrayLayers > 6) ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+	else
+		type = arrayed ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+
+	return MMCreateImageView (image, type, 0, image.m_mipLevels, 0, image.m_arrayLayers);
+}
+
+void
+MMCopyToGPUImage (GPUImage &image, const void *data, size_t size,
+	uint32_t num_regions, const VkBufferImageCopy *regions)
+{
+	LGE_TRACE_SCOPE ("MMCopyToGPUImage");
+
+	StagingBuffer stagingmgr;
+	VkBuffer staging = stagingmgr.create (data, size);
+
+	TemporaryCommandBuffer cmdmgr;
+	VkCommandBuffer cmd = cmdmgr.create ();
+
+	// Earlier submissions might still be sampling the image. Keep the
+	// contents, as only the regions are overwritten.
+	VkImageMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image.m_image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = image.m_mipLevels;
+	barrier.subresourceRange.layerCount = image.m_arrayLayers;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	vkCmdCopyBufferToImage (cmd, staging, image.m_image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, num_regions, regions);
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	cmdmgr.submit ();
+}
+
+void
+MMDownloadTexture2D (const GPUImage &image, VkImageLayout layout, VkFormat format,
+	VkExtent2D extent, void *data)
+{
+	VkDeviceSize size = MMGetMipLevelSize (format, { extent.width, extent.height, 1 }, 0);
+
+	ReadbackBuffer readbackmgr;
+	VkBuffer readback = readbackmgr.create (size);
+
+	TemporaryCommandBuffer cmdmgr;
+	VkCommandBuffer cmd = cmdmgr.create ();
+
+	VkImageMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout = layout;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image.m_image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	VkBufferImageCopy copy {};
+	copy.bufferRowLength = extent.width;
+	copy.bufferImageHeight = extent.height;
+	copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	copy.imageSubresource.layerCount = 1;
+	copy.imageExtent.width = extent.width;
+	copy.imageExtent.height = extent.height;
+	copy.imageExtent.depth = 1;
+	vkCmdCopyImageToBuffer (cmd, image.m_image,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback, 1, &copy);
+
+	VkBufferMemoryBarrier buffer_barrier {};
+	buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	buffer_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	buffer_barrier.buffer = readback;
+	buffer_barrier.size = VK_WHOLE_SIZE;
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.newLayout = layout;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		0, nullptr,
+		1, &buffer_barrier,
+		1, &barrier);
+
+	cmdmgr.submit ();
+	readbackmgr.read (data, size);
+}
+
+/**
+ * Common part of movable buffers and images. The VmaAllocation of a movable
+ * resource points back to it through its user data, which is how the
+ * defragmenter finds the handle to retarget.
+ */
+struct MovableResource {
+	VmaAllocation m_allocation = VK_NULL_HANDLE;
+	bool m_isImage = false;
+
+	/** Set while the resource is part of a defragmentation pass. */
+	bool m_moving = false;
+
+	/** Set once the application has released the resource. */
+	bool m_released = false;
+
+	MMMoveCallback m_callback = nullptr;
+	void *m_user = nullptr;
+};
+
+struct MovableGPUBuffer_T : MovableResource {
+	VkBuffer m_buffer = VK_NULL_HANDLE;
+	VkBufferCreateInfo m_ci {};
+};
+
+struct MovableGPUImage_T : MovableResource {
+	VkImage m_image = VK_NULL_HANDLE;
+	VkImageCreateInfo m_ci {};
+};
+
+static std::vector<MovableResource *> movable_stash[CPU_RENDER_AHEAD];
+
+static VmaPool
+get_movable_pool (uint32_t memory_type)
+{
+	if (movable_pools[memory_type] != VK_NULL_HANDLE)
+		return movable_pools[memory_type];
+
+	VmaPoolCreateInfo pool_ci {};
+	pool_ci.memoryTypeIndex = memory_type;
+	pool_ci.priority = 0.5f;
+
+	VkResult result = ::vmaCreatePool (gAllocator, &pool_ci, &movable_pools[memory_type]);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaCreatePool returned ") + VulkanTypeToString (result));
+
+	return movable_pools[memory_type];
+}
+
+static VmaAllocationCreateInfo
+movable_alloc_info (MovableResource *res, const VkBufferCreateInfo *buffer_ci,
+	const VkImageCreateInfo *image_ci)
+{
+	VmaAllocationCreateInfo alloc_info {};
+	alloc_info.flags = budget_flags ();
+	alloc_info.usage = VMA_MEMORY_USAGE_AUTO;
+	alloc_info.priority = 0.5f;
+
+	uint32_t memory_type;
+	VkResult result = buffer_ci
+		? ::vmaFindMemoryTypeIndexForBufferInfo (gAllocator, buffer_ci, &alloc_info, &memory_type)
+		: ::vmaFindMemoryTypeIndexForImageInfo (gAllocator, image_ci, &alloc_info, &memory_type);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaFindMemoryTypeIndex returned ") + VulkanTypeToString (result));
+
+	alloc_info.pool = get_movable_pool (memory_type);
+	alloc_info.pUserData = res;
+	return alloc_info;
+}
+
+static void
+destroy_movable (MovableResource *res)
+{
+	if (res->m_isImage) {
+		MovableGPUImage_T *image = static_cast<MovableGPUImage_T *> (res);
+		::vmaDestroyImage (gAllocator, image->m_image, image->m_allocation);
+		delete image;
+	} else {
+		MovableGPUBuffer_T *buffer = static_cast<MovableGPUBuffer_T *> (res);
+		::vmaDestroyBuffer (gAllocator, buffer->m_buffer, buffer->m_allocation);
+		delete buffer;
+	}
+}
+
+static void
+release_movable (MovableResource *res)
+{
+	res->m_released = true;
+	try {
+		movable_stash[stash_index].push_back (res);
+	} catch (...) {
+		// Out of memory. Wait for the GPU instead, and for defragmentation
+		// to let go of the resource.
+		::vkDeviceWaitIdle (gVkDevice);
+		stop_defragmentation ();
+		destroy_movable (res);
+	}
+}
+
+MovableGPUBuffer
+MMCreateMovableMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage)
+{
+	LGE_TRACE_SCOPE ("MMCreateMovableMeshGPUBuffer");
+
+	if (size > UINT64_MAX)
+		throw std::runtime_error ("MMCreateMovableMeshGPUBuffer: too large!");
+
+	MovableGPUBuffer_T *buffer = new MovableGPUBuffer_T;
+	VkBufferCreateInfo &buffer_ci = buffer->m_ci;
+	buffer_ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_ci.size = size;
+	// The defragmenter copies the buffer to its new place.
+	buffer_ci.usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+		| VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	buffer_ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	buffer_ci.queueFamilyIndexCount = 1;
+	buffer_ci.pQueueFamilyIndices = &gVkQueueFamily;
+
+	try {
+		VmaAllocationCreateInfo alloc_info = movable_alloc_info (buffer, &buffer_ci, nullptr);
+		VkResult result = ::vmaCreateBuffer (gAllocator, &buffer_ci, &alloc_info,
+			&buffer->m_buffer, &buffer->m_allocation, nullptr);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vmaCreateBuffer returned ") + VulkanTypeToString (result));
+	} catch (...) {
+		delete buffer;
+		throw;
+	}
+
+	StatAdd (STAT_GPU_ALLOCATIONS);
+
+	if (data) {
+		try {
+			GPUBuffer target;
+			target.m_buffer = buffer->m_buffer;
+			target.m_allocation = buffer->m_allocation;
+			MMCopyToGPUBuffer (target, data, size, 0);
+		} catch (...) {
+			destroy_movable (buffer);
+			throw;
+		}
+	}
+
+	return buffer;
+}
+
+VkBuffer
+MMGetBuffer (MovableGPUBuffer buffer)
+{
+	return buffer->m_buffer;
+}
+
+void
+MMReleaseMovableGPUBuffer (MovableGPUBuffer buffer)
+{
+	release_movable (buffer);
+}
+
+MovableGPUImage
+MMUploadMovableTexture2D (VkFormat format, VkExtent2D extent, const void *data,
+	uint32_t mip_levels, bool generate_mipmaps)
+{
+	LGE_TRACE_SCOPE ("MMUploadMovableTexture2D");
+
+	if (!mip_levels)
+		throw std::runtime_error ("MMUploadMovableTexture2D: mip_levels must be at least 1");
+
+	VkFilter filter = VK_FILTER_LINEAR;
+	uint32_t levels = texture_mip_levels (format, extent, mip_levels,
+		generate_mipmaps, &filter);
+
+	VkExtent3D extent3d {};
+	extent3d.width = extent.width;
+	extent3d.height = extent.height;
+	extent3d.depth = 1;
+
+	MovableGPUImage_T *image = new MovableGPUImage_T;
+	image->m_isImage = true;
+	image->m_ci = image_create_info (VK_IMAGE_TYPE_2D, extent3d, format,
+		VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+		| VK_IMAGE_USAGE_TRANSFER_DST_BIT, levels);
+
+	try {
+		VmaAllocationCreateInfo alloc_ci = movable_alloc_info (image, nullptr, &image->m_ci);
+		VkResult result = ::vmaCreateImage (gAllocator, &image->m_ci, &alloc_ci,
+			&image->m_image, &image->m_allocation, nullptr);
+
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vmaCreateImage returned ") + VulkanTypeToString (result));
+	} catch (...) {
+		delete image;
+		throw;
+	}
+
+	StatAdd (STAT_GPU_ALLOCATIONS);
+
+	try {
+		LayerData data_layers { &data, 1 };
+		upload_texture_2d (image->m_image, format, extent, 1, copy_layers, &data_layers,
+			mip_levels, levels, filter);
+	} catch (...) {
+		destroy_movable (image);
+		throw;
+	}
+
+	return image;
+}
+
+VkImage
+MMGetImage (MovableGPUImage image)
+{
+	return image->m_image;
+}
+
+void
+MMReleaseMovableGPUImage (MovableGPUImage image)
+{
+	release_movable (image);
+}
+
+void
+MMSetMoveCallback (MovableGPUBuffer buffer, MMMoveCallback callback, void *user)
+{
+	buffer->m_callback = callback;
+	buffer->m_user = user;
+}
+
+void
+MMSetMoveCallback (MovableGPUImage image, MMMoveCallback callback, void *user)
+{
+	image->m_callback = callback;
+	image->m_user = user;
+}
+
+/**
+ * Defragmentation state. The movable pools are defragmented one after the
+ * other, and at most one pass is in flight. A pass is begun by MMNextFrame,
+ * which records copies of the moved resources and submits them ahead of the
+ * frame. The old buffers and images are destroyed and the pass is ended
+ * CPU_RENDER_AHEAD frames later, when no frame can use them anymore.
+ */
+static VmaDefragmentationInfo defrag_info {};
+static uint32_t defrag_next_pool = VK_MAX_MEMORY_TYPES;
+static VmaDefragmentationContext defrag_context = VK_NULL_HANDLE;
+static VmaDefragmentationPassMoveInfo defrag_pass {};
+static bool defrag_pass_pending = false;
+static size_t defrag_pass_age = 0;
+static TemporaryCommandBuffer *defrag_cmd = nullptr;
+static std::vector<VkBuffer> defrag_old_buffers;
+static std::vector<VkImage> defrag_old_images;
+static VmaDefragmentationStats defrag_stats;
+
+void
+MMStartDefragmentation (VkDeviceSize max_bytes_per_pass, uint32_t max_moves_per_pass)
+{
+	if (MMIsDefragmenting ())
+		return;
+
+	defrag_info = {};
+	defrag_info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+	defrag_info.maxBytesPerPass = max_bytes_per_pass;
+	defrag_info.maxAllocationsPerPass = max_moves_per_pass;
+	defrag_next_pool = 0;
+	defrag_stats = {};
+}
+
+bool
+MMIsDefragmenting (void)
+{
+	return defrag_next_pool < VK_MAX_MEMORY_TYPES || defrag_context != VK_NULL_HANDLE;
+}
+
+/**
+ * Begin defragmenting the next movable pool. Returns false if there are no
+ * more pools.
+ */
+static bool
+begin_defragmentation (void)
+{
+	for (; defrag_next_pool < VK_MAX_MEMORY_TYPES; defrag_next_pool++) {
+		if (movable_pools[defrag_next_pool] == VK_NULL_HANDLE)
+			continue;
+
+		defrag_info.pool = movable_pools[defrag_next_pool];
+		VkResult result = ::vmaBeginDefragmentation (gAllocator, &defrag_info, &defrag_context);
+		if (result != VK_SUCCESS) {
+			LGE_LOG_WARNING ("vmaBeginDefragmentation returned %s", VulkanTypeToString (result));
+			continue;
+		}
+
+		defrag_next_pool++;
+		return true;
+	}
+
+	Log ("Defragmentation moved %u allocations (%llu KiB) and freed %u blocks (%llu KiB)",
+		defrag_stats.allocationsMoved, (unsigned long long) (defrag_stats.bytesMoved >> 10),
+		defrag_stats.deviceMemoryBlocksFreed, (unsigned long long) (defrag_stats.bytesFreed >> 10));
+	return false;
+}
+
+static void
+end_defragmentation (void)
+{
+	VmaDefragmentationStats stats;
+	::vmaEndDefragmentation (gAllocator, defrag_context, &stats);
+	defrag_context = VK_NULL_HANDLE;
+
+	defrag_stats.allocationsMoved += stats.allocationsMoved;
+	defrag_stats.bytesMoved += stats.bytesMoved;
+	defrag_stats.deviceMemoryBlocksFreed += stats.deviceMemoryBlocksFreed;
+	defrag_stats.bytesFreed += stats.bytesFreed;
+}
+
+/**
+ * Record the copy of a movable buffer to the memory of dst.
+ */
+static bool
+move_buffer (VkCommandBuffer cmd, MovableGPUBuffer_T *buffer, VmaAllocation dst)
+{
+	VkBuffer new_buffer;
+	VkResult result = ::vkCreateBuffer (gVkDevice, &buffer->m_ci, nullptr, &new_buffer);
+	if (result != VK_SUCCESS) {
+		LGE_LOG_WARNING ("vkCreateBuffer returned %s", VulkanTypeToString (result));
+		return false;
+	}
+
+	result = ::vmaBindBufferMemory (gAllocator, dst, new_buffer);
+	if (result != VK_SUCCESS) {
+		LGE_LOG_WARNING ("vmaBindBufferMemory returned %s", VulkanTypeToString (result));
+		::vkDestroyBuffer (gVkDevice, new_buffer, nullptr);
+		return false;
+	}
+
+	VkBufferCopy copy {};
+	copy.size = buffer->m_ci.size;
+	::vkCmdCopyBuffer (cmd, buffer->m_buffer, new_buffer, 1, &copy);
+
+	defrag_old_buffers.push_back (buffer->m_buffer);
+	buffer->m_buffer = new_buffer;
+	return true;
+}
+
+/**
+ * Record the copy of a movable image to the memory of dst. All mip levels and
+ * array layers are copied, and the new image is left in
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+ */
+static bool
+move_image (VkCommandBuffer cmd, MovableGPUImage_T *image, VmaAllocation dst)
+{
+	const VkImageCreateInfo &ci = image->m_ci;
+
+	VkImage new_image;
+	VkResult result = ::vkCreateImage (gVkDevice, &ci, nullptr, &new_image);
+	if (result != VK_SUCCESS) {
+		LGE_LOG_WARNING ("vkCreateImage returned %s", VulkanTypeToString (result));
+		return false;
+	}
+
+	result = ::vmaBindImageMemory (gAllocator, dst, new_image);
+	if (result != VK_SUCCESS) {
+		LGE_LOG_WARNING ("vmaBindImageMemory returned %s", VulkanTypeToString (result));
+		::vkDestroyImage (gVkDevice, new_image, nullptr);
+		return false;
+	}
+
+	VkImageMemoryBarrier barriers[2] {};
+	for (VkImageMemoryBarrier &b : barriers) {
+		b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		b.subresourceRange.levelCount = ci.mipLevels;
+		b.subresourceRange.layerCount = ci.arrayLayers;
+	}
+
+	barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[0].image = image->m_image;
+	barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].image = new_image;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		2, barriers);
+
+	std::vector<VkImageCopy> regions (ci.mipLevels);
+	for (uint32_t level = 0; level < ci.mipLevels; level++) {
+		VkImageCopy &region = regions[level];
+		region = {};
+		region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.srcSubresource.mipLevel = level;
+		region.srcSubresource.layerCount = ci.arrayLayers;
+		region.dstSubresource = region.srcSubresource;
+		region.extent = level_extent (ci.extent, level);
+	}
+
+	vkCmdCopyImage (cmd, image->m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		new_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		ci.mipLevels, regions.data ());
+
+	barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barriers[1]);
+
+	defrag_old_images.push_back (image->m_image);
+	image->m_image = new_image;
+	return true;
+}
+
+/**
+ * Begin a defragmentation pass, and submit the copies of the resources that
+ * it moves. Returns false if there was nothing left to move.
+ */
+static bool
+begin_defragmentation_pass (void)
+{
+	LGE_TRACE_SCOPE ("MMDefragmentationPass");
+
+	VkResult result = ::vmaBeginDefragmentationPass (gAllocator, defrag_context, &defrag_pass);
+	if (result != VK_INCOMPLETE) {
+		if (result != VK_SUCCESS)
+			LGE_LOG_WARNING ("vmaBeginDefragmentationPass returned %s", VulkanTypeToString (result));
+		end_defragmentation ();
+		return false;
+	}
+
+	defrag_cmd = new TemporaryCommandBuffer;
+	VkCommandBuffer cmd = defrag_cmd->create ();
+
+	// Earlier frames might still be writing to the resources.
+	VkMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr);
+
+	std::vector<MovableResource *> moved;
+	for (uint32_t i = 0; i < defrag_pass.moveCount; i++) {
+		VmaDefragmentationMove &move = defrag_pass.pMoves[i];
+
+		VmaAllocationInfo info;
+		::vmaGetAllocationInfo (gAllocator, move.srcAllocation, &info);
+		MovableResource *res = (MovableResource *) info.pUserData;
+
+		// Released resources must not be destroyed before the pass has
+		// ended, but there is no point in moving them.
+		res->m_moving = true;
+		if (res->m_released) {
+			move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+			continue;
+		}
+
+		bool ok = res->m_isImage
+			? move_image (cmd, static_cast<MovableGPUImage_T *> (res), move.dstTmpAllocation)
+			: move_buffer (cmd, static_cast<MovableGPUBuffer_T *> (res), move.dstTmpAllocation);
+		if (!ok) {
+			move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+			continue;
+		}
+
+		moved.push_back (res);
+		StatAdd (STAT_DEFRAG_MOVES);
+		StatAdd (STAT_DEFRAG_BYTES, info.size);
+	}
+
+	// Make the copies visible to the frames that follow.
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr);
+
+	// The frame fence that MMNextFrame waits for CPU_RENDER_AHEAD frames
+	// from now also covers this submission.
+	defrag_cmd->submit (false);
+	defrag_pass_pending = true;
+	defrag_pass_age = 0;
+
+	for (MovableResource *res : moved)
+		if (res->m_callback)
+			res->m_callback (res->m_user);
+
+	return true;
+}
+
+/**
+ * End the pending defragmentation pass. The GPU must be done with the old
+ * buffers and images.
+ */
+static void
+end_defragmentation_pass (void)
+{
+	for (VkBuffer buffer : defrag_old_buffers)
+		::vkDestroyBuffer (gVkDevice, buffer, nullptr);
+	for (VkImage image : defrag_old_images)
+		::vkDestroyImage (gVkDevice, image, nullptr);
+	defrag_old_buffers.clear ();
+	defrag_old_images.clear ();
+
+	delete defrag_cmd;
+	defrag_cmd = nullptr;
+
+	for (uint32_t i = 0; i < defrag_pass.moveCount; i++) {
+		VmaAllocationInfo info;
+		::vmaGetAllocationInfo (gAllocator, defrag_pass.pMoves[i].srcAllocation, &info);
+		((MovableResource *) info.pUserData)->m_moving = false;
+	}
+
+	defrag_pass_pending = false;
+	VkResult result = ::vmaEndDefragmentationPass (gAllocator, defrag_context, &defrag_pass);
+	if (result != VK_INCOMPLETE) {
+		if (result != VK_SUCCESS)
+			LGE_LOG_WARNING ("vmaEndDefragmentationPass returned %s", VulkanTypeToString (result));
+		end_defragmentation ();
+	}
+}
+
+static void
+defragmentation_next_frame (void)
+{
+	if (!MMIsDefragmenting ())
+		return;
+
+	if (defrag_pass_pending && ++defrag_pass_age >= CPU_RENDER_AHEAD)
+		end_defragmentation_pass ();
+
+	while (!defrag_pass_pending) {
+		if (defrag_context == VK_NULL_HANDLE && !begin_defragmentation ())
+			break;
+
+		if (begin_defragmentation_pass ())
+			break;
+	}
+}
+
+static void
+stop_defragmentation (void)
+{
+	if (defrag_pass_pending) {
+		::vkDeviceWaitIdle (gVkDevice);
+		end_defragmentation_pass ();
+	}
+
+	if (defrag_context != VK_NULL_HANDLE)
+		end_defragmentation ();
+
+	defrag_next_pool = VK_MAX_MEMORY_TYPES;
+}
+
+void
+MMGetStats (MMStats &stats)
+{
+	const VkPhysicalDeviceMemoryProperties *props;
+	::vmaGetMemoryProperties (gAllocator, &props);
+
+	VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+	::vmaGetHeapBudgets (gAllocator, budgets);
+
+	stats.m_hasMemoryBudget = has_memory_budget;
+	stats.m_numHeaps = props->memoryHeapCount;
+	for (uint32_t i = 0; i < props->memoryHeapCount; i++) {
+		const VmaStatistics &s = budgets[i].statistics;
+		MMHeapStats &heap = stats.m_heaps[i];
+		heap.m_flags = props->memoryHeaps[i].flags;
+		heap.m_size = props->memoryHeaps[i].size;
+		heap.m_usage = budgets[i].usage;
+		heap.m_budget = budgets[i].budget;
+		heap.m_blockCount = s.blockCount;
+		heap.m_blockBytes = s.blockBytes;
+		heap.m_allocationCount = s.allocationCount;
+		heap.m_allocationBytes = s.allocationBytes;
+		heap.m_fragmentation = s.blockBytes
+			? (float) (s.blockBytes - s.allocationBytes) / (float) s.blockBytes
+			: 0.0f;
+	}
+}
+
+void
+MMSetOverBudgetCallback (MMOverBudgetCallback callback, void *user, float threshold)
+{
+	over_budget_callback = callback;
+	over_budget_user = user;
+	over_budget_threshold = threshold;
+}
+
+void
+MMSetOverBudgetPolicy (MMOverBudgetPolicy policy)
+{
+	over_budget_policy = policy;
+}
+
+/**
+ * Warn when a heap goes over its budget, and call the over-budget callback
+ * for every heap that is above the threshold.
+ */
+static void
+check_budgets (void)
+{
+	MMStats stats;
+	MMGetStats (stats);
+
+	for (uint32_t i = 0; i < stats.m_numHeaps; i++) {
+		const MMHeapStats &heap = stats.m_heaps[i];
+		uint32_t bit = 1u << i;
+
+		if (heap.m_usage > heap.m_budget) {
+			if (!(over_budget_heaps & bit))
+				LGE_LOG_WARNING ("memory heap %u is over budget (%llu of %llu MiB)", i,
+					(unsigned long long) (heap.m_usage >> 20),
+					(unsigned long long) (heap.m_budget >> 20));
+			over_budget_heaps |= bit;
+		} else {
+			over_budget_heaps &= ~bit;
+		}
+
+		if (over_budget_callback
+				&& (double) heap.m_usage > over_budget_threshold * (double) heap.m_budget)
+			over_budget_callback (stats, i, over_budget_user);
+	}
+}
+
 void
 MMNextFrame (void)
 {
 	DescriptorNextFrame ();
 
+	// This lets VMA fetch new budgets from the driver.
+	::vmaSetCurrentFrameIndex (gAllocator, (uint32_t) ++frame_index);
+	check_budgets ();
+	defragmentation_next_frame ();
+
 	stash_index++;
 	if (stash_index >= CPU_RENDER_AHEAD)
 		stash_index = 0;
@@ -393,6 +1989,20 @@ MMNextFrame (void)
 	for (GPUBuffer &b : stash[stash_index])
 		MMDestroyGPUBuffer (b);
 	stash[stash_index].clear ();
+
+	// Resources that are being moved are kept until the pass has ended.
+	std::vector<MovableResource *> &released = movable_stash[stash_index];
+	auto kept = std::partition (released.begin (), released.end (),
+		[] (MovableResource *res) { return res->m_moving; });
+	for (auto it = kept; it != released.end (); ++it)
+		destroy_movable (*it);
+	released.erase (kept, released.end ());
+}
+
+uint64_t
+MMGetFrameIndex (void)
+{
+	return frame_index;
 }
 
 }
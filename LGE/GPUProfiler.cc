@@ -0,0 +1,377 @@
+/**
+ * GPU profiling using timestamp queries.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEGPUProfiler"
+
+#include <LGE/Application.h>
+#include <LGE/DebugUI.h>
+#include <LGE/GPUProfiler.h>
+#include <LGE/Log.h>
+#include <LGE/Trace.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <stdexcept>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace LGE {
+
+static constexpr uint32_t MAX_SCOPES_PER_FRAME = 256;
+
+struct ProfilerScope {
+	const char *name;
+	uint32_t depth;
+	uint32_t begin_query;
+	uint32_t end_query;
+	uint32_t statistics_query;
+
+	/** CPU time at which recording of the scope began and ended. */
+	uint64_t cpu_begin, cpu_end;
+};
+
+struct ProfilerFrame {
+	VkQueryPool m_timestamps = VK_NULL_HANDLE;
+	VkQueryPool m_statistics = VK_NULL_HANDLE;
+	std::vector<ProfilerScope> m_scopes;
+	uint32_t m_numTimestamps = 0;
+	uint32_t m_numStatistics = 0;
+	uint64_t m_frameNumber = 0;
+	uint64_t m_submitTime = 0;
+};
+
+static bool supported = false;
+static bool statistics_supported = false;
+static bool statistics_enabled = false;
+static double timestamp_period;
+static uint64_t timestamp_mask;
+
+static ProfilerFrame frames[CPU_RENDER_AHEAD];
+static size_t frame_index = 0;
+static uint64_t frame_number = 0;
+static ProfilerFrame *current = nullptr;
+
+/** Indices into current->m_scopes of the open scopes. */
+static std::vector<uint32_t> scope_stack;
+
+static std::vector<GPUProfilerScope> results;
+static uint64_t results_frame = 0;
+
+static constexpr VkQueryPipelineStatisticFlags statistic_flags =
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+	| VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+	| VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT
+	| VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+void
+GPUProfilerInit (void)
+{
+	VkPhysicalDeviceProperties props;
+	::vkGetPhysicalDeviceProperties (gVkPhysicalDevice, &props);
+
+	uint32_t count;
+	::vkGetPhysicalDeviceQueueFamilyProperties (gVkPhysicalDevice, &count, nullptr);
+
+	std::vector<VkQueueFamilyProperties> queues (count);
+	::vkGetPhysicalDeviceQueueFamilyProperties (gVkPhysicalDevice, &count, queues.data ());
+
+	uint32_t valid_bits = queues[gVkQueueFamily].timestampValidBits;
+	if (!valid_bits || props.limits.timestampPeriod == 0.0f) {
+		Log ("Timestamp queries are not supported; GPU profiling is disabled");
+		return;
+	}
+
+	timestamp_period = props.limits.timestampPeriod;
+	timestamp_mask = (valid_bits >= 64) ? UINT64_MAX : ((uint64_t) 1 << valid_bits) - 1;
+	statistics_supported = gVkFeatures10.pipelineStatisticsQuery;
+
+	for (ProfilerFrame &frame : frames) {
+		VkQueryPoolCreateInfo pool_ci {};
+		pool_ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		pool_ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		pool_ci.queryCount = 2 * MAX_SCOPES_PER_FRAME;
+
+		VkResult result = ::vkCreateQueryPool (gVkDevice, &pool_ci, nullptr, &frame.m_timestamps);
+		if (result != VK_SUCCESS) {
+			GPUProfilerTerminate ();
+			throw std::runtime_error (std::string ("vkCreateQueryPool returned ") + VulkanTypeToString (result));
+		}
+
+		if (!statistics_supported)
+			continue;
+
+		pool_ci.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		pool_ci.queryCount = MAX_SCOPES_PER_FRAME;
+		pool_ci.pipelineStatistics = statistic_flags;
+
+		result = ::vkCreateQueryPool (gVkDevice, &pool_ci, nullptr, &frame.m_statistics);
+		if (result != VK_SUCCESS) {
+			GPUProfilerTerminate ();
+			throw std::runtime_error (std::string ("vkCreateQueryPool returned ") + VulkanTypeToString (result));
+		}
+	}
+
+	supported = true;
+}
+
+void
+GPUProfilerTerminate (void)
+{
+	for (ProfilerFrame &frame : frames) {
+		if (frame.m_timestamps != VK_NULL_HANDLE)
+			::vkDestroyQueryPool (gVkDevice, frame.m_timestamps, nullptr);
+		if (frame.m_statistics != VK_NULL_HANDLE)
+			::vkDestroyQueryPool (gVkDevice, frame.m_statistics, nullptr);
+		frame = ProfilerFrame ();
+	}
+
+	supported = false;
+	current = nullptr;
+	scope_stack.clear ();
+	results.clear ();
+	results_frame = 0;
+}
+
+void
+GPUProfilerEnablePipelineStatistics (bool enable)
+{
+	statistics_enabled = enable;
+}
+
+/**
+ * Read back the query results of a frame. The VkFence of the frame has been
+ * waited on, so the results should be available. If they are not, we drop
+ * them instead of stalling.
+ */
+static void
+resolve_frame (ProfilerFrame &frame)
+{
+	if (!frame.m_numTimestamps)
+		return;
+
+	uint64_t timestamps[2 * MAX_SCOPES_PER_FRAME];
+	VkResult result = ::vkGetQueryPoolResults (gVkDevice, frame.m_timestamps,
+		0, frame.m_numTimestamps, sizeof (timestamps), timestamps,
+		sizeof (uint64_t), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS) {
+		if (result != VK_NOT_READY)
+			LGE_LOG_WARNING ("vkGetQueryPoolResults returned %s", VulkanTypeToString (result));
+		return;
+	}
+
+	uint64_t statistics[MAX_SCOPES_PER_FRAME][NUM_GPU_STATS];
+	bool have_statistics = false;
+	if (frame.m_numStatistics) {
+		result = ::vkGetQueryPoolResults (gVkDevice, frame.m_statistics,
+			0, frame.m_numStatistics, sizeof (statistics), statistics,
+			sizeof (statistics[0]), VK_QUERY_RESULT_64_BIT);
+		have_statistics = result == VK_SUCCESS;
+	}
+
+	results.clear ();
+	results_frame = frame.m_frameNumber;
+
+	uint64_t frame_begin = timestamps[frame.m_scopes[0].begin_query] & timestamp_mask;
+	TraceGPUFrame (frame.m_submitTime, (uint64_t) (timestamp_period * frame_begin));
+	for (const ProfilerScope &scope : frame.m_scopes) {
+		if (scope.end_query == UINT32_MAX)
+			continue;
+
+		uint64_t begin = timestamps[scope.begin_query] & timestamp_mask;
+		uint64_t end = timestamps[scope.end_query] & timestamp_mask;
+
+		GPUProfilerScope r {};
+		r.name = scope.name;
+		r.depth = scope.depth;
+		r.start = 1.0e-6 * timestamp_period * ((begin - frame_begin) & timestamp_mask);
+		r.duration = 1.0e-6 * timestamp_period * ((end - begin) & timestamp_mask);
+		r.begin_ns = (uint64_t) (timestamp_period * begin);
+		r.end_ns = (uint64_t) (timestamp_period * end);
+		r.cpu_duration = 1.0e-6 * (double) (scope.cpu_end - scope.cpu_begin);
+
+		if (have_statistics && scope.statistics_query != UINT32_MAX) {
+			r.has_statistics = true;
+			for (int i = 0; i < NUM_GPU_STATS; i++)
+				r.statistics[i] = statistics[scope.statistics_query][i];
+		}
+
+		results.push_back (r);
+		TraceGPUEvent (r.name, r.depth, r.begin_ns, r.end_ns);
+	}
+}
+
+void
+GPUProfilerNextFrame (VkCommandBuffer cmd)
+{
+	frame_number++;
+	if (!supported)
+		return;
+
+	frame_index++;
+	if (frame_index >= CPU_RENDER_AHEAD)
+		frame_index = 0;
+
+	current = &frames[frame_index];
+	resolve_frame (*current);
+
+	current->m_scopes.clear ();
+	current->m_numTimestamps = 0;
+	current->m_numStatistics = 0;
+	current->m_frameNumber = frame_number;
+	scope_stack.clear ();
+
+	::vkCmdResetQueryPool (cmd, current->m_timestamps, 0, 2 * MAX_SCOPES_PER_FRAME);
+	if (current->m_statistics != VK_NULL_HANDLE)
+		::vkCmdResetQueryPool (cmd, current->m_statistics, 0, MAX_SCOPES_PER_FRAME);
+
+	ProfileScopeBegin (cmd, "Frame");
+}
+
+void
+GPUProfilerEndFrame (VkCommandBuffer cmd)
+{
+	if (!current)
+		return;
+
+	if (scope_stack.size () > 1)
+		LGE_LOG_WARNING ("%zu GPU profiling scopes were not ended", scope_stack.size () - 1);
+
+	while (!scope_stack.empty ())
+		ProfileScopeEnd (cmd);
+
+	current->m_submitTime = TraceNow ();
+	current = nullptr;
+}
+
+void
+ProfileScopeBegin (VkCommandBuffer cmd, const char *name)
+{
+	if (!current)
+		return;
+
+	if (current->m_scopes.size () >= MAX_SCOPES_PER_FRAME) {
+		// Push a dummy entry so that ProfileScopeEnd stays balanced.
+		scope_stack.push_back (UINT32_MAX);
+		return;
+	}
+
+	ProfilerScope scope;
+	scope.name = name;
+	scope.depth = scope_stack.size ();
+	scope.begin_query = current->m_numTimestamps++;
+	scope.end_query = UINT32_MAX;
+	scope.statistics_query = UINT32_MAX;
+	scope.cpu_begin = TraceNow ();
+	scope.cpu_end = scope.cpu_begin;
+
+	::vkCmdWriteTimestamp (cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		current->m_timestamps, scope.begin_query);
+
+	if (statistics_enabled && current->m_statistics != VK_NULL_HANDLE && scope.depth == 1) {
+		scope.statistics_query = current->m_numStatistics++;
+		::vkCmdBeginQuery (cmd, current->m_statistics, scope.statistics_query, 0);
+	}
+
+	scope_stack.push_back (current->m_scopes.size ());
+	current->m_scopes.push_back (scope);
+}
+
+void
+ProfileScopeEnd (VkCommandBuffer cmd)
+{
+	if (!current || scope_stack.empty ())
+		return;
+
+	uint32_t index = scope_stack.back ();
+	scope_stack.pop_back ();
+	if (index == UINT32_MAX)
+		return;
+
+	ProfilerScope &scope = current->m_scopes[index];
+	if (scope.statistics_query != UINT32_MAX)
+		::vkCmdEndQuery (cmd, current->m_statistics, scope.statistics_query);
+
+	scope.end_query = current->m_numTimestamps++;
+	::vkCmdWriteTimestamp (cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		current->m_timestamps, scope.end_query);
+	scope.cpu_end = TraceNow ();
+}
+
+uint64_t
+GPUProfilerGetResults (const GPUProfilerScope **scopes, size_t *count)
+{
+	*scopes = results.data ();
+	*count = results.size ();
+	return results_frame;
+}
+
+uint64_t
+GPUProfilerGetFrameNumber (void)
+{
+	return frame_number;
+}
+
+void
+GPUProfilerDrawDebugUI (int x, int y, DebugUICorner corner)
+{
+	int line_height = DebugUIGetLineHeight ();
+
+	if (!supported) {
+		DebugUIDrawText ("GPU profiling is not supported", x, y, corner,
+			1.0f, 1.0f, 0.0f, 1.0f);
+		return;
+	}
+
+	for (const GPUProfilerScope &scope : results) {
+		if (scope.has_statistics)
+			DebugUIPrintf (x, y, corner, 0.0f, 1.0f, 1.0f, 1.0f,
+				"%*s%s: %.3f ms  (%llu prims, %llu vs, %llu fs, %llu cs)",
+				2 * (int) scope.depth, "", scope.name, scope.duration,
+				(unsigned long long) scope.statistics[GPU_STAT_INPUT_ASSEMBLY_PRIMITIVES],
+				(unsigned long long) scope.statistics[GPU_STAT_VERTEX_SHADER_INVOCATIONS],
+				(unsigned long long) scope.statistics[GPU_STAT_FRAGMENT_SHADER_INVOCATIONS],
+				(unsigned long long) scope.statistics[GPU_STAT_COMPUTE_SHADER_INVOCATIONS]);
+		else
+			DebugUIPrintf (x, y, corner, 0.0f, 1.0f, 1.0f, 1.0f,
+				"%*s%s: %.3f ms", 2 * (int) scope.depth, "",
+				scope.name, scope.duration);
+
+		if (corner == DebugUICorner::BOTTOM_LEFT || corner == DebugUICorner::BOTTOM_RIGHT)
+			y -= line_height;
+		else
+			y += line_height;
+	}
+}
+
+bool
+GPUProfilerWriteTrace (const char *path)
+{
+	FILE *f = ::fopen (path, "w");
+	if (!f) {
+		Log ("Failed to open %s for writing", path);
+		return false;
+	}
+
+	::fprintf (f, "{\"traceEvents\":[\n");
+	for (size_t i = 0; i < results.size (); i++) {
+		const GPUProfilerScope &scope = results[i];
+		::fprintf (f, "{\"name\":");
+		TraceWriteJSONString (f, scope.name);
+		::fprintf (f, ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}%s\n",
+			1000.0 * scope.start, 1000.0 * scope.duration,
+			(unsigned long long) results_frame,
+			(i + 1 < results.size ()) ? "," : "");
+	}
+	::fprintf (f, "],\"displayTimeUnit\":\"ms\"}\n");
+
+	bool ok = !::ferror (f);
+	if (::fclose (f) != 0)
+		ok = false;
+
+	if (!ok)
+		Log ("Failed to write trace to %s", path);
+	return ok;
+}
+
+}
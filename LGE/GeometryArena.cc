@@ -0,0 +1,207 @@
+/**
+ * Geometry arena.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEGeometryArena"
+
+#include <LGE/Application.h>
+#include <LGE/GeometryArena.h>
+#include <LGE/Log.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <stdexcept>
+
+#include "../vendor/vk_mem_alloc.h"
+
+namespace LGE {
+
+/**
+ * The virtual blocks count in elements, not bytes, so that allocation
+ * offsets are vertex and index numbers.
+ */
+static VmaVirtualBlock
+create_block (uint32_t size)
+{
+	VmaVirtualBlockCreateInfo block_ci {};
+	block_ci.size = size;
+
+	VmaVirtualBlock block;
+	VkResult result = ::vmaCreateVirtualBlock (&block_ci, &block);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error (std::string ("vmaCreateVirtualBlock returned ") + VulkanTypeToString (result));
+
+	return block;
+}
+
+static bool
+allocate_elements (VmaVirtualBlock block, uint32_t count, VmaVirtualAllocation *alloc,
+	uint32_t *first)
+{
+	VmaVirtualAllocationCreateInfo alloc_ci {};
+	alloc_ci.size = count;
+
+	VkDeviceSize offset;
+	if (::vmaVirtualAllocate (block, &alloc_ci, alloc, &offset) != VK_SUCCESS)
+		return false;
+
+	*first = (uint32_t) offset;
+	return true;
+}
+
+GeometryArena::GeometryArena (uint32_t vertex_stride, uint32_t max_vertices,
+	uint32_t max_indices, VkIndexType index_type, VkBufferUsageFlags usage)
+	: m_vertexStride (vertex_stride), m_indexType (index_type)
+{
+	if (index_type == VK_INDEX_TYPE_UINT16)
+		m_indexSize = 2;
+	else if (index_type == VK_INDEX_TYPE_UINT32)
+		m_indexSize = 4;
+	else
+		throw std::runtime_error ("GeometryArena: unsupported index type");
+
+	usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+	try {
+		m_vertexBlock = create_block (max_vertices);
+		m_vertexBuffer = MMCreateMeshGPUBuffer (nullptr, (size_t) max_vertices * vertex_stride,
+			usage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+		if (max_indices) {
+			m_indexBlock = create_block (max_indices);
+			m_indexBuffer = MMCreateMeshGPUBuffer (nullptr, (size_t) max_indices * m_indexSize,
+				usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+		}
+	} catch (...) {
+		Destroy ();
+		throw;
+	}
+}
+
+GeometryArena::~GeometryArena (void)
+{
+	Destroy ();
+}
+
+void
+GeometryArena::Destroy (void)
+{
+	// The arena owns the memory of all ranges, so outstanding ranges
+	// simply disappear with it.
+	if (m_vertexBlock != VK_NULL_HANDLE) {
+		::vmaClearVirtualBlock (m_vertexBlock);
+		::vmaDestroyVirtualBlock (m_vertexBlock);
+	}
+	if (m_indexBlock != VK_NULL_HANDLE) {
+		::vmaClearVirtualBlock (m_indexBlock);
+		::vmaDestroyVirtualBlock (m_indexBlock);
+	}
+
+	if (m_vertexBuffer)
+		MMReleaseGPUBuffer (m_vertexBuffer);
+	if (m_indexBuffer)
+		MMReleaseGPUBuffer (m_indexBuffer);
+}
+
+void
+GeometryArena::FreeNow (GeometryRange &range)
+{
+	if (range.m_vertexAllocation != VK_NULL_HANDLE)
+		::vmaVirtualFree (m_vertexBlock, range.m_vertexAllocation);
+	if (range.m_indexAllocation != VK_NULL_HANDLE)
+		::vmaVirtualFree (m_indexBlock, range.m_indexAllocation);
+	range = {};
+}
+
+void
+GeometryArena::ReclaimPendingFrees (void)
+{
+	uint64_t frame = MMGetFrameIndex ();
+
+	size_t kept = 0;
+	for (PendingFree &pending : m_pendingFrees) {
+		if (frame >= pending.m_frame + CPU_RENDER_AHEAD)
+			FreeNow (pending.m_range);
+		else
+			m_pendingFrees[kept++] = pending;
+	}
+
+	m_pendingFrees.resize (kept);
+}
+
+bool
+GeometryArena::Allocate (const void *vertices, uint32_t vertex_count,
+	const void *indices, uint32_t index_count, GeometryRange &range)
+{
+	ReclaimPendingFrees ();
+
+	range = {};
+	if (!vertex_count || (index_count && m_indexBlock == VK_NULL_HANDLE))
+		return false;
+
+	if (!allocate_elements (m_vertexBlock, vertex_count,
+			&range.m_vertexAllocation, &range.m_firstVertex))
+		return false;
+
+	if (index_count && !allocate_elements (m_indexBlock, index_count,
+			&range.m_indexAllocation, &range.m_firstIndex)) {
+		FreeNow (range);
+		return false;
+	}
+
+	range.m_vertexCount = vertex_count;
+	range.m_indexCount = index_count;
+
+	try {
+		MMCopyToGPUBuffer (m_vertexBuffer, vertices, (size_t) vertex_count * m_vertexStride,
+			(size_t) range.m_firstVertex * m_vertexStride);
+		if (index_count)
+			MMCopyToGPUBuffer (m_indexBuffer, indices, (size_t) index_count * m_indexSize,
+				(size_t) range.m_firstIndex * m_indexSize);
+	} catch (...) {
+		FreeNow (range);
+		throw;
+	}
+
+	return true;
+}
+
+void
+GeometryArena::Free (GeometryRange &range)
+{
+	if (!range)
+		return;
+
+	try {
+		m_pendingFrees.push_back ({ range, MMGetFrameIndex () });
+	} catch (...) {
+		// Out of memory. Wait for the GPU instead.
+		::vkDeviceWaitIdle (gVkDevice);
+		FreeNow (range);
+		return;
+	}
+
+	range = {};
+}
+
+void
+GeometryArena::Bind (VkCommandBuffer cmd, uint32_t binding)
+{
+	VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers (cmd, binding, 1, &m_vertexBuffer.m_buffer, &offset);
+	if (m_indexBuffer)
+		vkCmdBindIndexBuffer (cmd, m_indexBuffer.m_buffer, 0, m_indexType);
+}
+
+void
+GeometryArena::Draw (VkCommandBuffer cmd, const GeometryRange &range,
+	uint32_t instance_count, uint32_t first_instance)
+{
+	if (range.m_indexCount)
+		vkCmdDrawIndexed (cmd, range.m_indexCount, instance_count,
+			range.m_firstIndex, (int32_t) range.m_firstVertex, first_instance);
+	else
+		vkCmdDraw (cmd, range.m_vertexCount, instance_count,
+			range.m_firstVertex, first_instance);
+}
+
+}
@@ -5,22 +5,41 @@
 #define LGE_MODULE "LGEInit"
 
 #include <LGE/Application.h>
+#include <LGE/AsyncIO.h>
 #include <LGE/DebugUI.h>
+#include <LGE/GPUDecompress.h>
+#include <LGE/GPUProfiler.h>
 #include <LGE/Init.h>
 #include <LGE/Log.h>
+#include <LGE/Pipeline.h>
+#include <LGE/PNG.h>
+#include <LGE/ProfilerOverlay.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/TextureStreaming.h>
+#include <LGE/Trace.h>
 #include <LGE/Vulkan.h>
 #include <LGE/Window.h>
 
 #include <VKFW/vkfw.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <stdexcept>
+#include <vector>
 
 namespace LGE {
 
 bool bIsProduction = false;
 int gExitCode = 0;
 
+bool bIsHeadless = false;
+uint64_t gFrameLimit = 0;
+double gTimeLimit = 0.0;
+
+static const char *readback_path = nullptr;
+static bool readback_checksum = false;
+
 static void
 run_event_loop (void);
 
@@ -37,32 +56,63 @@ event_handler (VKFWevent *e, void *user);
 int
 LGEMain (Application &app, const char *const *argv)
 {
+	const char *trace_path = nullptr;
+	uint32_t trace_frames = 120;
+	const char *log_binary_path = nullptr;
+
 	if (argv) {
 		// skip argv[0]
 		if (*argv)
 			argv++;
 
-		if (*argv) {
+		for (; *argv; argv++) {
 			if (!::strcmp (*argv, "prod"))
 				setup_opts_for_prod ();
+			else if (!::strcmp (*argv, "headless"))
+				bIsHeadless = true;
+			else if (!::strncmp (*argv, "frames=", 7))
+				gFrameLimit = ::strtoull (*argv + 7, nullptr, 10);
+			else if (!::strncmp (*argv, "seconds=", 8))
+				gTimeLimit = ::strtod (*argv + 8, nullptr);
+			else if (!::strncmp (*argv, "readback=", 9))
+				readback_path = *argv + 9;
+			else if (!::strcmp (*argv, "checksum"))
+				readback_checksum = true;
+			else if (!::strncmp (*argv, "trace=", 6))
+				trace_path = *argv + 6;
+			else if (!::strncmp (*argv, "trace-frames=", 13))
+				trace_frames = ::strtoul (*argv + 13, nullptr, 10);
+			else if (!::strncmp (*argv, "log-binary=", 11))
+				log_binary_path = *argv + 11;
+			else if (!::strcmp (*argv, "profiler-overlay"))
+				ProfilerOverlaySetVisible (true);
+			else
+				LGE_LOG_WARNING ("unrecognized argument \"%s\"", *argv);
 		}
 	}
 
+	if ((readback_path || readback_checksum) && !bIsHeadless)
+		LGE_LOG_WARNING ("readback and checksum are only supported in headless mode");
+
+	if (log_binary_path && !LogOpenBinary (log_binary_path))
+		LGE_LOG_WARNING ("failed to open %s for binary logging", log_binary_path);
+
 	gApplication = &app;
+	LogInit ();
 
-	Log ("Application is %s", app.GetUserFriendlyName ());
+	Log ("Application is %s%s", app.GetUserFriendlyName (), bIsHeadless ? " (headless)" : "");
 
 	if (!bIsProduction)
 		::vkfwEnableDebugLogging (VKFW_LOG_ALL);
 
 	if (::vkfwInit () != VK_SUCCESS) {
-		Log ("Failed to initialize VKFW");
+		LGE_LOG_ERROR ("Failed to initialize VKFW");
 		gExitCode = 1;
 		return gExitCode;
 	}
 
 	if (!InitializeVulkan ()) {
-		Log ("Failed to initialize Vulkan");
+		LGE_LOG_ERROR ("Failed to initialize Vulkan");
 		::vkfwTerminate ();
 		gExitCode = 1;
 		return gExitCode;
@@ -71,14 +121,18 @@ LGEMain (Application &app, const char *const *argv)
 	try {
 		gWindow = new Window;
 	} catch (const std::exception &e) {
-		Log ("Failed to create game window: %s", e.what ());
+		LGE_LOG_ERROR ("Failed to create game window: %s", e.what ());
 		TerminateVulkan ();
 		::vkfwTerminate ();
 		gExitCode = 1;
 		return gExitCode;
 	}
 
-	::vkfwSetEventHandler (event_handler, nullptr);
+	if (!bIsHeadless)
+		::vkfwSetEventHandler (event_handler, nullptr);
+
+	if (trace_path && trace_frames)
+		TraceCapture (trace_frames, trace_path);
 
 	// If we are in production, disable logging now.
 	Log ("Initialization was successful");
@@ -90,12 +144,17 @@ LGEMain (Application &app, const char *const *argv)
 		run_event_loop ();
 	} catch (const std::exception &e) {
 		bLoggingEnabled = true;
-		Log ("Caught an exception during the event loop: %s", e.what ());
+		LGE_LOG_ERROR ("Caught an exception during the event loop: %s", e.what ());
 		gExitCode = 1;
 	}
 
 	::vkDeviceWaitIdle (gVkDevice);
+	ShaderReloadTerminate ();
 	gApplication->Cleanup ();
+	TextureStreamingTerminate ();
+	AsyncIOTerminate ();
+	GPUDecompressTerminate ();
+	PipelineTerminate ();
 
 	delete gWindow;
 	gWindow = nullptr;
@@ -104,6 +163,7 @@ LGEMain (Application &app, const char *const *argv)
 	TerminateVulkan ();
 	::vkfwTerminate ();
 	Log ("Exit code is %d", gExitCode);
+	LogTerminate ();
 	return gExitCode;
 }
 
@@ -119,7 +179,7 @@ event_handler (VKFWevent *e, void *user)
 	} catch (const std::exception &e) {
 		event_handler_has_thrown = true;
 		bLoggingEnabled = true;
-		Log ("Caught an exception in an event handler: %s", e.what ());
+		LGE_LOG_ERROR ("Caught an exception in an event handler: %s", e.what ());
 	}
 }
 
@@ -136,23 +196,90 @@ struct InitializeSystem {
 	}
 };
 
+/**
+ * FNV-1a hash of the pixel data, used to compare headless output between runs
+ * without storing reference images.
+ */
+static uint64_t
+checksum (const void *data, size_t size)
+{
+	const uint8_t *p = (const uint8_t *) data;
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ull;
+	}
+
+	return h;
+}
+
+static void
+readback_last_frame (void)
+{
+	VkExtent2D extent = gWindow->GetSwapchainExtent ();
+	std::vector<uint8_t> pixels ((size_t) extent.width * extent.height * 4);
+	if (!gWindow->DownloadLastImage (pixels.data ())) {
+		LGE_LOG_WARNING ("no frame was rendered, so there is nothing to read back");
+		gExitCode = 1;
+		return;
+	}
+
+	if (readback_checksum) {
+		// Print this even in production, as scripts depend on it.
+		LogFlush ();
+		::printf ("checksum: %016llx\n", (unsigned long long) checksum (pixels.data (), pixels.size ()));
+	}
+
+	if (readback_path) {
+		if (WritePNG (readback_path, extent.width, extent.height, pixels.data ())) {
+			Log ("Wrote the last frame to %s", readback_path);
+		} else {
+			LGE_LOG_WARNING ("failed to write %s", readback_path);
+			gExitCode = 1;
+		}
+	}
+}
+
+static bool
+reached_limit (uint64_t frames, uint64_t start_time)
+{
+	if (gFrameLimit && frames >= gFrameLimit)
+		return true;
+
+	if (gTimeLimit > 0.0 && (double) (vkfwGetTime () - start_time) >= gTimeLimit * 1.0e6)
+		return true;
+
+	return false;
+}
+
 static void
 run_event_loop (void)
 {
 	VkResult result;
 	uint64_t prevFrameTime = vkfwGetTime ();
+	uint64_t startTime = prevFrameTime;
+	uint64_t frames = 0;
 
+	InitializeSystem<GPUProfilerInit, GPUProfilerTerminate> gpu_profiler;
 	InitializeSystem<DebugUIInit, DebugUITerminate> debug_ui;
 
-	while (gApplication->KeepRunning ()) {
-		if (gWindow && gWindow->IsVsyncSwapchain ())
-			result = ::vkfwDispatchEvents (VKFW_EVENT_MODE_POLL, 0);
-		else
-			result = ::vkfwDispatchEvents (VKFW_EVENT_MODE_DEADLINE, prevFrameTime + 16666);
+	TraceSetThreadName ("Main");
 
-		if (result != VK_SUCCESS) {
-			Log ("vkfwDispatchEvents returned %s", VulkanTypeToString (result));
-			throw std::runtime_error ("vkfwDispatchEvents failed");
+	while (gApplication->KeepRunning () && !reached_limit (frames, startTime)) {
+		TraceNextFrame ();
+
+		LGE_TRACE_SCOPE ("Frame");
+		if (!bIsHeadless) {
+			LGE_TRACE_SCOPE ("DispatchEvents");
+			if (gWindow && gWindow->IsVsyncSwapchain ())
+				result = ::vkfwDispatchEvents (VKFW_EVENT_MODE_POLL, 0);
+			else
+				result = ::vkfwDispatchEvents (VKFW_EVENT_MODE_DEADLINE, prevFrameTime + 16666);
+
+			if (result != VK_SUCCESS) {
+				Log ("vkfwDispatchEvents returned %s", VulkanTypeToString (result));
+				throw std::runtime_error ("vkfwDispatchEvents failed");
+			}
 		}
 
 		if (event_handler_has_thrown) {
@@ -161,11 +288,20 @@ run_event_loop (void)
 
 		prevFrameTime = vkfwGetTime ();
 		gApplication->Render ();
+		frames++;
 	}
 
 	result = ::vkDeviceWaitIdle (gVkDevice);
 	if (result != VK_SUCCESS)
-		Log ("warning: vkDeviceWaitIdle returned %s", VulkanTypeToString (result));
+		LGE_LOG_WARNING ("vkDeviceWaitIdle returned %s", VulkanTypeToString (result));
+
+	double elapsed = (double) (vkfwGetTime () - startTime) * 1.0e-6;
+	if (frames && elapsed > 0.0)
+		Log ("Rendered %llu frames in %.3f s (%.3f ms/frame)", (unsigned long long) frames,
+			elapsed, 1000.0 * elapsed / frames);
+
+	if (bIsHeadless && (readback_path || readback_checksum))
+		readback_last_frame ();
 }
 
 }
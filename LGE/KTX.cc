@@ -0,0 +1,184 @@
+/**
+ * KTX2 texture loader.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEKTX"
+
+#include <LGE/KTX.h>
+#include <LGE/Trace.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace LGE {
+
+static const uint8_t ktx2_identifier[12] = {
+	0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n'
+};
+
+/** The KTX2 header, including the index. All fields are little-endian. */
+struct KTX2Header {
+	uint8_t identifier[12];
+	uint32_t vkFormat;
+	uint32_t typeSize;
+	uint32_t pixelWidth;
+	uint32_t pixelHeight;
+	uint32_t pixelDepth;
+	uint32_t layerCount;
+	uint32_t faceCount;
+	uint32_t levelCount;
+	uint32_t supercompressionScheme;
+	uint32_t dfdByteOffset;
+	uint32_t dfdByteLength;
+	uint32_t kvdByteOffset;
+	uint32_t kvdByteLength;
+	uint64_t sgdByteOffset;
+	uint64_t sgdByteLength;
+};
+
+static_assert (sizeof (KTX2Header) == 80);
+
+static_assert (sizeof (KTX2Level) == 24);
+
+[[noreturn]] static void
+fail (const char *name, const char *what)
+{
+	throw std::runtime_error (std::string ("LoadKTX2: ") + name + ": " + what);
+}
+
+void
+ReadKTX2Info (const void *data, size_t size, uint64_t file_size, const char *name,
+	KTX2Info &info)
+{
+	// KTX2 is little-endian, like every platform that we run on, so the
+	// header is read as it is.
+	KTX2Header header;
+	if (size < sizeof (header))
+		fail (name, "file is too small");
+	::memcpy (&header, data, sizeof (header));
+
+	if (::memcmp (header.identifier, ktx2_identifier, sizeof (ktx2_identifier)))
+		fail (name, "not a KTX2 file");
+	if (header.supercompressionScheme != 0)
+		fail (name, "supercompressed files are not supported");
+	if (header.vkFormat == VK_FORMAT_UNDEFINED)
+		fail (name, "files without a Vulkan format are not supported");
+	if (!header.pixelWidth || !header.pixelHeight || header.pixelDepth)
+		fail (name, "only 2D textures are supported");
+	if (header.faceCount != 1 && header.faceCount != 6)
+		fail (name, "invalid face count");
+
+	info.m_format = (VkFormat) header.vkFormat;
+	info.m_extent = { header.pixelWidth, header.pixelHeight };
+	VkExtent3D extent = { header.pixelWidth, header.pixelHeight, 1 };
+
+	// Cube map faces are array layers to Vulkan.
+	info.m_layers = (header.layerCount ? header.layerCount : 1) * header.faceCount;
+	if (info.m_layers > 2048)
+		fail (name, "too many array layers");
+	info.m_flags = (header.faceCount == 6) ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+
+	// A level count of 0 asks for the mip chain to be generated.
+	info.m_generateMipmaps = !header.levelCount;
+	uint32_t num_levels = info.m_generateMipmaps ? 1 : header.levelCount;
+	if (num_levels > MMGetMipLevelCount (extent))
+		fail (name, "too many mip levels");
+
+	if ((size - sizeof (header)) / sizeof (KTX2Level) < num_levels)
+		fail (name, "truncated level index");
+
+	info.m_levels.resize (num_levels);
+	::memcpy (info.m_levels.data (), (const uint8_t *) data + sizeof (header),
+		num_levels * sizeof (KTX2Level));
+
+	for (uint32_t i = 0; i < num_levels; i++) {
+		const KTX2Level &level = info.m_levels[i];
+		VkDeviceSize level_size = MMGetMipLevelSize (info.m_format, extent, i);
+		if (level.byteLength != level_size * info.m_layers)
+			fail (name, "mip level size does not match the format");
+		if (level.byteOffset > file_size || level.byteLength > file_size - level.byteOffset)
+			fail (name, "mip level is outside of the file");
+	}
+}
+
+static GPUImage
+upload_levels (const KTX2Info &info, const uint8_t *data)
+{
+	uint32_t num_levels = (uint32_t) info.m_levels.size ();
+	VkExtent3D extent = { info.m_extent.width, info.m_extent.height, 1 };
+
+	// Every level holds all layers and faces of that level. The upload
+	// wants the levels of every layer together, largest first.
+	VkDeviceSize layer_size = 0;
+	for (uint32_t i = 0; i < num_levels; i++)
+		layer_size += MMGetMipLevelSize (info.m_format, extent, i);
+
+	std::vector<uint8_t> pixels (layer_size * info.m_layers);
+	std::vector<const void *> layers (info.m_layers);
+	for (uint32_t layer = 0; layer < info.m_layers; layer++) {
+		size_t offset = layer * layer_size;
+		layers[layer] = &pixels[offset];
+
+		for (uint32_t i = 0; i < num_levels; i++) {
+			VkDeviceSize level_size = MMGetMipLevelSize (info.m_format, extent, i);
+			::memcpy (&pixels[offset],
+				data + info.m_levels[i].byteOffset + layer * level_size, level_size);
+			offset += level_size;
+		}
+	}
+
+	return MMUploadTexture2DArray (info.m_format, { extent.width, extent.height },
+		info.m_layers, layers.data (), num_levels, info.m_generateMipmaps, info.m_flags);
+}
+
+static GPUImage
+load_ktx2 (const uint8_t *data, size_t size, const char *name)
+{
+	LGE_TRACE_SCOPE ("LoadKTX2");
+
+	KTX2Info info;
+	ReadKTX2Info (data, size, size, name, info);
+	return upload_levels (info, data);
+}
+
+GPUImage
+LoadKTX2 (const void *data, size_t size)
+{
+	return load_ktx2 ((const uint8_t *) data, size, "<memory>");
+}
+
+GPUImage
+LoadKTX2 (const char *path)
+{
+	FILE *f = ::fopen (path, "rb");
+	if (!f)
+		fail (path, "cannot open file");
+
+	std::vector<uint8_t> data;
+	long size = -1;
+	if (!::fseek (f, 0, SEEK_END))
+		size = ::ftell (f);
+
+	bool ok = size >= 0 && !::fseek (f, 0, SEEK_SET);
+	if (ok) {
+		try {
+			data.resize ((size_t) size);
+		} catch (...) {
+			::fclose (f);
+			throw;
+		}
+		ok = ::fread (data.data (), 1, data.size (), f) == data.size ();
+	}
+
+	::fclose (f);
+	if (!ok)
+		fail (path, "cannot read file");
+
+	return load_ktx2 (data.data (), data.size (), path);
+}
+
+}
@@ -0,0 +1,169 @@
+/**
+ * LZ compression for asset packs.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGELZ"
+
+#include <LGE/LZ.h>
+
+#include <string.h>
+
+namespace LGE {
+
+static constexpr unsigned HASH_BITS = 14;
+
+static inline uint32_t
+read32 (const uint8_t *p)
+{
+	uint32_t value;
+	::memcpy (&value, p, sizeof (value));
+	return value;
+}
+
+static inline uint32_t
+hash32 (uint32_t value)
+{
+	return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static uint8_t *
+write_count (uint8_t *out, size_t count)
+{
+	for (count -= 15; count >= 255; count -= 255)
+		*out++ = 255;
+
+	*out++ = (uint8_t) count;
+	return out;
+}
+
+static uint8_t *
+write_sequence (uint8_t *out, const uint8_t *literals, size_t num_literals,
+	size_t offset, size_t match_length)
+{
+	size_t match_code = match_length ? match_length - LZ_MIN_MATCH : 0;
+	*out++ = (uint8_t) (((num_literals < 15 ? num_literals : 15) << 4)
+		| (match_code < 15 ? match_code : 15));
+
+	if (num_literals >= 15)
+		out = write_count (out, num_literals);
+
+	if (num_literals)
+		::memcpy (out, literals, num_literals);
+
+	out += num_literals;
+	if (!match_length)
+		return out;
+
+	*out++ = (uint8_t) offset;
+	*out++ = (uint8_t) (offset >> 8);
+	if (match_code >= 15)
+		out = write_count (out, match_code);
+
+	return out;
+}
+
+size_t
+LZCompress (const void *in, size_t size, void *out)
+{
+	const uint8_t *src = (const uint8_t *) in;
+	uint8_t *dst = (uint8_t *) out;
+
+	// Positions plus one, so that 0 means that the slot is empty.
+	static thread_local uint32_t table[1 << HASH_BITS];
+	::memset (table, 0, sizeof (table));
+
+	size_t anchor = 0, pos = 0;
+	while (pos + LZ_MIN_MATCH <= size) {
+		uint32_t value = read32 (src + pos);
+		uint32_t &slot = table[hash32 (value)];
+		size_t candidate = slot;
+		slot = (uint32_t) pos + 1;
+
+		if (!candidate || pos - (candidate - 1) > LZ_MAX_OFFSET
+			|| read32 (src + candidate - 1) != value) {
+			pos++;
+			continue;
+		}
+
+		candidate--;
+		size_t length = LZ_MIN_MATCH;
+		while (pos + length < size && src[candidate + length] == src[pos + length])
+			length++;
+
+		dst = write_sequence (dst, src + anchor, pos - anchor, pos - candidate, length);
+		pos += length;
+		anchor = pos;
+	}
+
+	dst = write_sequence (dst, src + anchor, size - anchor, 0, 0);
+	return (size_t) (dst - (uint8_t *) out);
+}
+
+static bool
+read_count (const uint8_t *&in, const uint8_t *end, size_t &count)
+{
+	uint8_t byte;
+	do {
+		if (in == end)
+			return false;
+
+		byte = *in++;
+		count += byte;
+	} while (byte == 255);
+
+	return true;
+}
+
+bool
+LZDecompress (const void *in, size_t in_size, void *out, size_t out_size)
+{
+	const uint8_t *ip = (const uint8_t *) in;
+	const uint8_t *ip_end = ip + in_size;
+	uint8_t *op = (uint8_t *) out;
+	uint8_t *op_end = op + out_size;
+
+	for (;;) {
+		if (ip == ip_end)
+			return false;
+
+		uint8_t token = *ip++;
+		size_t num_literals = token >> 4;
+		if (num_literals == 15 && !read_count (ip, ip_end, num_literals))
+			return false;
+		if (num_literals > (size_t) (ip_end - ip) || num_literals > (size_t) (op_end - op))
+			return false;
+
+		if (num_literals)
+			::memcpy (op, ip, num_literals);
+
+		ip += num_literals;
+		op += num_literals;
+		if (ip == ip_end)
+			return op == op_end;
+
+		if (ip_end - ip < 2)
+			return false;
+
+		size_t offset = ip[0] | ((size_t) ip[1] << 8);
+		ip += 2;
+		if (!offset || offset > (size_t) (op - (uint8_t *) out))
+			return false;
+
+		size_t length = token & 15;
+		if (length == 15 && !read_count (ip, ip_end, length))
+			return false;
+
+		length += LZ_MIN_MATCH;
+		if (length > (size_t) (op_end - op))
+			return false;
+
+		// Byte by byte, as the match may overlap its own output.
+		const uint8_t *match = op - offset;
+		for (size_t i = 0; i < length; i++)
+			op[i] = match[i];
+
+		op += length;
+	}
+}
+
+}
@@ -5,31 +5,359 @@
 #define LGE_MODULE "LGELog"
 
 #include <LGE/Log.h>
+#include <LGE/LogFormat.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
 
-#include <chrono>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 namespace LGE {
 
 bool bLoggingEnabled = true;
 
-static double
-get_print_time (void)
+static uint64_t
+get_time_ns (void)
 {
-	/** wrap this function in a try-catch, as logging must never fail */
-	try {
-		using clock = std::chrono::high_resolution_clock;
-		static clock::time_point t0 = clock::now ();
-		clock::time_point t1 = clock::now ();
+	struct timespec ts;
+	::clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/** Timestamps are printed relative to this. */
+static const uint64_t t0 = get_time_ns ();
+
+struct LogRecord {
+	uint64_t time;
+	LogLevel level;
+	const char *origin;
+	const char *fmt;
+	LogArgs args;
+};
+
+/**
+ * Bounded MPSC queue, after Dmitry Vyukov's bounded MPMC queue. Every cell
+ * has a sequence number. A producer claims a cell by advancing enqueue_pos
+ * with a CAS, and publishes it by setting the sequence number to pos + 1. The
+ * consumer releases it by setting the sequence number to pos + NUM_CELLS.
+ */
+static constexpr size_t NUM_CELLS = 4096;
+
+struct alignas (64) LogCell {
+	std::atomic<size_t> seq;
+	LogRecord record;
+};
+
+static LogCell cells[NUM_CELLS];
+alignas (64) static std::atomic<size_t> enqueue_pos { 0 };
+alignas (64) static size_t dequeue_pos = 0;
+
+/** Number of records that have been written out. */
+static std::atomic<size_t> written_pos { 0 };
+static std::atomic<uint64_t> dropped { 0 };
+
+static std::atomic<LogOverflowPolicy> overflow_policy { LogOverflowPolicy::DROP };
+
+static std::atomic<bool> running { false };
+static std::atomic<bool> stopping { false };
+static std::atomic<bool> consumer_sleeping { false };
+static std::atomic<uint32_t> wakeup { 0 };
+
+/**
+ * Held by whoever is consuming records: the background thread, or a crash
+ * handler.
+ */
+static std::atomic<bool> consumer_busy { false };
+
+static std::thread consumer_thread;
+
+/** Serializes synchronous output when the background thread is not running. */
+static std::mutex sync_lock;
+
+static void
+init_cells (void)
+{
+	for (size_t i = 0; i < NUM_CELLS; i++)
+		cells[i].seq.store (i, std::memory_order_relaxed);
+}
 
-		std::chrono::duration<double> t = t1 - t0;
-		return t.count ();
-	} catch (...) {
-		return 0.0;
+static LogRecord *
+claim_cell (size_t *out_pos)
+{
+	size_t pos = enqueue_pos.load (std::memory_order_relaxed);
+	for (;;) {
+		LogCell &cell = cells[pos % NUM_CELLS];
+		size_t seq = cell.seq.load (std::memory_order_acquire);
+		intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+		if (diff == 0) {
+			if (enqueue_pos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed)) {
+				*out_pos = pos;
+				return &cell.record;
+			}
+		} else if (diff < 0) {
+			return nullptr;
+		} else {
+			pos = enqueue_pos.load (std::memory_order_relaxed);
+		}
 	}
 }
 
+/**
+ * Wake the consumer after publishing a cell. The publishing store and the
+ * load of consumer_sleeping are ordered by a full fence, as are the store of
+ * consumer_sleeping and the check of the queue in consumer_main, so that at
+ * least one of the two threads sees the other's store.
+ */
+static void
+wake_consumer (void)
+{
+	std::atomic_thread_fence (std::memory_order_seq_cst);
+	if (consumer_sleeping.load ()) {
+		wakeup.fetch_add (1);
+		wakeup.notify_one ();
+	}
+}
+
+static size_t
+format_record (char *out, size_t size, const LogRecord &record)
+{
+	return LogFormatLine (out, size, (double) (record.time - t0) * 1.0e-9,
+		record.level, record.origin, record.fmt, record.args);
+}
+
+/** Binary log output, or nullptr for text output to stdout. */
+static FILE *binary_file = nullptr;
+
+/**
+ * Format string IDs of the binary log, keyed by call site. Only accessed by
+ * whoever is writing output.
+ */
+using FormatKey = std::tuple<const char *, const char *, LogLevel>;
+static std::map<FormatKey, uint32_t> format_ids;
+
+/**
+ * Buffered output. Writes happen in large batches, and the output is flushed
+ * once the queue has been drained.
+ */
+struct OutputBuffer {
+	char m_data[65536];
+	size_t m_size = 0;
+
+	void
+	flush (void)
+	{
+		FILE *f = binary_file ? binary_file : stdout;
+		if (m_size) {
+			::fwrite (m_data, 1, m_size, f);
+			m_size = 0;
+		}
+
+		::fflush (f);
+	}
+
+	void
+	append (const void *data, size_t size)
+	{
+		if (m_size + size > sizeof (m_data))
+			flush ();
+
+		if (size > sizeof (m_data)) {
+			::fwrite (data, 1, size, binary_file);
+			return;
+		}
+
+		::memcpy (m_data + m_size, data, size);
+		m_size += size;
+	}
+
+	template <class T>
+	void
+	append_value (T value)
+	{
+		append (&value, sizeof (value));
+	}
+
+	void
+	append_string (const char *s)
+	{
+		size_t len = ::strlen (s);
+		if (len > UINT16_MAX)
+			len = UINT16_MAX;
+
+		append_value ((uint16_t) len);
+		append (s, len);
+	}
+
+	void
+	add_binary_record (const LogRecord &record)
+	{
+		FormatKey key { record.origin, record.fmt, record.level };
+		auto it = format_ids.find (key);
+		if (it == format_ids.end ()) {
+			uint32_t id = format_ids.size ();
+			it = format_ids.emplace (key, id).first;
+
+			append_value (LOG_RECORD_FORMAT);
+			append_value (id);
+			append_value (record.level);
+			append_string (record.origin);
+			append_string (record.fmt);
+		}
+
+		append_value (LOG_RECORD_MESSAGE);
+		append_value (it->second);
+		append_value (record.time);
+		append_value ((uint16_t) record.args.m_size);
+		append (record.args.m_data, record.args.m_size);
+	}
+
+	void
+	add_record (const LogRecord &record)
+	{
+		if (binary_file) {
+			add_binary_record (record);
+			return;
+		}
+
+		if (m_size + 1024 > sizeof (m_data))
+			flush ();
+
+		m_size += format_record (m_data + m_size, 1024, record);
+	}
+};
+
+static OutputBuffer consumer_output;
+static OutputBuffer sync_output;
+
+/**
+ * Write out all published records. The caller must hold consumer_busy.
+ *
+ * @return the number of records written.
+ */
+static size_t
+drain (OutputBuffer &output)
+{
+	size_t count = 0;
+	for (;;) {
+		uint64_t n = dropped.exchange (0);
+		if (n) {
+			LogRecord note {};
+			note.time = get_time_ns ();
+			note.level = LOG_LEVEL_WARNING;
+			note.origin = LGE_MODULE;
+			note.fmt = "%llu log messages were dropped";
+			LogEncodeArg (note.args, (unsigned long long) n);
+			output.add_record (note);
+		}
+
+		LogCell &cell = cells[dequeue_pos % NUM_CELLS];
+		size_t seq = cell.seq.load (std::memory_order_acquire);
+		if (seq != dequeue_pos + 1)
+			break;
+
+		output.add_record (cell.record);
+		cell.seq.store (dequeue_pos + NUM_CELLS, std::memory_order_release);
+		dequeue_pos++;
+		count++;
+	}
+
+	output.flush ();
+	written_pos.store (dequeue_pos);
+	return count;
+}
+
+static bool
+queue_empty (void)
+{
+	size_t seq = cells[dequeue_pos % NUM_CELLS].seq.load (std::memory_order_acquire);
+	return seq != dequeue_pos + 1;
+}
+
+static void
+consumer_main (void)
+{
+	for (;;) {
+		while (consumer_busy.exchange (true))
+			std::this_thread::yield ();
+		{
+			// Synchronous writers can race with the last batch.
+			std::lock_guard<std::mutex> lock (sync_lock);
+			drain (consumer_output);
+		}
+		consumer_busy.store (false);
+
+		uint32_t w = wakeup.load ();
+		consumer_sleeping.store (true);
+		std::atomic_thread_fence (std::memory_order_seq_cst);
+		if (queue_empty () && !dropped.load ()) {
+			if (stopping.load ())
+				break;
+			wakeup.wait (w);
+		}
+		consumer_sleeping.store (false);
+	}
+
+	consumer_sleeping.store (false);
+}
+
+void
+LogSubmit (LogLevel level, const char *origin, const char *fmt, const LogArgs &args)
+{
+	uint64_t now = get_time_ns ();
+
+	if (!running.load (std::memory_order_relaxed)) {
+		LogRecord record;
+		record.time = now;
+		record.level = level;
+		record.origin = origin;
+		record.fmt = fmt;
+		record.args = args;
+
+		std::lock_guard<std::mutex> lock (sync_lock);
+		if (binary_file) {
+			sync_output.add_record (record);
+			sync_output.flush ();
+			return;
+		}
+
+		char buf[1024];
+		size_t n = format_record (buf, sizeof (buf), record);
+		::fwrite (buf, 1, n, stdout);
+		return;
+	}
+
+	size_t pos;
+	LogRecord *record = claim_cell (&pos);
+	while (!record) {
+		if (overflow_policy.load (std::memory_order_relaxed) == LogOverflowPolicy::DROP) {
+			dropped.fetch_add (1, std::memory_order_relaxed);
+			wake_consumer ();
+			return;
+		}
+
+		wake_consumer ();
+		std::this_thread::yield ();
+		record = claim_cell (&pos);
+	}
+
+	record->time = now;
+	record->level = level;
+	record->origin = origin;
+	record->fmt = fmt;
+	record->args.m_size = args.m_size;
+	::memcpy (record->args.m_data, args.m_data, args.m_size);
+
+	cells[pos % NUM_CELLS].seq.store (pos + 1, std::memory_order_release);
+	wake_consumer ();
+}
+
 void
 DebugPrint (const char *origin, const char *fmt, ...)
 {
@@ -44,7 +372,165 @@ DebugPrint (const char *origin, const char *fmt, ...)
 
 	// Make sure it is null-terminated.
 	logbuf[sizeof (logbuf) - 1] = 0;
-	printf ("%14.6f  %s: %s\n", get_print_time (), origin, logbuf);
+
+	LogArgs captured;
+	captured.PutString (logbuf);
+	LogSubmit (LOG_LEVEL_INFO, origin, "%s", captured);
+}
+
+void
+LogSetOverflowPolicy (LogOverflowPolicy policy)
+{
+	overflow_policy.store (policy);
+}
+
+bool
+LogOpenBinary (const char *path)
+{
+	if (running.load () || binary_file)
+		return false;
+
+	FILE *f = ::fopen (path, "wb");
+	if (!f)
+		return false;
+
+	uint64_t base = t0;
+	if (::fwrite (LOG_BINARY_MAGIC, 1, sizeof (LOG_BINARY_MAGIC), f) != sizeof (LOG_BINARY_MAGIC)
+			|| ::fwrite (&base, 1, sizeof (base), f) != sizeof (base)) {
+		::fclose (f);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock (sync_lock);
+	::fflush (stdout);
+	binary_file = f;
+	return true;
+}
+
+void
+LogFlush (void)
+{
+	if (!running.load ()) {
+		std::lock_guard<std::mutex> lock (sync_lock);
+		::fflush (binary_file ? binary_file : stdout);
+		return;
+	}
+
+	size_t target = enqueue_pos.load ();
+	while (written_pos.load () < target) {
+		wakeup.fetch_add (1);
+		wakeup.notify_one ();
+		std::this_thread::yield ();
+	}
+}
+
+static const int crash_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+
+/** The actions that were installed before crash_handler, by crash_signals index. */
+static struct sigaction previous_actions[std::size (crash_signals)];
+
+/**
+ * Write out queued messages from a crash handler, and pass the signal on to
+ * the handler that was installed before, such as a sanitizer's. This is best
+ * effort: the process is in an unknown state, and formatting is not
+ * async-signal-safe.
+ */
+static void
+crash_handler (int sig, siginfo_t *info, void *context)
+{
+	static std::atomic<bool> drained { false };
+	if (running.load () && !drained.exchange (true)) {
+		// Wait a little while for the background thread to finish its
+		// current batch. It might be the thread that crashed.
+		bool acquired = false;
+		for (int i = 0; i < 1000 && !(acquired = !consumer_busy.exchange (true)); i++) {
+			struct timespec ts = { 0, 100000 };
+			::nanosleep (&ts, nullptr);
+		}
+
+		if (acquired) {
+			static OutputBuffer crash_output;
+			drain (crash_output);
+		}
+	}
+
+	size_t i = 0;
+	while (crash_signals[i] != sig)
+		i++;
+
+	const struct sigaction &previous = previous_actions[i];
+	if (previous.sa_flags & SA_SIGINFO) {
+		previous.sa_sigaction (sig, info, context);
+		return;
+	}
+
+	if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+		previous.sa_handler (sig);
+		return;
+	}
+
+	// Ignoring a fault would only repeat it.
+	::signal (sig, SIG_DFL);
+	::raise (sig);
+}
+
+static void
+at_exit (void)
+{
+	LogTerminate ();
+}
+
+void
+LogInit (void)
+{
+	if (running.load ())
+		return;
+
+	static bool registered = false;
+	if (!registered) {
+		init_cells ();
+		::atexit (at_exit);
+		struct sigaction action {};
+		action.sa_sigaction = crash_handler;
+		action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+		sigemptyset (&action.sa_mask);
+		for (size_t i = 0; i < std::size (crash_signals); i++)
+			::sigaction (crash_signals[i], &action, &previous_actions[i]);
+		registered = true;
+	}
+
+	{
+		// Anything written synchronously must come out first.
+		std::lock_guard<std::mutex> lock (sync_lock);
+		::fflush (binary_file ? binary_file : stdout);
+	}
+
+	stopping.store (false);
+	consumer_thread = std::thread (consumer_main);
+	running.store (true);
+}
+
+void
+LogTerminate (void)
+{
+	if (!running.load ())
+		return;
+
+	running.store (false);
+	stopping.store (true);
+	wakeup.fetch_add (1);
+	wakeup.notify_one ();
+	consumer_thread.join ();
+
+	// Producers that saw running == true just before it was cleared may
+	// have published records after the thread exited.
+	while (consumer_busy.exchange (true))
+		std::this_thread::yield ();
+	{
+		std::lock_guard<std::mutex> lock (sync_lock);
+		drain (consumer_output);
+	}
+	consumer_busy.store (false);
 }
 
 }
@@ -0,0 +1,284 @@
+/**
+ * Formatting of captured log messages.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGELogFormat"
+
+#include <LGE/LogFormat.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace LGE {
+
+class ArgReader {
+private:
+	const uint8_t *m_data;
+	size_t m_size;
+	size_t m_pos = 0;
+
+	int
+	end (void)
+	{
+		m_pos = m_size;
+		return 0;
+	}
+
+public:
+	ArgReader (const LogArgs &args)
+		: m_data (args.m_data), m_size (args.m_size)
+	{}
+
+	/**
+	 * Read the next argument. Strings are returned via str and len.
+	 * Records come from binary logs too, so every read is checked
+	 * against the size, and a malformed argument ends the arguments.
+	 *
+	 * @return the argument type, or 0 if there are no more arguments.
+	 */
+	int
+	next (uint64_t *value, const char **str, size_t *len)
+	{
+		if (m_pos >= m_size)
+			return 0;
+
+		int type = m_data[m_pos];
+		if (type == LOG_ARG_STR) {
+			if (m_size - m_pos < 3)
+				return end ();
+
+			uint16_t len16;
+			::memcpy (&len16, &m_data[m_pos + 1], 2);
+			if (m_size - m_pos - 3 < len16)
+				return end ();
+
+			*str = (const char *) &m_data[m_pos + 3];
+			*len = len16;
+			m_pos += 3 + len16;
+		} else {
+			if (type < LOG_ARG_I64 || type > LOG_ARG_PTR || m_size - m_pos < 9)
+				return end ();
+
+			::memcpy (value, &m_data[m_pos + 1], 8);
+			m_pos += 9;
+		}
+
+		return type;
+	}
+
+};
+
+/**
+ * Format a captured message. Every conversion specification in fmt is
+ * rewritten to match the type of the captured argument, and then formatted
+ * with snprintf on its own. Length modifiers in fmt are ignored, since all
+ * integers are captured as 64-bit values.
+ */
+size_t
+LogFormatMessage (char *out, size_t size, const char *fmt, const LogArgs &args)
+{
+	ArgReader reader (args);
+	size_t pos = 0;
+
+	auto append = [&](const char *s, size_t n) {
+		if (pos + n >= size)
+			n = size - 1 - pos;
+		::memcpy (out + pos, s, n);
+		pos += n;
+	};
+
+	auto append_result = [&](int n) {
+		if (n < 0)
+			return;
+		pos += ((size_t) n < size - pos) ? (size_t) n : size - 1 - pos;
+	};
+
+	while (*fmt && pos < size - 1) {
+		if (*fmt != '%') {
+			const char *end = ::strchr (fmt, '%');
+			size_t n = end ? (size_t) (end - fmt) : ::strlen (fmt);
+			append (fmt, n);
+			fmt += n;
+			continue;
+		}
+
+		if (fmt[1] == '%') {
+			append ("%", 1);
+			fmt += 2;
+			continue;
+		}
+
+		char spec[32];
+		size_t n = 0;
+		spec[n++] = *fmt++;
+
+		auto read_number = [&](void) {
+			if (*fmt == '*') {
+				fmt++;
+				uint64_t v = 0;
+				const char *s;
+				size_t len;
+				reader.next (&v, &s, &len);
+				n += ::snprintf (spec + n, sizeof (spec) - n, "%d", (int) v);
+			} else {
+				while (*fmt >= '0' && *fmt <= '9' && n < 16)
+					spec[n++] = *fmt++;
+			}
+		};
+
+		while (*fmt && ::strchr ("-+ #0", *fmt) && n < 8)
+			spec[n++] = *fmt++;
+
+		read_number ();
+		size_t dot = 0;
+		if (*fmt == '.') {
+			dot = n;
+			spec[n++] = *fmt++;
+			read_number ();
+		}
+
+		while (*fmt && ::strchr ("hljztLq", *fmt))
+			fmt++;
+
+		char conv = *fmt;
+		if (!conv)
+			break;
+		fmt++;
+
+		uint64_t value = 0;
+		const char *str = nullptr;
+		size_t len = 0;
+		int type = reader.next (&value, &str, &len);
+		if (!type) {
+			append ("<?>", 3);
+			continue;
+		}
+
+		if (type == LOG_ARG_STR && conv != 's') {
+			append ("<?>", 3);
+			continue;
+		}
+
+		switch (conv) {
+		case 'd':
+		case 'i':
+			spec[n++] = 'l';
+			spec[n++] = 'l';
+			spec[n++] = conv;
+			spec[n] = 0;
+			if (type == LOG_ARG_F64) {
+				double d;
+				::memcpy (&d, &value, 8);
+				value = (uint64_t) (long long) d;
+			}
+			append_result (::snprintf (out + pos, size - pos, spec, (long long) value));
+			break;
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			spec[n++] = 'l';
+			spec[n++] = 'l';
+			spec[n++] = conv;
+			spec[n] = 0;
+			if (type == LOG_ARG_F64) {
+				double d;
+				::memcpy (&d, &value, 8);
+				value = (uint64_t) d;
+			}
+			append_result (::snprintf (out + pos, size - pos, spec, (unsigned long long) value));
+			break;
+		case 'c':
+			spec[n++] = 'c';
+			spec[n] = 0;
+			append_result (::snprintf (out + pos, size - pos, spec, (int) value));
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A': {
+			double d;
+			if (type == LOG_ARG_F64)
+				::memcpy (&d, &value, 8);
+			else if (type == LOG_ARG_I64)
+				d = (double) (int64_t) value;
+			else
+				d = (double) value;
+
+			spec[n++] = conv;
+			spec[n] = 0;
+			append_result (::snprintf (out + pos, size - pos, spec, d));
+			break;
+		}
+		case 's':
+			if (type != LOG_ARG_STR) {
+				append ("<?>", 3);
+				break;
+			}
+
+			// Captured strings are not terminated, so the length is
+			// always passed as the precision.
+			if (dot) {
+				spec[n] = 0;
+				size_t precision = ::strtoul (&spec[dot + 1], nullptr, 10);
+				if (precision < len)
+					len = precision;
+				n = dot;
+			}
+
+			spec[n++] = '.';
+			spec[n++] = '*';
+			spec[n++] = 's';
+			spec[n] = 0;
+			append_result (::snprintf (out + pos, size - pos, spec, (int) len, str));
+			break;
+		case 'p':
+			append_result (::snprintf (out + pos, size - pos, "%p", (void *) (uintptr_t) value));
+			break;
+		default:
+			append ("<?>", 3);
+			break;
+		}
+	}
+
+	out[pos] = 0;
+	return pos;
+}
+
+static const char *
+level_prefix (LogLevel level)
+{
+	switch (level) {
+	case LOG_LEVEL_TRACE:
+		return "trace: ";
+	case LOG_LEVEL_DEBUG:
+		return "debug: ";
+	case LOG_LEVEL_WARNING:
+		return "warning: ";
+	case LOG_LEVEL_ERROR:
+		return "error: ";
+	default:
+		return "";
+	}
+}
+
+size_t
+LogFormatLine (char *out, size_t size, double seconds, LogLevel level,
+	const char *origin, const char *fmt, const LogArgs &args)
+{
+	int n = ::snprintf (out, size, "%14.6f  %s: %s", seconds, origin, level_prefix (level));
+	if (n < 0)
+		n = 0;
+	if ((size_t) n >= size - 1)
+		n = size - 2;
+
+	n += LogFormatMessage (out + n, size - n - 1, fmt, args);
+	out[n++] = '\n';
+	out[n] = 0;
+	return n;
+}
+
+}
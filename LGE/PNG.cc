@@ -0,0 +1,212 @@
+/**
+ * Minimal PNG writer.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEPNG"
+
+#include <LGE/Log.h>
+#include <LGE/PNG.h>
+
+#include <stdio.h>
+
+namespace LGE {
+
+static uint32_t crc_table[256];
+
+static void
+init_crc_table (void)
+{
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t c = i;
+		for (int k = 0; k < 8; k++)
+			c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+		crc_table[i] = c;
+	}
+}
+
+static uint32_t
+update_crc (uint32_t crc, const uint8_t *data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+	return crc;
+}
+
+/**
+ * Output a PNG file while keeping track of the CRC of the current chunk and
+ * the Adler-32 checksum of the zlib stream.
+ */
+class PNGWriter {
+private:
+	FILE *m_file;
+	uint32_t m_crc;
+	uint32_t m_adler_a = 1, m_adler_b = 0;
+	bool m_error = false;
+
+public:
+	PNGWriter (FILE *f)
+		: m_file (f)
+	{}
+
+	bool
+	failed (void)
+	{
+		return m_error;
+	}
+
+	void
+	write (const void *data, size_t size)
+	{
+		m_crc = update_crc (m_crc, (const uint8_t *) data, size);
+		if (::fwrite (data, 1, size, m_file) != size)
+			m_error = true;
+	}
+
+	void
+	write_u8 (uint8_t value)
+	{
+		write (&value, 1);
+	}
+
+	void
+	write_u16le (uint16_t value)
+	{
+		uint8_t b[2] = { (uint8_t) value, (uint8_t) (value >> 8) };
+		write (b, 2);
+	}
+
+	void
+	write_u32 (uint32_t value)
+	{
+		uint8_t b[4] = { (uint8_t) (value >> 24), (uint8_t) (value >> 16),
+			(uint8_t) (value >> 8), (uint8_t) value };
+		write (b, 4);
+	}
+
+	/** Write uncompressed data that is part of the zlib stream. */
+	void
+	write_data (const void *data, size_t size)
+	{
+		const uint8_t *p = (const uint8_t *) data;
+		for (size_t i = 0; i < size; i++) {
+			m_adler_a = (m_adler_a + p[i]) % 65521;
+			m_adler_b = (m_adler_b + m_adler_a) % 65521;
+		}
+
+		write (data, size);
+	}
+
+	uint32_t
+	adler32 (void)
+	{
+		return (m_adler_b << 16) | m_adler_a;
+	}
+
+	void
+	begin_chunk (const char *type, uint32_t size)
+	{
+		write_u32 (size);
+		m_crc = 0xffffffffu;
+		write (type, 4);
+	}
+
+	void
+	end_chunk (void)
+	{
+		write_u32 (m_crc ^ 0xffffffffu);
+	}
+};
+
+bool
+WritePNG (const char *path, uint32_t width, uint32_t height, const void *pixels)
+{
+	static constexpr size_t MAX_STORED_BLOCK = 65535;
+
+	if (!crc_table[1])
+		init_crc_table ();
+
+	// Every scanline is prefixed by a filter type byte (0 = none).
+	size_t row_size = (size_t) width * 4;
+	size_t data_size = (row_size + 1) * height;
+	size_t num_blocks = data_size ? (data_size + MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK : 1;
+	size_t idat_size = 2 + 5 * num_blocks + data_size + 4;
+	if (idat_size > 0x7fffffffu) {
+		LGE_LOG_WARNING ("%ux%u image is too large to write as a PNG", width, height);
+		return false;
+	}
+
+	FILE *f = ::fopen (path, "wb");
+	if (!f)
+		return false;
+
+	PNGWriter w (f);
+
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	w.write (signature, sizeof (signature));
+
+	w.begin_chunk ("IHDR", 13);
+	w.write_u32 (width);
+	w.write_u32 (height);
+	w.write_u8 (8); // bit depth
+	w.write_u8 (6); // color type: RGBA
+	w.write_u8 (0); // compression method
+	w.write_u8 (0); // filter method
+	w.write_u8 (0); // interlace method
+	w.end_chunk ();
+
+	w.begin_chunk ("IDAT", (uint32_t) idat_size);
+	w.write_u8 (0x78); // zlib header: deflate, 32K window
+	w.write_u8 (0x01);
+
+	/**
+	 * Emit the scanlines as a sequence of stored deflate blocks. A block
+	 * boundary can fall anywhere, including in the middle of a scanline.
+	 */
+	const uint8_t *src = (const uint8_t *) pixels;
+	size_t row = 0, col = 0;
+	size_t left = data_size;
+	do {
+		size_t block = (left < MAX_STORED_BLOCK) ? left : MAX_STORED_BLOCK;
+		left -= block;
+
+		w.write_u8 (left ? 0 : 1);
+		w.write_u16le ((uint16_t) block);
+		w.write_u16le ((uint16_t) ~block);
+
+		while (block) {
+			if (col == 0) {
+				uint8_t filter = 0;
+				w.write_data (&filter, 1);
+				block--;
+				col = 1;
+				continue;
+			}
+
+			size_t n = row_size + 1 - col;
+			if (n > block)
+				n = block;
+
+			w.write_data (src + row * row_size + (col - 1), n);
+			block -= n;
+			col += n;
+			if (col == row_size + 1) {
+				col = 0;
+				row++;
+			}
+		}
+	} while (left);
+
+	w.write_u32 (w.adler32 ());
+	w.end_chunk ();
+
+	w.begin_chunk ("IEND", 0);
+	w.end_chunk ();
+
+	bool ok = !w.failed ();
+	if (::fclose (f))
+		ok = false;
+
+	return ok;
+}
+
+}
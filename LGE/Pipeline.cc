@@ -6,6 +6,9 @@
 
 #include <LGE/Application.h>
 #include <LGE/Pipeline.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/Stats.h>
+#include <LGE/Trace.h>
 #include <LGE/Vulkan.h>
 #include <LGE/Window.h>
 
@@ -13,22 +16,49 @@
 
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace LGE {
 
 VkPipelineCache gPipelineCache = VK_NULL_HANDLE;
 
 /**
- * Currently we build on the assumption that pipeline destruction only happens
- * on swapchain recreate and at program exit, hence the lack of vkWaitDevice.
- * If this assumption is broken, this code will be faulty and it is our
- * responsibility to fix it.
+ * Pipelines that Bind replaces may still be used by frames in flight, so they
+ * are destroyed CPU_RENDER_AHEAD frames later, like buffers released with
+ * MMReleaseGPUBuffer. A Pipeline object itself must only be destroyed when no
+ * frame in flight uses it, such as at program exit.
  */
 
+static std::vector<VkPipeline> retired[CPU_RENDER_AHEAD];
+static size_t retired_index = 0;
+
+void
+PipelineNextFrame (void)
+{
+	retired_index++;
+	if (retired_index >= CPU_RENDER_AHEAD)
+		retired_index = 0;
+
+	for (VkPipeline pipeline : retired[retired_index])
+		::vkDestroyPipeline (gVkDevice, pipeline, nullptr);
+	retired[retired_index].clear ();
+}
+
+void
+PipelineTerminate (void)
+{
+	for (std::vector<VkPipeline> &pipelines : retired) {
+		for (VkPipeline pipeline : pipelines)
+			::vkDestroyPipeline (gVkDevice, pipeline, nullptr);
+		pipelines.clear ();
+	}
+}
+
 Pipeline::Pipeline (void) {}
 
 Pipeline::~Pipeline (void)
 {
+	ShaderReloadForget (this);
 	if (m_pipeline != VK_NULL_HANDLE) {
 		::vkDestroyPipeline (gVkDevice, m_pipeline, nullptr);
 		m_pipeline = VK_NULL_HANDLE;
@@ -44,18 +74,41 @@ Pipeline::Create (void)
 void
 Pipeline::Bind (VkCommandBuffer cmd, VkPipelineBindPoint bind_point)
 {
-	VkRenderPass rp = gApplication->GetRenderPass ();
+	// Compute pipelines do not depend on the render pass, and can be bound
+	// without an Application, for example while loading assets.
+	VkRenderPass rp = VK_NULL_HANDLE;
+	if (bind_point != VK_PIPELINE_BIND_POINT_COMPUTE)
+		rp = gApplication->GetRenderPass ();
+
+#ifdef LGE_SHADER_HOT_RELOAD
+	if (m_bound == VK_NULL_HANDLE || rp != m_targetRenderPass) {
+		ShaderReloadCreateScope scope (this);
+		m_bound = VK_NULL_HANDLE;
+#else
 	if (m_pipeline == VK_NULL_HANDLE || rp != m_targetRenderPass) {
+#endif
 		if (m_pipeline != VK_NULL_HANDLE) {
-			::vkDestroyPipeline (gVkDevice, m_pipeline, nullptr);
+			retired[retired_index].push_back (m_pipeline);
 			m_pipeline = VK_NULL_HANDLE;
 		}
 
 		m_targetRenderPass = rp;
+
+		LGE_TRACE_SCOPE ("Pipeline::Create");
 		this->Create ();
+		StatAdd (STAT_PIPELINES_CREATED);
+#ifdef LGE_SHADER_HOT_RELOAD
+		m_bound = m_pipeline;
+		scope.Commit ();
+#endif
 	}
 
+	StatAdd (STAT_PIPELINE_BINDS);
+#ifdef LGE_SHADER_HOT_RELOAD
+	::vkCmdBindPipeline (cmd, bind_point, m_bound);
+#else
 	::vkCmdBindPipeline (cmd, bind_point, m_pipeline);
+#endif
 }
 
 // TODO: make use of maintenance5 in LinkShaderModules and FreeShaderModules
@@ -73,10 +126,15 @@ LinkShaderModules (VkGraphicsPipelineCreateInfo *pipeline_ci,
 	VkPipelineShaderStageCreateInfo *stages = new VkPipelineShaderStageCreateInfo[count];
 
 	for (uint32_t i = 0; i < count; i++) {
+		ShaderModuleInfo shader = shaders[i];
+#ifdef LGE_SHADER_HOT_RELOAD
+		ShaderReloadResolve (shader);
+#endif
+
 		VkShaderModuleCreateInfo shader_module_ci {};
 		shader_module_ci.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		shader_module_ci.codeSize = shaders[i].size;
-		shader_module_ci.pCode = shaders[i].code;
+		shader_module_ci.codeSize = shader.size;
+		shader_module_ci.pCode = shader.code;
 
 		VkResult result = ::vkCreateShaderModule (gVkDevice,
 			&shader_module_ci, nullptr, &stages[i].module);
@@ -90,7 +148,7 @@ LinkShaderModules (VkGraphicsPipelineCreateInfo *pipeline_ci,
 		stages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 		stages[i].pNext = nullptr;
 		stages[i].flags = 0;
-		stages[i].stage = shaders[i].stage;
+		stages[i].stage = shader.stage;
 		stages[i].pName = "main";
 		stages[i].pSpecializationInfo = nullptr;
 	}
@@ -114,4 +172,44 @@ FreeShaderModules (VkGraphicsPipelineCreateInfo *pipeline_ci)
 	pipeline_ci->pStages = nullptr;
 }
 
+void
+LinkShaderModules (VkComputePipelineCreateInfo *pipeline_ci,
+	const ShaderModuleInfo &compute_shader)
+{
+	ShaderModuleInfo shader = compute_shader;
+#ifdef LGE_SHADER_HOT_RELOAD
+	ShaderReloadResolve (shader);
+#endif
+
+	VkShaderModuleCreateInfo shader_module_ci {};
+	shader_module_ci.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	shader_module_ci.codeSize = shader.size;
+	shader_module_ci.pCode = shader.code;
+
+	VkPipelineShaderStageCreateInfo &stage = pipeline_ci->stage;
+	VkResult result = ::vkCreateShaderModule (gVkDevice,
+		&shader_module_ci, nullptr, &stage.module);
+	if (result != VK_SUCCESS) {
+		stage.module = VK_NULL_HANDLE;
+		throw std::runtime_error (std::string ("vkCreateShaderModule returned ") + VulkanTypeToString (result));
+	}
+
+	stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stage.pNext = nullptr;
+	stage.flags = 0;
+	stage.stage = shader.stage;
+	stage.pName = "main";
+	stage.pSpecializationInfo = nullptr;
+}
+
+void
+FreeShaderModules (VkComputePipelineCreateInfo *pipeline_ci)
+{
+	if (pipeline_ci->stage.module == VK_NULL_HANDLE)
+		return;
+
+	::vkDestroyShaderModule (LGE::gVkDevice, pipeline_ci->stage.module, nullptr);
+	pipeline_ci->stage.module = VK_NULL_HANDLE;
+}
+
 }
@@ -0,0 +1,270 @@
+/**
+ * Profiler overlay.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEProfilerOverlay"
+
+#include <LGE/DebugUI.h>
+#include <LGE/GPUMemory.h>
+#include <LGE/GPUProfiler.h>
+#include <LGE/ProfilerOverlay.h>
+#include <LGE/Stats.h>
+#include <LGE/Trace.h>
+#include <LGE/Window.h>
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace LGE {
+
+static constexpr size_t NUM_SAMPLES = 240;
+
+/** Ring buffer of frame times, in milliseconds. */
+struct FrameTimes {
+	float m_samples[NUM_SAMPLES] {};
+	size_t m_next = 0;
+	size_t m_count = 0;
+
+	void
+	push (float ms)
+	{
+		m_samples[m_next++] = ms;
+		if (m_next >= NUM_SAMPLES)
+			m_next = 0;
+		if (m_count < NUM_SAMPLES)
+			m_count++;
+	}
+
+	/** Index of the oldest sample. */
+	size_t
+	first (void) const
+	{
+		return (m_count < NUM_SAMPLES) ? 0 : m_next;
+	}
+
+	float
+	latest (void) const
+	{
+		if (!m_count)
+			return 0.0f;
+		return m_samples[m_next ? m_next - 1 : NUM_SAMPLES - 1];
+	}
+
+	float
+	percentile (float p) const
+	{
+		if (!m_count)
+			return 0.0f;
+
+		float sorted[NUM_SAMPLES];
+		::memcpy (sorted, m_samples, m_count * sizeof (float));
+
+		size_t k = (size_t) ::ceilf (p * (float) m_count);
+		k = (k > 0) ? k - 1 : 0;
+		std::nth_element (sorted, sorted + k, sorted + m_count);
+		return sorted[k];
+	}
+};
+
+static bool visible = false;
+
+static FrameTimes cpu_frame_times, gpu_frame_times;
+static uint64_t prev_frame_time = 0;
+static uint64_t prev_gpu_frame = 0;
+
+void
+ProfilerOverlaySetVisible (bool v)
+{
+	visible = v;
+}
+
+void
+ProfilerOverlayToggle (void)
+{
+	visible = !visible;
+}
+
+bool
+ProfilerOverlayIsVisible (void)
+{
+	return visible;
+}
+
+void
+ProfilerOverlayNextFrame (void)
+{
+	uint64_t now = TraceNow ();
+	if (prev_frame_time)
+		cpu_frame_times.push (1.0e-6f * (float) (now - prev_frame_time));
+	prev_frame_time = now;
+
+	// GPU results lag behind by CPU_RENDER_AHEAD frames. The root scope
+	// covers the whole frame.
+	const GPUProfilerScope *scopes;
+	size_t count;
+	uint64_t frame = GPUProfilerGetResults (&scopes, &count);
+	if (frame != prev_gpu_frame && count) {
+		gpu_frame_times.push ((float) scopes[0].duration);
+		prev_gpu_frame = frame;
+	}
+}
+
+static int
+graph_y (float value, float max, int y, int height)
+{
+	float v = value / max;
+	v = (v < 0.0f) ? 0.0f : (v > 1.0f) ? 1.0f : v;
+	return y + (int) ((1.0f - v) * (float) (height - 1) + 0.5f);
+}
+
+static void
+draw_frame_times (const FrameTimes &times, float max, int x, int y, int width, int height,
+	float r, float g, float b)
+{
+	DebugUIDrawGraph (x, y, width, height, DebugUICorner::TOP_LEFT,
+		times.m_samples, times.m_count, times.first (), 0.0f, max,
+		r, g, b, 1.0f);
+
+	int p99_y = graph_y (times.percentile (0.99f), max, y, height);
+	DebugUIDrawLine (x, p99_y, x + width - 1, p99_y, DebugUICorner::TOP_LEFT,
+		r, g, b, 0.5f);
+}
+
+static const char *
+heap_kind (const MMHeapStats &heap)
+{
+	return (heap.m_flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "device" : "host";
+}
+
+void
+ProfilerOverlayDraw (int x, int y, DebugUICorner corner)
+{
+	if (!visible)
+		return;
+
+	const GPUProfilerScope *scopes;
+	size_t num_scopes;
+	GPUProfilerGetResults (&scopes, &num_scopes);
+
+	MMStats mm;
+	MMGetStats (mm);
+
+	const uint64_t *stats = StatsGetLastFrame ();
+
+	int line_height = DebugUIGetLineHeight ();
+	int pad = line_height / 2;
+	int width = 30 * line_height;
+	int graph_height = 4 * line_height;
+	int num_lines = 2 + 1 + (num_scopes ? (int) num_scopes : 1) + (int) mm.m_numHeaps + 2;
+	int height = 2 * pad + num_lines * line_height + graph_height + 3 * pad;
+
+	// Everything below is drawn relative to the top left corner of the
+	// overlay, so that columns line up whatever the corner is.
+	VkExtent2D extent = gWindow->GetSwapchainExtent ();
+	if (corner == DebugUICorner::TOP_RIGHT || corner == DebugUICorner::BOTTOM_RIGHT)
+		x = extent.width - x - width;
+	if (corner == DebugUICorner::BOTTOM_LEFT || corner == DebugUICorner::BOTTOM_RIGHT)
+		y = extent.height - y - height;
+
+	static constexpr DebugUICorner TL = DebugUICorner::TOP_LEFT;
+	DebugUIDrawRect (x, y, width, height, TL, 0.0f, 0.0f, 0.0f, 0.75f);
+
+	int left = x + pad, right = x + width - pad;
+	int inner_width = right - left;
+	int cy = y + pad;
+
+	float cpu_p99 = cpu_frame_times.percentile (0.99f);
+	float gpu_p99 = gpu_frame_times.percentile (0.99f);
+
+	DebugUIPrintf (left, cy, TL, 0.4f, 1.0f, 0.4f, 1.0f,
+		"frame  %.2f ms  p99 %.2f ms", cpu_frame_times.latest (), cpu_p99);
+	cy += line_height;
+	DebugUIPrintf (left, cy, TL, 0.3f, 0.8f, 1.0f, 1.0f,
+		"gpu    %.2f ms  p99 %.2f ms", gpu_frame_times.latest (), gpu_p99);
+	cy += line_height + pad / 2;
+
+	float graph_max = 1.25f * std::max (cpu_p99, gpu_p99);
+	if (graph_max < 1.0f)
+		graph_max = 1.0f;
+
+	DebugUIDrawRect (left, cy, inner_width, graph_height, TL, 1.0f, 1.0f, 1.0f, 0.08f);
+	draw_frame_times (gpu_frame_times, graph_max, left, cy, inner_width, graph_height,
+		0.3f, 0.8f, 1.0f);
+	draw_frame_times (cpu_frame_times, graph_max, left, cy, inner_width, graph_height,
+		0.4f, 1.0f, 0.4f);
+	DebugUIPrintf (right - 5 * line_height, cy, TL, 1.0f, 1.0f, 1.0f, 0.6f,
+		"%.1f ms", graph_max);
+	cy += graph_height + pad;
+
+	// Scope tree. The bar behind every scope shows its share of the GPU
+	// frame time.
+	int cpu_column = right - 8 * line_height;
+	int gpu_column = right - 4 * line_height;
+	DebugUIDrawText ("scope", left, cy, TL, 1.0f, 1.0f, 1.0f, 0.6f);
+	DebugUIDrawText ("cpu ms", cpu_column, cy, TL, 1.0f, 1.0f, 1.0f, 0.6f);
+	DebugUIDrawText ("gpu ms", gpu_column, cy, TL, 1.0f, 1.0f, 1.0f, 0.6f);
+	cy += line_height;
+
+	if (!num_scopes) {
+		DebugUIDrawText ("no GPU profiler results", left, cy, TL,
+			1.0f, 1.0f, 0.0f, 1.0f);
+		cy += line_height;
+	}
+
+	double frame_duration = num_scopes ? scopes[0].duration : 0.0;
+	for (size_t i = 0; i < num_scopes; i++) {
+		const GPUProfilerScope &scope = scopes[i];
+		int indent = (int) scope.depth * line_height;
+
+		if (frame_duration > 0.0) {
+			int bar = (int) ((cpu_column - left - indent) * (scope.duration / frame_duration));
+			DebugUIDrawRect (left + indent, cy + 1, bar, line_height - 2, TL,
+				0.3f, 0.8f, 1.0f, 0.25f);
+		}
+
+		DebugUIDrawText (scope.name, left + indent, cy, TL, 1.0f, 1.0f, 1.0f, 1.0f);
+		DebugUIPrintf (cpu_column, cy, TL, 0.4f, 1.0f, 0.4f, 1.0f,
+			"%.3f", scope.cpu_duration);
+		DebugUIPrintf (gpu_column, cy, TL, 0.3f, 0.8f, 1.0f, 1.0f,
+			"%.3f", scope.duration);
+		cy += line_height;
+	}
+
+	cy += pad;
+
+	// Memory usage per heap, as a fraction of the budget.
+	int bar_left = left + inner_width / 2;
+	int bar_width = right - bar_left;
+	for (uint32_t i = 0; i < mm.m_numHeaps; i++) {
+		const MMHeapStats &heap = mm.m_heaps[i];
+		DebugUIPrintf (left, cy, TL, 1.0f, 1.0f, 1.0f, 1.0f,
+			"heap %u %s: %.1f / %.1f MiB", i, heap_kind (heap),
+			(double) heap.m_usage / (1024.0 * 1024.0),
+			(double) heap.m_budget / (1024.0 * 1024.0));
+
+		float usage = (float) heap.m_usage;
+		bool over = heap.m_usage > heap.m_budget;
+		DebugUIColor color = over ? DebugUIColor { 1.0f, 0.3f, 0.2f, 0.8f }
+			: DebugUIColor { 0.4f, 1.0f, 0.4f, 0.6f };
+		DebugUIDrawStackedBar (bar_left, cy + 2, bar_width, line_height - 4, TL,
+			&usage, &color, 1, (float) heap.m_budget);
+		DebugUIDrawRectOutline (bar_left, cy + 2, bar_width, line_height - 4, TL,
+			1.0f, 1.0f, 1.0f, 0.3f);
+		cy += line_height;
+	}
+
+	DebugUIPrintf (left, cy, TL, 1.0f, 1.0f, 1.0f, 1.0f,
+		"pipelines created %llu  binds %llu",
+		(unsigned long long) stats[STAT_PIPELINES_CREATED],
+		(unsigned long long) stats[STAT_PIPELINE_BINDS]);
+	cy += line_height;
+	DebugUIPrintf (left, cy, TL, 1.0f, 1.0f, 1.0f, 1.0f,
+		"descriptor sets %llu  temporary buffers %llu (%.1f KiB)",
+		(unsigned long long) stats[STAT_DESCRIPTOR_SETS],
+		(unsigned long long) stats[STAT_TEMPORARY_BUFFERS],
+		(double) stats[STAT_TEMPORARY_BUFFER_BYTES] / 1024.0);
+}
+
+}
@@ -0,0 +1,576 @@
+/**
+ * Shader hot reload.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEShaderReload"
+
+#include <LGE/Application.h>
+#include <LGE/GPUMemory.h>
+#include <LGE/Log.h>
+#include <LGE/ShaderReload.h>
+#include <LGE/Trace.h>
+#include <LGE/Vulkan.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+extern char **environ;
+
+#ifndef LGE_SHADER_SOURCE_DIR
+#define LGE_SHADER_SOURCE_DIR "."
+#endif
+
+#ifndef LGE_GLSLANG_EXECUTABLE
+#define LGE_GLSLANG_EXECUTABLE "glslang"
+#endif
+
+namespace LGE {
+
+struct ShaderReloadAccess {
+	static VkPipeline &
+	Created (Pipeline *pipeline)
+	{
+		return pipeline->m_pipeline;
+	}
+
+	static VkPipeline &
+	Bound (Pipeline *pipeline)
+	{
+		return pipeline->m_bound;
+	}
+
+	static VkRenderPass
+	RenderPass (Pipeline *pipeline)
+	{
+		return pipeline->m_targetRenderPass;
+	}
+
+	static void
+	Create (Pipeline *pipeline)
+	{
+		pipeline->Create ();
+	}
+};
+
+struct WatchedShader {
+	/** Canonical path of the GLSL source. */
+	std::string m_path;
+
+	/** Latest compiled code, or nullptr if the source has not changed. */
+	const std::vector<uint32_t> *m_compiled;
+};
+
+struct RecreatedPipeline {
+	Pipeline *m_pipeline;
+	VkPipeline m_handle;
+	VkRenderPass m_renderPass;
+};
+
+struct RetiredPipeline {
+	VkPipeline m_handle;
+	uint64_t m_frame;
+};
+
+/**
+ * Serializes Create of all pipelines, and guards Pipeline::m_pipeline while
+ * the background thread recreates a pipeline. Taken before registry_lock.
+ */
+static std::recursive_mutex create_lock;
+
+/** Guards the shader registry and the recreated pipelines. */
+static std::mutex registry_lock;
+
+static std::unordered_map<const uint32_t *, WatchedShader> shaders;
+
+/**
+ * Every version of compiled code. A pipeline may be created from a version
+ * while a newer one is compiled, and versions are small, so none are freed
+ * before termination.
+ */
+static std::deque<std::vector<uint32_t>> compiled_code;
+
+/** The shaders that the last successful Create of each pipeline linked. */
+static std::unordered_map<Pipeline *, std::vector<const uint32_t *>> pipeline_shaders;
+
+/** Directories of watched shaders, by inotify watch descriptor. */
+static std::unordered_map<int, std::string> watched_dirs;
+
+/** Pipelines recreated by the background thread, to be swapped in. */
+static std::vector<RecreatedPipeline> recreated;
+
+/** Replaced pipelines. Only used by the main thread. */
+static std::vector<RetiredPipeline> retired;
+
+static int inotify_fd = -1;
+static int wake_pipe[2] = { -1, -1 };
+static std::thread watch_thread;
+
+static thread_local ShaderReloadCreateScope *current_scope = nullptr;
+
+ShaderReloadCreateScope::ShaderReloadCreateScope (Pipeline *pipeline)
+	: m_pipeline (pipeline), m_outer (current_scope)
+{
+	create_lock.lock ();
+	current_scope = this;
+}
+
+ShaderReloadCreateScope::~ShaderReloadCreateScope (void)
+{
+	current_scope = m_outer;
+	create_lock.unlock ();
+}
+
+void
+ShaderReloadCreateScope::Commit (void)
+{
+	std::lock_guard<std::mutex> lock (registry_lock);
+	pipeline_shaders[m_pipeline] = std::move (m_shaders);
+}
+
+void
+ShaderReloadResolve (ShaderModuleInfo &shader)
+{
+	std::lock_guard<std::mutex> lock (registry_lock);
+	auto it = shaders.find (shader.code);
+	if (it == shaders.end ())
+		return;
+
+	if (current_scope) {
+		std::vector<const uint32_t *> &linked = current_scope->m_shaders;
+		if (std::find (linked.begin (), linked.end (), shader.code) == linked.end ())
+			linked.push_back (shader.code);
+	}
+
+	if (it->second.m_compiled) {
+		shader.code = it->second.m_compiled->data ();
+		shader.size = it->second.m_compiled->size () * sizeof (uint32_t);
+	}
+}
+
+ShaderReloadPause::ShaderReloadPause (void)
+{
+	create_lock.lock ();
+}
+
+ShaderReloadPause::~ShaderReloadPause (void)
+{
+	create_lock.unlock ();
+}
+
+static bool
+read_spirv (const char *path, std::vector<uint32_t> &code)
+{
+	int fd = ::open (path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	std::vector<char> bytes;
+	char buf[16384];
+	ssize_t n;
+	while ((n = ::read (fd, buf, sizeof (buf))) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			::close (fd);
+			return false;
+		}
+
+		bytes.insert (bytes.end (), buf, buf + n);
+	}
+
+	::close (fd);
+	if (bytes.empty () || bytes.size () % 4)
+		return false;
+
+	code.resize (bytes.size () / 4);
+	::memcpy (code.data (), bytes.data (), bytes.size ());
+	return code[0] == 0x07230203;
+}
+
+/**
+ * Compile a shader with glslang, with the flags of lge_add_shaders. Errors
+ * are logged.
+ */
+static bool
+compile_shader (const std::string &path, std::vector<uint32_t> &code)
+{
+	char output_path[] = "/tmp/lge-shader-XXXXXX";
+	int output_fd = ::mkstemp (output_path);
+	if (output_fd < 0) {
+		LGE_LOG_WARNING ("Cannot create a temporary file (%s)", ::strerror (errno));
+		return false;
+	}
+
+	::close (output_fd);
+
+	int log_pipe[2];
+	if (::pipe2 (log_pipe, O_CLOEXEC)) {
+		LGE_LOG_WARNING ("Cannot create a pipe (%s)", ::strerror (errno));
+		::unlink (output_path);
+		return false;
+	}
+
+	posix_spawn_file_actions_t actions;
+	::posix_spawn_file_actions_init (&actions);
+	::posix_spawn_file_actions_adddup2 (&actions, log_pipe[1], STDOUT_FILENO);
+	::posix_spawn_file_actions_adddup2 (&actions, log_pipe[1], STDERR_FILENO);
+
+	const char *argv[] = {
+		LGE_GLSLANG_EXECUTABLE, "-V100", "--glsl-version", "460", "-Os", "-g0",
+		"-o", output_path, path.c_str (), nullptr
+	};
+
+	pid_t pid;
+	int error = ::posix_spawnp (&pid, argv[0], &actions, nullptr,
+		const_cast<char **> (argv), environ);
+	::posix_spawn_file_actions_destroy (&actions);
+	::close (log_pipe[1]);
+
+	if (error) {
+		LGE_LOG_WARNING ("Cannot run %s (%s)", argv[0], ::strerror (error));
+		::close (log_pipe[0]);
+		::unlink (output_path);
+		return false;
+	}
+
+	std::string output;
+	char buf[4096];
+	ssize_t n;
+	while ((n = ::read (log_pipe[0], buf, sizeof (buf))) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		output.append (buf, n);
+	}
+
+	::close (log_pipe[0]);
+
+	int status;
+	while (::waitpid (pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			status = -1;
+			break;
+		}
+	}
+
+	bool ok = status != -1 && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+	if (ok && !read_spirv (output_path, code)) {
+		output = "No SPIR-V was written.";
+		ok = false;
+	}
+
+	::unlink (output_path);
+	while (!output.empty () && output.back () == '\n')
+		output.pop_back ();
+	if (!ok)
+		LGE_LOG_WARNING ("Cannot compile %s:\n%s", path.c_str (), output.c_str ());
+
+	return ok;
+}
+
+/**
+ * Recreate a pipeline with the latest code of its shaders. Graphics
+ * pipelines that were created for a render pass that has since been replaced
+ * are left to Bind, which recreates them anyway.
+ */
+static void
+recreate_pipeline (Pipeline *pipeline)
+{
+	std::lock_guard<std::recursive_mutex> create (create_lock);
+	{
+		std::lock_guard<std::mutex> lock (registry_lock);
+		if (!pipeline_shaders.count (pipeline))
+			return;
+	}
+
+	VkRenderPass render_pass = ShaderReloadAccess::RenderPass (pipeline);
+	if (render_pass != VK_NULL_HANDLE && render_pass != gApplication->GetRenderPass ())
+		return;
+
+	VkPipeline &handle = ShaderReloadAccess::Created (pipeline);
+	VkPipeline bound = handle;
+	handle = VK_NULL_HANDLE;
+
+	bool ok = true;
+	try {
+		ShaderReloadCreateScope scope (pipeline);
+		LGE_TRACE_SCOPE ("Pipeline::Create");
+		ShaderReloadAccess::Create (pipeline);
+		scope.Commit ();
+	} catch (const std::exception &e) {
+		LGE_LOG_WARNING ("Cannot recreate a pipeline: %s", e.what ());
+		ok = false;
+	}
+
+	VkPipeline created = handle;
+	handle = bound;
+	if (created == VK_NULL_HANDLE)
+		return;
+
+	if (!ok) {
+		::vkDestroyPipeline (gVkDevice, created, nullptr);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock (registry_lock);
+	recreated.push_back ({ pipeline, created, ShaderReloadAccess::RenderPass (pipeline) });
+}
+
+static void
+reload_shader (const uint32_t *key)
+{
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lock (registry_lock);
+		auto it = shaders.find (key);
+		if (it == shaders.end ())
+			return;
+
+		path = it->second.m_path;
+	}
+
+	std::vector<uint32_t> code;
+	if (!compile_shader (path, code))
+		return;
+
+	std::vector<Pipeline *> pipelines;
+	{
+		std::lock_guard<std::mutex> lock (registry_lock);
+		compiled_code.push_back (std::move (code));
+		shaders[key].m_compiled = &compiled_code.back ();
+
+		for (const auto &[pipeline, linked] : pipeline_shaders)
+			if (std::find (linked.begin (), linked.end (), key) != linked.end ())
+				pipelines.push_back (pipeline);
+	}
+
+	Log ("Recompiled %s, recreating %u pipelines", path.c_str (),
+		(unsigned) pipelines.size ());
+
+	for (Pipeline *pipeline : pipelines)
+		recreate_pipeline (pipeline);
+}
+
+/** Milliseconds to wait for more changes, as editors often save in steps. */
+static constexpr int SETTLE_TIME = 50;
+
+static void
+watch_main (void)
+{
+	TraceSetThreadName ("ShaderReload");
+
+	alignas (struct inotify_event) char buf[4096];
+	std::vector<const uint32_t *> changed;
+	for (;;) {
+		struct pollfd fds[2] {};
+		fds[0].fd = inotify_fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = wake_pipe[0];
+		fds[1].events = POLLIN;
+
+		int ret = ::poll (fds, 2, changed.empty () ? -1 : SETTLE_TIME);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			LGE_LOG_WARNING ("poll failed (%s); no longer watching shaders", ::strerror (errno));
+			return;
+		}
+
+		if (fds[1].revents)
+			return;
+
+		if (!ret) {
+			for (const uint32_t *key : changed)
+				reload_shader (key);
+			changed.clear ();
+			continue;
+		}
+
+		ssize_t n = ::read (inotify_fd, buf, sizeof (buf));
+		if (n <= 0)
+			continue;
+
+		std::lock_guard<std::mutex> lock (registry_lock);
+		for (char *p = buf; p < buf + n;) {
+			const struct inotify_event *event = (const struct inotify_event *) p;
+			p += sizeof (struct inotify_event) + event->len;
+
+			auto dir = watched_dirs.find (event->wd);
+			if (dir == watched_dirs.end () || !event->len)
+				continue;
+
+			std::string path = dir->second + "/" + event->name;
+			for (const auto &[key, shader] : shaders)
+				if (shader.m_path == path && std::find (changed.begin (), changed.end (), key) == changed.end ())
+					changed.push_back (key);
+		}
+	}
+}
+
+/** Called with registry_lock held. */
+static bool
+start_watching (void)
+{
+	inotify_fd = ::inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd < 0) {
+		LGE_LOG_WARNING ("inotify is not available (%s)", ::strerror (errno));
+		return false;
+	}
+
+	if (::pipe2 (wake_pipe, O_CLOEXEC)) {
+		LGE_LOG_WARNING ("Cannot create a pipe (%s)", ::strerror (errno));
+		::close (inotify_fd);
+		inotify_fd = -1;
+		return false;
+	}
+
+	watch_thread = std::thread (watch_main);
+	Log ("Watching shaders for changes");
+	return true;
+}
+
+void
+ShaderReloadWatch (const uint32_t *code, const char *path)
+{
+	std::string source = path;
+	if (source.empty () || source[0] != '/')
+		source = std::string (LGE_SHADER_SOURCE_DIR "/") + source;
+
+	char resolved[PATH_MAX];
+	if (!::realpath (source.c_str (), resolved)) {
+		LGE_LOG_WARNING ("Cannot watch %s (%s)", source.c_str (), ::strerror (errno));
+		return;
+	}
+
+	source = resolved;
+	std::string dir = source.substr (0, source.rfind ('/'));
+
+	std::lock_guard<std::mutex> lock (registry_lock);
+	auto it = shaders.find (code);
+	if (it != shaders.end () && it->second.m_path == source)
+		return;
+
+	if (inotify_fd < 0 && !start_watching ())
+		return;
+
+	// Watch the directory rather than the file, as editors often save by
+	// renaming a new file over the old one.
+	int wd = ::inotify_add_watch (inotify_fd, dir.empty () ? "/" : dir.c_str (),
+		IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd < 0) {
+		LGE_LOG_WARNING ("Cannot watch %s (%s)", dir.c_str (), ::strerror (errno));
+		return;
+	}
+
+	watched_dirs[wd] = dir;
+	shaders[code] = { source, nullptr };
+}
+
+void
+ShaderReloadForget (Pipeline *pipeline)
+{
+	std::lock_guard<std::recursive_mutex> create (create_lock);
+	std::lock_guard<std::mutex> lock (registry_lock);
+	pipeline_shaders.erase (pipeline);
+
+	// Recreated pipelines that were not swapped in have never been used.
+	std::erase_if (recreated, [pipeline] (const RecreatedPipeline &r) {
+		if (r.m_pipeline != pipeline)
+			return false;
+
+		::vkDestroyPipeline (gVkDevice, r.m_handle, nullptr);
+		return true;
+	});
+}
+
+void
+ShaderReloadNextFrame (void)
+{
+	uint64_t frame = MMGetFrameIndex ();
+	std::erase_if (retired, [frame] (const RetiredPipeline &r) {
+		if (frame < r.m_frame + CPU_RENDER_AHEAD)
+			return false;
+
+		::vkDestroyPipeline (gVkDevice, r.m_handle, nullptr);
+		return true;
+	});
+
+	// Do not wait for a pipeline that is being recreated.
+	std::unique_lock<std::recursive_mutex> create (create_lock, std::try_to_lock);
+	if (!create.owns_lock ())
+		return;
+
+	std::vector<RecreatedPipeline> pipelines;
+	{
+		std::lock_guard<std::mutex> lock (registry_lock);
+		pipelines.swap (recreated);
+	}
+
+	for (const RecreatedPipeline &r : pipelines) {
+		// Bind has recreated the pipeline for a new render pass since.
+		if (ShaderReloadAccess::RenderPass (r.m_pipeline) != r.m_renderPass) {
+			::vkDestroyPipeline (gVkDevice, r.m_handle, nullptr);
+			continue;
+		}
+
+		VkPipeline &bound = ShaderReloadAccess::Bound (r.m_pipeline);
+		if (bound != VK_NULL_HANDLE)
+			retired.push_back ({ bound, frame });
+
+		bound = r.m_handle;
+		ShaderReloadAccess::Created (r.m_pipeline) = r.m_handle;
+	}
+}
+
+void
+ShaderReloadTerminate (void)
+{
+	if (watch_thread.joinable ()) {
+		char c = 0;
+		while (::write (wake_pipe[1], &c, 1) < 0 && errno == EINTR);
+		watch_thread.join ();
+	}
+
+	if (inotify_fd >= 0) {
+		::close (inotify_fd);
+		::close (wake_pipe[0]);
+		::close (wake_pipe[1]);
+		inotify_fd = -1;
+		wake_pipe[0] = -1;
+		wake_pipe[1] = -1;
+	}
+
+	for (const RecreatedPipeline &r : recreated)
+		::vkDestroyPipeline (gVkDevice, r.m_handle, nullptr);
+	for (const RetiredPipeline &r : retired)
+		::vkDestroyPipeline (gVkDevice, r.m_handle, nullptr);
+
+	recreated.clear ();
+	retired.clear ();
+	watched_dirs.clear ();
+	pipeline_shaders.clear ();
+	shaders.clear ();
+	compiled_code.clear ();
+}
+
+}
@@ -0,0 +1,54 @@
+/**
+ * Per-frame engine counters.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGEStats"
+
+#include <LGE/Stats.h>
+
+#include <string.h>
+
+namespace LGE {
+
+uint64_t gStatCounters[NUM_STATS];
+
+static uint64_t last_frame[NUM_STATS];
+
+static const char *const stat_names[NUM_STATS] = {
+	"gpu_allocations",
+	"temporary_buffers",
+	"temporary_buffer_bytes",
+	"staging_uploads",
+	"upload_bytes",
+	"defrag_moves",
+	"defrag_bytes",
+	"streaming_upload_bytes",
+	"streaming_demotions",
+	"descriptor_sets",
+	"descriptor_pools",
+	"pipelines_created",
+	"pipeline_binds",
+	"debugui_glyphs",
+	"debugui_shapes"
+};
+
+void
+StatsNextFrame (void)
+{
+	::memcpy (last_frame, gStatCounters, sizeof (last_frame));
+	::memset (gStatCounters, 0, sizeof (gStatCounters));
+}
+
+const uint64_t *
+StatsGetLastFrame (void)
+{
+	return last_frame;
+}
+
+const char *
+StatGetName (StatCounter counter)
+{
+	return stat_names[counter];
+}
+
+}
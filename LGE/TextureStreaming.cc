@@ -0,0 +1,919 @@
+/**
+ * Texture streaming.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGETextureStreaming"
+
+#include <LGE/Application.h>
+#include <LGE/AsyncIO.h>
+#include <LGE/GPUMemory.h>
+#include <LGE/KTX.h>
+#include <LGE/Log.h>
+#include <LGE/Stats.h>
+#include <LGE/TextureStreaming.h>
+#include <LGE/Trace.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace LGE {
+
+struct StreamedTexture_T {
+	std::string m_path;
+	KTX2Info m_info;
+
+	GPUImage m_image;
+	VkImageView m_view = VK_NULL_HANDLE;
+
+	/** Level of the file that is level 0 of m_image. */
+	uint32_t m_residentLevel = 0;
+
+	/** Level of the file down to which the texture is always resident. */
+	uint32_t m_tailLevel = 0;
+
+	/** Levels m_tailLevel and up, until they have been uploaded. */
+	std::vector<uint8_t> m_tailData;
+
+	float m_screenSize = 0.0f;
+
+	StreamedTextureCallback m_callback = nullptr;
+	void *m_user = nullptr;
+
+	/** A read for this texture is queued, in progress or completed. */
+	bool m_readPending = false;
+
+	/** Reading from the file has failed; it is not tried again. */
+	bool m_failed = false;
+
+	/** StreamedTextureDestroy was called while a read was pending. */
+	bool m_destroyed = false;
+};
+
+/** A range of the staging ring that a read goes into. */
+struct RingBlock {
+	size_t m_offset;
+	size_t m_size;
+
+	/** The read has been applied or dropped. */
+	bool m_released = false;
+
+	/** The commands of frame m_frame copy from the block. */
+	bool m_gpuUsed = false;
+	uint64_t m_frame = 0;
+};
+
+/** An asynchronous read of one mip level of a texture. */
+struct StreamRead {
+	StreamedTexture_T *m_texture;
+	uint32_t m_level;
+	float m_priority;
+	int m_fd;
+
+	/** Where the level is read to; m_data if the level is too large. */
+	RingBlock *m_block = nullptr;
+	std::vector<uint8_t> m_data;
+
+	bool m_done = false;
+	bool m_ok = false;
+};
+
+struct PendingDestroy {
+	GPUImage m_image;
+	VkImageView m_view;
+
+	/** Bytes that destroying the image gives back, for demotion. */
+	VkDeviceSize m_bytes;
+
+	uint64_t m_frame;
+};
+
+/** Reads that are submitted, or completed but not applied yet. */
+static constexpr uint32_t MAX_READS_IN_FLIGHT = 8;
+
+/** Levels are read straight into this buffer, which the GPU copies from. */
+static constexpr size_t STAGING_RING_SIZE = 32 << 20;
+static constexpr size_t STAGING_RING_ALIGNMENT = 256;
+
+/** Header and level index of a 2D texture with the largest mip chain. */
+static constexpr size_t MAX_HEADER_SIZE = KTX2_HEADER_SIZE + 32 * sizeof (KTX2Level);
+
+static std::vector<StreamRead *> reads_in_flight;
+
+static GPUBuffer staging_ring;
+static uint8_t *staging_mapped = nullptr;
+
+/** Blocks of the staging ring in use, in the order they were allocated. */
+static std::deque<RingBlock> ring_blocks;
+
+static std::vector<StreamedTexture_T *> textures;
+static std::vector<PendingDestroy> pending_destroys;
+
+static size_t upload_budget = 8 << 20;
+static float memory_threshold = 0.9f;
+
+static VkExtent3D
+level_extent (const KTX2Info &info, uint32_t level)
+{
+	VkExtent3D extent;
+	extent.width = std::max (info.m_extent.width >> level, 1u);
+	extent.height = std::max (info.m_extent.height >> level, 1u);
+	extent.depth = 1;
+	return extent;
+}
+
+/** Size of levels first_level up to end_level of the file. */
+static VkDeviceSize
+levels_size (const KTX2Info &info, uint32_t first_level, uint32_t end_level)
+{
+	VkDeviceSize size = 0;
+	for (uint32_t level = first_level; level < end_level; level++)
+		size += info.m_levels[level].byteLength;
+
+	return size;
+}
+
+static VkDeviceSize
+image_size (const StreamedTexture_T *texture)
+{
+	return levels_size (texture->m_info, texture->m_residentLevel,
+		(uint32_t) texture->m_info.m_levels.size ());
+}
+
+static bool
+read_fully (int fd, void *data, size_t size, uint64_t offset)
+{
+	uint8_t *p = (uint8_t *) data;
+	while (size) {
+		ssize_t n = ::pread (fd, p, size, (off_t) offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+
+		p += n;
+		size -= (size_t) n;
+		offset += (uint64_t) n;
+	}
+
+	return true;
+}
+
+/**
+ * Read levels first_level up to end_level of the file into data, one after
+ * the other.
+ */
+static bool
+read_levels (int fd, const KTX2Info &info, uint32_t first_level, uint32_t end_level,
+	std::vector<uint8_t> &data)
+{
+	data.resize (levels_size (info, first_level, end_level));
+
+	size_t offset = 0;
+	for (uint32_t level = first_level; level < end_level; level++) {
+		const KTX2Level &l = info.m_levels[level];
+		if (!read_fully (fd, &data[offset], l.byteLength, l.byteOffset))
+			return false;
+
+		offset += l.byteLength;
+	}
+
+	return true;
+}
+
+/**
+ * Allocate a block of the staging ring. Returns nullptr if the ring is full.
+ */
+static RingBlock *
+ring_alloc (size_t size)
+{
+	size = (size + STAGING_RING_ALIGNMENT - 1) & ~(STAGING_RING_ALIGNMENT - 1);
+
+	size_t offset = 0;
+	if (!ring_blocks.empty ()) {
+		const RingBlock &first = ring_blocks.front ();
+		const RingBlock &last = ring_blocks.back ();
+		size_t end = last.m_offset + last.m_size;
+		if (last.m_offset < first.m_offset) {
+			// The blocks in use wrap around the end of the ring.
+			if (end + size > first.m_offset)
+				return nullptr;
+
+			offset = end;
+		} else if (end + size <= STAGING_RING_SIZE) {
+			offset = end;
+		} else if (size > first.m_offset) {
+			return nullptr;
+		}
+	}
+
+	RingBlock block;
+	block.m_offset = offset;
+	block.m_size = size;
+	ring_blocks.push_back (block);
+	return &ring_blocks.back ();
+}
+
+/** Free the blocks that are no longer read by the CPU nor the GPU. */
+static void
+ring_retire (void)
+{
+	uint64_t frame = MMGetFrameIndex ();
+	while (!ring_blocks.empty ()) {
+		const RingBlock &block = ring_blocks.front ();
+		if (!block.m_released || (block.m_gpuUsed && frame < block.m_frame + CPU_RENDER_AHEAD))
+			break;
+
+		ring_blocks.pop_front ();
+	}
+}
+
+static void
+create_staging_ring (void)
+{
+	void *mapped;
+	staging_ring = MMCreateMappedGPUBuffer (STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		&mapped);
+	staging_mapped = (uint8_t *) mapped;
+
+	// Pinned once, instead of for every read.
+	AsyncIORegisterBuffer (staging_mapped, STAGING_RING_SIZE);
+}
+
+static void
+read_done (void *user, bool ok)
+{
+	StreamRead *read = (StreamRead *) user;
+	::close (read->m_fd);
+	read->m_done = true;
+	read->m_ok = ok;
+}
+
+/** Forget a read once it has been applied or dropped. */
+static void
+finish_read (StreamRead *read)
+{
+	if (read->m_block)
+		read->m_block->m_released = true;
+
+	reads_in_flight.erase (std::find (reads_in_flight.begin (), reads_in_flight.end (), read));
+	delete read;
+}
+
+static void
+destroy_image (GPUImage &image, VkImageView view)
+{
+	if (view != VK_NULL_HANDLE)
+		::vkDestroyImageView (gVkDevice, view, nullptr);
+
+	MMDestroyGPUImage (image);
+}
+
+/**
+ * Destroy the image of a texture once the frames in flight have completed.
+ * pending_destroys must have room for one more element.
+ */
+static void
+release_image (StreamedTexture_T *texture, VkDeviceSize freed_bytes)
+{
+	PendingDestroy pending;
+	pending.m_image = texture->m_image;
+	pending.m_view = texture->m_view;
+	pending.m_bytes = freed_bytes;
+	pending.m_frame = MMGetFrameIndex ();
+	pending_destroys.push_back (pending);
+
+	texture->m_image = {};
+	texture->m_view = VK_NULL_HANDLE;
+}
+
+/** Create an image for levels first_level and up of the texture. */
+static void
+create_image (const StreamedTexture_T *texture, uint32_t first_level, GPUImage &image,
+	VkImageView &view)
+{
+	const KTX2Info &info = texture->m_info;
+	image = MMCreateGPUImage (VK_IMAGE_TYPE_2D, level_extent (info, first_level),
+		info.m_format, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+		| VK_IMAGE_USAGE_TRANSFER_DST_BIT, MMMemoryClass::TEXTURE,
+		(uint32_t) info.m_levels.size () - first_level, info.m_layers, info.m_flags);
+
+	try {
+		view = MMCreateImageView (image);
+	} catch (...) {
+		MMDestroyGPUImage (image);
+		throw;
+	}
+}
+
+/**
+ * Record a copy of levels first_level up to end_level of the file, from a
+ * buffer that holds them one after the other starting at offset, to an image
+ * in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL whose level 0 is image_level.
+ */
+static void
+copy_levels (VkCommandBuffer cmd, const KTX2Info &info, VkBuffer buffer, VkDeviceSize offset,
+	VkImage image, uint32_t image_level, uint32_t first_level, uint32_t end_level)
+{
+	// Every level holds all layers and faces, which is what a region
+	// with all array layers expects.
+	std::vector<VkBufferImageCopy> regions;
+	for (uint32_t level = first_level; level < end_level; level++) {
+		VkBufferImageCopy region {};
+		region.bufferOffset = offset;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = level - image_level;
+		region.imageSubresource.layerCount = info.m_layers;
+		region.imageExtent = level_extent (info, level);
+		regions.push_back (region);
+
+		offset += info.m_levels[level].byteLength;
+	}
+
+	vkCmdCopyBufferToImage (cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		(uint32_t) regions.size (), regions.data ());
+}
+
+/** Record the upload of the levels that were read by StreamedTextureCreate. */
+static size_t
+upload_tail (VkCommandBuffer cmd, StreamedTexture_T *texture)
+{
+	const KTX2Info &info = texture->m_info;
+	size_t size = texture->m_tailData.size ();
+	VkBuffer staging = MMCreateTemporaryGPUBuffer (texture->m_tailData.data (), size,
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+	VkImageMemoryBarrier barrier {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = texture->m_image.m_image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = texture->m_image.m_mipLevels;
+	barrier.subresourceRange.layerCount = texture->m_image.m_arrayLayers;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	copy_levels (cmd, info, staging, 0, texture->m_image.m_image, texture->m_tailLevel,
+		texture->m_tailLevel, (uint32_t) info.m_levels.size ());
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier);
+
+	texture->m_tailData.clear ();
+	texture->m_tailData.shrink_to_fit ();
+	StatAdd (STAT_STREAMING_UPLOAD_BYTES, size);
+	return size;
+}
+
+/**
+ * Replace the image of a texture with one whose level 0 is first_level of
+ * the file. The levels that both images have are copied on the GPU. When
+ * promoting by one level, the new level is copied from buffer at offset.
+ * Returns false if the new image could not be allocated.
+ */
+static bool
+replace_image (VkCommandBuffer cmd, StreamedTexture_T *texture, uint32_t first_level,
+	VkBuffer buffer, VkDeviceSize offset)
+{
+	const KTX2Info &info = texture->m_info;
+	uint32_t num_levels = (uint32_t) info.m_levels.size ();
+	uint32_t old_level = texture->m_residentLevel;
+	uint32_t copy_level = std::max (first_level, old_level);
+
+	// Nothing may throw once the copies have been recorded.
+	pending_destroys.reserve (pending_destroys.size () + 1);
+
+	GPUImage image;
+	VkImageView view;
+	try {
+		create_image (texture, first_level, image, view);
+	} catch (const std::exception &e) {
+		LGE_LOG_WARNING ("Cannot allocate level %u of %s: %s", first_level,
+			texture->m_path.c_str (), e.what ());
+		return false;
+	}
+
+	VkImageMemoryBarrier barriers[2] {};
+	for (VkImageMemoryBarrier &b : barriers) {
+		b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		b.subresourceRange.layerCount = info.m_layers;
+	}
+
+	barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[0].image = texture->m_image.m_image;
+	barriers[0].subresourceRange.levelCount = texture->m_image.m_mipLevels;
+	barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].image = image.m_image;
+	barriers[1].subresourceRange.levelCount = image.m_mipLevels;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		2, barriers);
+
+	std::vector<VkImageCopy> regions;
+	for (uint32_t level = copy_level; level < num_levels; level++) {
+		VkImageCopy region {};
+		region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.srcSubresource.mipLevel = level - old_level;
+		region.srcSubresource.layerCount = info.m_layers;
+		region.dstSubresource = region.srcSubresource;
+		region.dstSubresource.mipLevel = level - first_level;
+		region.extent = level_extent (info, level);
+		regions.push_back (region);
+	}
+
+	vkCmdCopyImage (cmd, texture->m_image.m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		image.m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		(uint32_t) regions.size (), regions.data ());
+
+	if (buffer)
+		copy_levels (cmd, info, buffer, offset, image.m_image, first_level, first_level,
+			old_level);
+
+	// The old image goes back to being sampled, so that descriptor sets
+	// which still refer to it stay valid until it is destroyed.
+	barriers[0].srcAccessMask = 0;
+	barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier (cmd,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		2, barriers);
+
+	VkDeviceSize old_size = image_size (texture);
+	VkDeviceSize new_size = levels_size (info, first_level, num_levels);
+	release_image (texture, (old_size > new_size) ? old_size - new_size : 0);
+
+	texture->m_image = image;
+	texture->m_view = view;
+	texture->m_residentLevel = first_level;
+	if (texture->m_callback)
+		texture->m_callback (texture->m_user);
+
+	return true;
+}
+
+/** The finest level that the texture needs for its size on screen. */
+static uint32_t
+wanted_level (const StreamedTexture_T *texture)
+{
+	if (!(texture->m_screenSize > 0.0f))
+		return texture->m_tailLevel;
+
+	const KTX2Info &info = texture->m_info;
+	float size = (float) std::max (info.m_extent.width, info.m_extent.height);
+	float level = ::floorf (::log2f (size / texture->m_screenSize));
+	if (!(level > 0.0f))
+		return 0;
+
+	return (uint32_t) std::min (level, (float) texture->m_tailLevel);
+}
+
+/**
+ * Texels on screen per texel of the resident level 0. Textures with the
+ * highest value are the most blurry and are streamed in first; those with the
+ * lowest are demoted first.
+ */
+static float
+texture_priority (const StreamedTexture_T *texture)
+{
+	VkExtent3D extent = level_extent (texture->m_info, texture->m_residentLevel);
+	return texture->m_screenSize / (float) std::max (extent.width, extent.height);
+}
+
+/**
+ * Get by how many bytes the most used device-local heap is above the
+ * threshold.
+ */
+static VkDeviceSize
+memory_excess (void)
+{
+	MMStats stats;
+	MMGetStats (stats);
+
+	VkDeviceSize excess = 0;
+	for (uint32_t i = 0; i < stats.m_numHeaps; i++) {
+		const MMHeapStats &heap = stats.m_heaps[i];
+		if (!(heap.m_flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+			continue;
+
+		VkDeviceSize threshold = (VkDeviceSize) ((double) memory_threshold * (double) heap.m_budget);
+		if (heap.m_usage > threshold)
+			excess = std::max (excess, heap.m_usage - threshold);
+	}
+
+	return excess;
+}
+
+/** Upload levels that have been read, within the upload budget. */
+static void
+apply_reads (VkCommandBuffer cmd, size_t uploaded, bool low_memory)
+{
+	AsyncIOPoll ();
+
+	std::vector<StreamRead *> reads;
+	for (StreamRead *read : reads_in_flight)
+		if (read->m_done)
+			reads.push_back (read);
+
+	std::sort (reads.begin (), reads.end (), [] (const StreamRead *a, const StreamRead *b) {
+		return a->m_priority > b->m_priority;
+	});
+
+	for (StreamRead *read : reads) {
+		StreamedTexture_T *texture = read->m_texture;
+		if (texture->m_destroyed) {
+			delete texture;
+			finish_read (read);
+			continue;
+		}
+
+		// A read is stale if the texture was demoted in the meantime.
+		bool usable = read->m_ok && !low_memory && read->m_level + 1 == texture->m_residentLevel;
+		size_t size = texture->m_info.m_levels[read->m_level].byteLength;
+		if (usable && uploaded && uploaded + size > upload_budget)
+			continue;
+
+		texture->m_readPending = false;
+		if (!read->m_ok) {
+			LGE_LOG_WARNING ("Cannot read level %u of %s", read->m_level, texture->m_path.c_str ());
+			texture->m_failed = true;
+			finish_read (read);
+			continue;
+		}
+
+		if (usable) {
+			VkBuffer buffer;
+			VkDeviceSize offset = 0;
+			if (read->m_block) {
+				offset = read->m_block->m_offset;
+				MMFlushMappedGPUBuffer (staging_ring, offset, size);
+				buffer = staging_ring.m_buffer;
+			} else {
+				buffer = MMCreateTemporaryGPUBuffer (read->m_data.data (), size,
+					VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+			}
+
+			if (replace_image (cmd, texture, read->m_level, buffer, offset)) {
+				uploaded += size;
+				StatAdd (STAT_STREAMING_UPLOAD_BYTES, size);
+				if (read->m_block) {
+					read->m_block->m_gpuUsed = true;
+					read->m_block->m_frame = MMGetFrameIndex ();
+				}
+			}
+		}
+
+		finish_read (read);
+	}
+}
+
+/**
+ * Drop one level from textures, starting with the most oversampled, until
+ * enough memory is on its way to being freed.
+ */
+static void
+demote (VkCommandBuffer cmd, VkDeviceSize excess)
+{
+	// Images that are waiting for the frames in flight still count towards
+	// the usage of the heap.
+	for (const PendingDestroy &pending : pending_destroys)
+		excess -= std::min (excess, pending.m_bytes);
+
+	if (!excess)
+		return;
+
+	std::vector<StreamedTexture_T *> candidates;
+	for (StreamedTexture_T *texture : textures)
+		if (texture->m_residentLevel < texture->m_tailLevel)
+			candidates.push_back (texture);
+
+	std::sort (candidates.begin (), candidates.end (),
+		[] (const StreamedTexture_T *a, const StreamedTexture_T *b) {
+			return texture_priority (a) < texture_priority (b);
+		});
+
+	for (StreamedTexture_T *texture : candidates) {
+		VkDeviceSize freed = texture->m_info.m_levels[texture->m_residentLevel].byteLength;
+		if (!replace_image (cmd, texture, texture->m_residentLevel + 1, VK_NULL_HANDLE, 0))
+			break;
+
+		StatAdd (STAT_STREAMING_DEMOTIONS);
+		excess -= std::min (excess, freed);
+		if (!excess)
+			break;
+	}
+}
+
+/**
+ * Start the read of the next level of a texture. Returns false if there is
+ * no room for it in the staging ring.
+ */
+static bool
+start_read (StreamedTexture_T *texture, std::vector<AsyncIORead> &batch)
+{
+	std::unique_ptr<StreamRead> read (new StreamRead);
+	read->m_texture = texture;
+	read->m_level = texture->m_residentLevel - 1;
+	read->m_priority = texture_priority (texture);
+
+	const KTX2Level &level = texture->m_info.m_levels[read->m_level];
+	void *buffer;
+	if (level.byteLength > STAGING_RING_SIZE / 2) {
+		// Rare enough that it is not worth keeping the ring that large.
+		read->m_data.resize (level.byteLength);
+		buffer = read->m_data.data ();
+	} else {
+		read->m_block = ring_alloc (level.byteLength);
+		if (!read->m_block)
+			return false;
+
+		buffer = staging_mapped + read->m_block->m_offset;
+	}
+
+	read->m_fd = ::open (texture->m_path.c_str (), O_RDONLY | O_CLOEXEC);
+	if (read->m_fd < 0) {
+		LGE_LOG_WARNING ("Cannot open %s", texture->m_path.c_str ());
+		texture->m_failed = true;
+		if (read->m_block)
+			read->m_block->m_released = true;
+
+		return true;
+	}
+
+	AsyncIORead r;
+	r.m_fd = read->m_fd;
+	r.m_buffer = buffer;
+	r.m_size = level.byteLength;
+	r.m_offset = level.byteOffset;
+	r.m_callback = read_done;
+	r.m_user = read.get ();
+	batch.push_back (r);
+
+	texture->m_readPending = true;
+	reads_in_flight.push_back (read.release ());
+	return true;
+}
+
+/**
+ * Read the next level of the textures that need it, the most blurry first.
+ * The reads are submitted as one batch.
+ */
+static void
+queue_reads (void)
+{
+	if (reads_in_flight.size () >= MAX_READS_IN_FLIGHT)
+		return;
+
+	std::vector<StreamedTexture_T *> candidates;
+	for (StreamedTexture_T *texture : textures)
+		if (!texture->m_readPending && !texture->m_failed
+			&& wanted_level (texture) < texture->m_residentLevel)
+			candidates.push_back (texture);
+
+	if (candidates.empty ())
+		return;
+
+	std::sort (candidates.begin (), candidates.end (),
+		[] (const StreamedTexture_T *a, const StreamedTexture_T *b) {
+			return texture_priority (a) > texture_priority (b);
+		});
+
+	if (!staging_mapped)
+		create_staging_ring ();
+
+	std::vector<AsyncIORead> batch;
+	batch.reserve (MAX_READS_IN_FLIGHT);
+	for (StreamedTexture_T *texture : candidates) {
+		if (reads_in_flight.size () >= MAX_READS_IN_FLIGHT || !start_read (texture, batch))
+			break;
+	}
+
+	if (!batch.empty ())
+		AsyncIOSubmit (batch.data (), (uint32_t) batch.size ());
+}
+
+StreamedTexture
+StreamedTextureCreate (const char *path, uint32_t min_resident_size)
+{
+	LGE_TRACE_SCOPE ("StreamedTextureCreate");
+
+	std::unique_ptr<StreamedTexture_T> texture (new StreamedTexture_T);
+	texture->m_path = path;
+	KTX2Info &info = texture->m_info;
+
+	int fd = ::open (path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		throw std::runtime_error (std::string ("StreamedTextureCreate: cannot open ") + path);
+
+	try {
+		struct stat st;
+		if (::fstat (fd, &st))
+			throw std::runtime_error (std::string ("StreamedTextureCreate: cannot stat ") + path);
+
+		uint8_t header[MAX_HEADER_SIZE];
+		size_t header_size = (size_t) std::min ((uint64_t) st.st_size, (uint64_t) sizeof (header));
+		if (!read_fully (fd, header, header_size, 0))
+			throw std::runtime_error (std::string ("StreamedTextureCreate: cannot read ") + path);
+
+		ReadKTX2Info (header, header_size, (uint64_t) st.st_size, path, info);
+		if (info.m_generateMipmaps)
+			throw std::runtime_error (std::string ("StreamedTextureCreate: ") + path + ": the file has no mip levels");
+
+		uint32_t num_levels = (uint32_t) info.m_levels.size ();
+		uint32_t tail = 0;
+		for (; tail + 1 < num_levels; tail++) {
+			VkExtent3D extent = level_extent (info, tail);
+			if (std::max (extent.width, extent.height) <= min_resident_size)
+				break;
+		}
+
+		texture->m_tailLevel = tail;
+		texture->m_residentLevel = tail;
+		if (!read_levels (fd, info, tail, num_levels, texture->m_tailData))
+			throw std::runtime_error (std::string ("StreamedTextureCreate: cannot read ") + path);
+	} catch (...) {
+		::close (fd);
+		throw;
+	}
+
+	::close (fd);
+
+	// The contents are uploaded by the next TextureStreamingNextFrame.
+	create_image (texture.get (), texture->m_tailLevel, texture->m_image, texture->m_view);
+	try {
+		textures.push_back (texture.get ());
+	} catch (...) {
+		destroy_image (texture->m_image, texture->m_view);
+		throw;
+	}
+
+	return texture.release ();
+}
+
+void
+StreamedTextureDestroy (StreamedTexture texture)
+{
+	release_image (texture, image_size (texture));
+	textures.erase (std::find (textures.begin (), textures.end (), texture));
+
+	// A read of the texture is in flight, or has completed but was not
+	// applied yet. apply_reads deletes it.
+	if (texture->m_readPending)
+		texture->m_destroyed = true;
+	else
+		delete texture;
+}
+
+void
+StreamedTextureSetPriority (StreamedTexture texture, float screen_size)
+{
+	texture->m_screenSize = screen_size;
+}
+
+VkImageView
+StreamedTextureGetView (StreamedTexture texture)
+{
+	return texture->m_view;
+}
+
+uint32_t
+StreamedTextureGetResidentLevel (StreamedTexture texture)
+{
+	return texture->m_residentLevel;
+}
+
+void
+StreamedTextureSetCallback (StreamedTexture texture, StreamedTextureCallback callback,
+	void *user)
+{
+	texture->m_callback = callback;
+	texture->m_user = user;
+}
+
+void
+TextureStreamingSetUploadBudget (size_t bytes_per_frame)
+{
+	upload_budget = bytes_per_frame;
+}
+
+void
+TextureStreamingSetMemoryThreshold (float threshold)
+{
+	memory_threshold = threshold;
+}
+
+void
+TextureStreamingNextFrame (VkCommandBuffer cmd)
+{
+	LGE_TRACE_SCOPE ("TextureStreamingNextFrame");
+
+	uint64_t frame = MMGetFrameIndex ();
+	size_t kept = 0;
+	for (PendingDestroy &pending : pending_destroys) {
+		if (frame >= pending.m_frame + CPU_RENDER_AHEAD)
+			destroy_image (pending.m_image, pending.m_view);
+		else
+			pending_destroys[kept++] = pending;
+	}
+
+	pending_destroys.resize (kept);
+	ring_retire ();
+
+	// New textures are uploaded regardless of the budget, as they have
+	// nothing to show until then.
+	size_t uploaded = 0;
+	for (StreamedTexture_T *texture : textures)
+		if (!texture->m_tailData.empty ())
+			uploaded += upload_tail (cmd, texture);
+
+	VkDeviceSize excess = memory_excess ();
+	apply_reads (cmd, uploaded, excess != 0);
+	if (excess)
+		demote (cmd, excess);
+	else
+		queue_reads ();
+}
+
+void
+TextureStreamingTerminate (void)
+{
+	AsyncIOWait ();
+	while (!reads_in_flight.empty ()) {
+		StreamRead *read = reads_in_flight.back ();
+		if (read->m_texture->m_destroyed)
+			delete read->m_texture;
+		else
+			read->m_texture->m_readPending = false;
+
+		finish_read (read);
+	}
+
+	ring_blocks.clear ();
+	if (staging_mapped) {
+		AsyncIOUnregisterBuffer (staging_mapped);
+		MMDestroyGPUBuffer (staging_ring);
+		staging_mapped = nullptr;
+	}
+
+	for (StreamedTexture_T *texture : textures) {
+		destroy_image (texture->m_image, texture->m_view);
+		delete texture;
+	}
+
+	textures.clear ();
+
+	for (PendingDestroy &pending : pending_destroys)
+		destroy_image (pending.m_image, pending.m_view);
+
+	pending_destroys.clear ();
+}
+
+}
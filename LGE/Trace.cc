@@ -0,0 +1,416 @@
+/**
+ * CPU and GPU timeline tracing.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "LGETrace"
+
+#include <LGE/Application.h>
+#include <LGE/Log.h>
+#include <LGE/Trace.h>
+#include <LGE/VulkanFunctions.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+namespace LGE {
+
+static constexpr uint64_t EVENTS_PER_THREAD = 16384;
+
+/**
+ * Events are read by the capture writer while the owning thread may be
+ * overwriting them, so the fields are atomics, accessed with relaxed order.
+ */
+struct TraceEvent {
+	std::atomic<const char *> name;
+	std::atomic<uint64_t> begin;
+	std::atomic<uint64_t> end;
+	std::atomic<uint32_t> depth;
+};
+
+/**
+ * Single-producer ring buffer, read like a seqlock. Before the owning thread
+ * writes event n, it advances m_writing to n + 1, followed by a release
+ * fence, so that a reader that sees any of the new fields also sees the new
+ * m_writing. It then publishes the event by advancing m_head with a release
+ * store. Readers acquire m_head, copy events below it, and after an acquire
+ * fence check m_writing to discard events that were overwritten meanwhile.
+ *
+ * Buffers are never freed. When a thread exits, its buffer is handed back to
+ * free_buffers, and the next new thread continues in it, so short-lived
+ * threads do not leak buffers.
+ */
+struct TraceThreadBuffer {
+	std::atomic<uint64_t> m_head { 0 };
+	std::atomic<uint64_t> m_writing { 0 };
+	uint32_t m_depth = 0;
+	uint32_t m_tid;
+	char m_name[32] {};
+	TraceEvent m_events[EVENTS_PER_THREAD];
+};
+
+static std::mutex buffers_lock;
+static std::vector<TraceThreadBuffer *> buffers;
+static std::vector<TraceThreadBuffer *> free_buffers;
+static thread_local TraceThreadBuffer *tls_buffer = nullptr;
+
+/** Hands the buffer of the thread back to free_buffers when the thread exits. */
+struct ThreadBufferOwner {
+	TraceThreadBuffer *m_buffer = nullptr;
+
+	~ThreadBufferOwner (void)
+	{
+		if (!m_buffer)
+			return;
+
+		m_buffer->m_depth = 0;
+		tls_buffer = nullptr;
+		std::lock_guard<std::mutex> lock (buffers_lock);
+		free_buffers.push_back (m_buffer);
+	}
+};
+
+static thread_local ThreadBufferOwner tls_owner;
+
+static TraceThreadBuffer *
+get_thread_buffer (void)
+{
+	if (tls_buffer)
+		return tls_buffer;
+
+	std::lock_guard<std::mutex> lock (buffers_lock);
+	TraceThreadBuffer *buffer;
+	if (!free_buffers.empty ()) {
+		buffer = free_buffers.back ();
+		free_buffers.pop_back ();
+	} else {
+		buffer = new TraceThreadBuffer;
+		buffer->m_tid = buffers.size () + 1;
+		buffers.push_back (buffer);
+	}
+
+	::snprintf (buffer->m_name, sizeof (buffer->m_name), "Thread %u", buffer->m_tid);
+	tls_owner.m_buffer = buffer;
+	tls_buffer = buffer;
+	return buffer;
+}
+
+uint64_t
+TraceNow (void)
+{
+	struct timespec ts;
+	::clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+uint64_t
+TraceBeginScope (void)
+{
+	get_thread_buffer ()->m_depth++;
+	return TraceNow ();
+}
+
+void
+TraceEndScope (const char *name, uint64_t begin)
+{
+	uint64_t end = TraceNow ();
+	TraceThreadBuffer *buffer = tls_buffer;
+
+	uint64_t head = buffer->m_head.load (std::memory_order_relaxed);
+	buffer->m_writing.store (head + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence (std::memory_order_release);
+
+	TraceEvent &e = buffer->m_events[head % EVENTS_PER_THREAD];
+	e.name.store (name, std::memory_order_relaxed);
+	e.begin.store (begin, std::memory_order_relaxed);
+	e.end.store (end, std::memory_order_relaxed);
+	e.depth.store (--buffer->m_depth, std::memory_order_relaxed);
+	buffer->m_head.store (head + 1, std::memory_order_release);
+}
+
+void
+TraceSetThreadName (const char *name)
+{
+	TraceThreadBuffer *buffer = get_thread_buffer ();
+	std::lock_guard<std::mutex> lock (buffers_lock);
+	::snprintf (buffer->m_name, sizeof (buffer->m_name), "%s", name);
+}
+
+/**
+ * Capture state. This is only accessed from the thread running the event
+ * loop, which is also the thread that resolves GPU profiler results.
+ */
+
+enum class CaptureState {
+	IDLE,
+	PENDING,
+	CAPTURING,
+	DRAINING
+};
+
+struct GPUTraceEvent {
+	const char *name;
+	uint32_t depth;
+	uint64_t begin, end;
+};
+
+static CaptureState state = CaptureState::IDLE;
+static uint32_t frames_left;
+static std::string capture_path;
+static uint64_t capture_begin, capture_end;
+static std::vector<uint64_t> frame_marks;
+static std::vector<GPUTraceEvent> gpu_events;
+
+/**
+ * GPU clock to CPU clock conversion: cpu_ns = gpu_ns + gpu_offset.
+ */
+static bool gpu_calibrated = false;
+static bool gpu_offset_valid = false;
+static int64_t gpu_offset;
+
+/**
+ * Get a pair of (GPU, CPU) timestamps taken at the same instant using
+ * VK_EXT_calibrated_timestamps.
+ */
+static bool
+calibrate_gpu_clock (void)
+{
+	if (!IsDeviceExtensionEnabled (VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+		return false;
+
+	auto get_domains = (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)
+		::vkGetInstanceProcAddr (gVkInstance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+	auto get_timestamps = (PFN_vkGetCalibratedTimestampsEXT)
+		::vkGetDeviceProcAddr (gVkDevice, "vkGetCalibratedTimestampsEXT");
+	if (!get_domains || !get_timestamps)
+		return false;
+
+	uint32_t count = 0;
+	if (get_domains (gVkPhysicalDevice, &count, nullptr) != VK_SUCCESS)
+		return false;
+
+	std::vector<VkTimeDomainEXT> domains (count);
+	if (get_domains (gVkPhysicalDevice, &count, domains.data ()) != VK_SUCCESS)
+		return false;
+
+	bool has_device = false, has_monotonic = false;
+	for (VkTimeDomainEXT domain : domains) {
+		if (domain == VK_TIME_DOMAIN_DEVICE_EXT)
+			has_device = true;
+		else if (domain == VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT)
+			has_monotonic = true;
+	}
+
+	if (!has_device || !has_monotonic)
+		return false;
+
+	VkCalibratedTimestampInfoEXT infos[2] {};
+	infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+	infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+	infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+	infos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+
+	uint64_t timestamps[2];
+	uint64_t max_deviation;
+	if (get_timestamps (gVkDevice, 2, infos, timestamps, &max_deviation) != VK_SUCCESS)
+		return false;
+
+	VkPhysicalDeviceProperties props;
+	::vkGetPhysicalDeviceProperties (gVkPhysicalDevice, &props);
+
+	uint64_t gpu_ns = (uint64_t) ((double) props.limits.timestampPeriod * timestamps[0]);
+	gpu_offset = (int64_t) timestamps[1] - (int64_t) gpu_ns;
+	return true;
+}
+
+void
+TraceCapture (uint32_t frames, const char *path)
+{
+	if (state != CaptureState::IDLE) {
+		LGE_LOG_WARNING ("a trace capture is already in progress");
+		return;
+	}
+
+	if (!frames)
+		return;
+
+	frames_left = frames;
+	capture_path = path;
+	state = CaptureState::PENDING;
+}
+
+bool
+TraceIsCapturing (void)
+{
+	return state == CaptureState::CAPTURING || state == CaptureState::DRAINING;
+}
+
+void
+TraceGPUEvent (const char *name, uint32_t depth, uint64_t begin_ns, uint64_t end_ns)
+{
+	if (!TraceIsCapturing ())
+		return;
+
+	if (!gpu_offset_valid)
+		return;
+
+	GPUTraceEvent e;
+	e.name = name;
+	e.depth = depth;
+	e.begin = begin_ns + gpu_offset;
+	e.end = end_ns + gpu_offset;
+	if (e.begin < capture_begin || e.begin >= capture_end)
+		return;
+
+	gpu_events.push_back (e);
+}
+
+void
+TraceGPUFrame (uint64_t cpu_ns, uint64_t gpu_ns)
+{
+	if (!TraceIsCapturing () || gpu_calibrated)
+		return;
+
+	gpu_offset = (int64_t) cpu_ns - (int64_t) gpu_ns;
+	gpu_offset_valid = true;
+}
+
+void
+TraceWriteJSONString (FILE *f, const char *s)
+{
+	::fputc ('"', f);
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\')
+			::fputc ('\\', f);
+		if ((unsigned char) *s >= 0x20)
+			::fputc (*s, f);
+	}
+	::fputc ('"', f);
+}
+
+static void
+write_capture (void)
+{
+	FILE *f = ::fopen (capture_path.c_str (), "w");
+	if (!f) {
+		Log ("Failed to open %s for writing", capture_path.c_str ());
+		return;
+	}
+
+	static constexpr uint32_t GPU_TID = 0xffff;
+	auto ts = [](uint64_t t) -> double {
+		return 1.0e-3 * (double) (int64_t) (t - capture_begin);
+	};
+
+	::fprintf (f, "{\"traceEvents\":[\n");
+	::fprintf (f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"LGE\"}},\n");
+	::fprintf (f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GPU%s\"}},\n",
+		GPU_TID, gpu_calibrated ? "" : " (uncalibrated)");
+
+	std::lock_guard<std::mutex> lock (buffers_lock);
+	for (TraceThreadBuffer *buffer : buffers) {
+		::fprintf (f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+			buffer->m_tid);
+		TraceWriteJSONString (f, buffer->m_name);
+		::fprintf (f, "}},\n");
+
+		uint64_t head = buffer->m_head.load (std::memory_order_acquire);
+		uint64_t first = (head > EVENTS_PER_THREAD) ? head - EVENTS_PER_THREAD : 0;
+		for (uint64_t i = first; i < head; i++) {
+			const TraceEvent &slot = buffer->m_events[i % EVENTS_PER_THREAD];
+			const char *name = slot.name.load (std::memory_order_relaxed);
+			uint64_t begin = slot.begin.load (std::memory_order_relaxed);
+			uint64_t end = slot.end.load (std::memory_order_relaxed);
+
+			// The owning thread may have overwritten the event while we read
+			// it. Event i + EVENTS_PER_THREAD takes its slot, and is
+			// announced by m_writing before any of its fields are written.
+			std::atomic_thread_fence (std::memory_order_acquire);
+			uint64_t writing = buffer->m_writing.load (std::memory_order_relaxed);
+			if (writing > i + EVENTS_PER_THREAD)
+				continue;
+
+			if (begin < capture_begin || begin >= capture_end)
+				continue;
+
+			::fprintf (f, "{\"name\":");
+			TraceWriteJSONString (f, name);
+			::fprintf (f, ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+				buffer->m_tid, ts (begin), 1.0e-3 * (end - begin));
+		}
+	}
+
+	for (const GPUTraceEvent &e : gpu_events) {
+		::fprintf (f, "{\"name\":");
+		TraceWriteJSONString (f, e.name);
+		::fprintf (f, ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+			GPU_TID, ts (e.begin), 1.0e-3 * (e.end - e.begin));
+	}
+
+	for (size_t i = 0; i < frame_marks.size (); i++)
+		::fprintf (f, "{\"name\":\"Frame %zu\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f},\n",
+			i, ts (frame_marks[i]));
+
+	::fprintf (f, "{\"name\":\"Capture end\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}\n",
+		ts (capture_end));
+	::fprintf (f, "],\"displayTimeUnit\":\"ms\"}\n");
+
+	bool ok = !::ferror (f);
+	if (::fclose (f) != 0)
+		ok = false;
+
+	if (ok)
+		Log ("Wrote trace capture to %s", capture_path.c_str ());
+	else
+		Log ("Failed to write trace capture to %s", capture_path.c_str ());
+}
+
+void
+TraceNextFrame (void)
+{
+	uint64_t now = TraceNow ();
+
+	switch (state) {
+	case CaptureState::IDLE:
+		return;
+	case CaptureState::PENDING:
+		state = CaptureState::CAPTURING;
+		capture_begin = now;
+		capture_end = UINT64_MAX;
+		frame_marks.clear ();
+		gpu_events.clear ();
+		gpu_calibrated = calibrate_gpu_clock ();
+		gpu_offset_valid = gpu_calibrated;
+		if (!gpu_calibrated)
+			Log ("VK_EXT_calibrated_timestamps is unavailable; GPU events are aligned to frame submission");
+		break;
+	case CaptureState::CAPTURING:
+		if (--frames_left)
+			break;
+
+		capture_end = now;
+		state = CaptureState::DRAINING;
+
+		// GPU results are resolved CPU_RENDER_AHEAD frames late.
+		frames_left = CPU_RENDER_AHEAD + 1;
+		return;
+	case CaptureState::DRAINING:
+		if (--frames_left)
+			return;
+
+		write_capture ();
+		frame_marks.clear ();
+		gpu_events.clear ();
+		state = CaptureState::IDLE;
+		return;
+	}
+
+	frame_marks.push_back (now);
+}
+
+}
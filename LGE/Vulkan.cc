@@ -36,8 +36,26 @@ VkPhysicalDeviceFeatures gVkFeatures10;
 VkPhysicalDeviceVulkan11Features gVkFeatures11;
 VkPhysicalDeviceVulkan12Features gVkFeatures12;
 VkPhysicalDeviceVulkan13Features gVkFeatures13;
+VkPhysicalDeviceMemoryPriorityFeaturesEXT gVkMemoryPriorityFeatures;
 uint32_t gVkQueueFamily;
 
+/**
+ * Device extensions that we have requested from VKFW, and the subset of them
+ * that is supported by the chosen device.
+ */
+static std::vector<const char *> requested_device_extensions;
+static std::vector<const char *> enabled_device_extensions;
+
+bool
+IsDeviceExtensionEnabled (const char *name)
+{
+	for (const char *ext : enabled_device_extensions)
+		if (!::strcmp (ext, name))
+			return true;
+
+	return false;
+}
+
 bool
 InitializeVulkan (void)
 {
@@ -49,6 +67,8 @@ InitializeVulkan (void)
 	auto device_ext = [&](const char *name, bool required){
 		if (::vkfwRequestDeviceExtension (name, required) != VK_SUCCESS)
 			flag = true;
+		else
+			requested_device_extensions.push_back (name);
 	};
 
 	gVulkanVersion = ::vkfwGetVkInstanceVersion ();
@@ -61,8 +81,14 @@ InitializeVulkan (void)
 		return false;
 	}
 
-	instance_ext (VK_KHR_SURFACE_EXTENSION_NAME, true);
-	device_ext (VK_KHR_SWAPCHAIN_EXTENSION_NAME, true);
+	if (!bIsHeadless) {
+		instance_ext (VK_KHR_SURFACE_EXTENSION_NAME, true);
+		device_ext (VK_KHR_SWAPCHAIN_EXTENSION_NAME, true);
+	}
+
+	device_ext (VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, false);
+	device_ext (VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, false);
+	device_ext (VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME, false);
 	if (flag)
 		return false;
 
@@ -155,13 +181,43 @@ InitializeVulkan (void)
 
 	gVulkanDeviceVersion = props.apiVersion;
 
+	auto find_extensions = [&](void) -> bool {
+		uint32_t count;
+		VkResult result = ::vkEnumerateDeviceExtensionProperties (gVkPhysicalDevice, nullptr, &count, nullptr);
+		if (result != VK_SUCCESS)
+			return false;
+
+		std::vector<VkExtensionProperties> extensions (count);
+		result = ::vkEnumerateDeviceExtensionProperties (gVkPhysicalDevice, nullptr, &count, extensions.data ());
+		if (result != VK_SUCCESS)
+			return false;
+
+		enabled_device_extensions.clear ();
+		for (const char *name : requested_device_extensions)
+			for (const VkExtensionProperties &ext : extensions)
+				if (!::strcmp (ext.extensionName, name))
+					enabled_device_extensions.push_back (name);
+
+		return true;
+	};
+
+	try {
+		if (!find_extensions ())
+			return false;
+	} catch (const std::exception &e) {
+		Log ("find_extensions threw an exception: %s", e.what ());
+		return false;
+	}
+
 	::memset (&gVkFeatures10, 0, sizeof (gVkFeatures10));
 	::memset (&gVkFeatures11, 0, sizeof (gVkFeatures11));
 	::memset (&gVkFeatures12, 0, sizeof (gVkFeatures12));
 	::memset (&gVkFeatures13, 0, sizeof (gVkFeatures13));
+	::memset (&gVkMemoryPriorityFeatures, 0, sizeof (gVkMemoryPriorityFeatures));
 	gVkFeatures11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
 	gVkFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
 	gVkFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+	gVkMemoryPriorityFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
 
 	// VKFW fills in most of DeviceCreateInfo for us.
 	VkDeviceCreateInfo device_ci {};
@@ -177,6 +233,11 @@ InitializeVulkan (void)
 			}
 		}
 
+		if (IsDeviceExtensionEnabled (VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME)) {
+			gVkMemoryPriorityFeatures.pNext = feat2.pNext;
+			feat2.pNext = &gVkMemoryPriorityFeatures;
+		}
+
 		::vkGetPhysicalDeviceFeatures2 (gVkPhysicalDevice, &feat2);
 		gVkFeatures10 = feat2.features;
 
@@ -198,6 +259,8 @@ InitializeVulkan (void)
 			VkQueueFamilyProperties &p = queues[i];
 			if ((p.queueFlags & required_flags) != required_flags)
 				continue;
+			if (bIsHeadless)
+				return i;
 			VkBool32 b;
 			if (::vkfwGetPhysicalDevicePresentSupport (gVkPhysicalDevice, i, &b) != VK_SUCCESS)
 				return UINT32_MAX;
@@ -5,6 +5,8 @@
 #define LGE_MODULE "LGEWindow"
 
 #include <LGE/Application.h>
+#include <LGE/GPUMemory.h>
+#include <LGE/Init.h>
 #include <LGE/Log.h>
 #include <LGE/Vulkan.h>
 #include <LGE/Window.h>
@@ -18,10 +20,22 @@ namespace LGE {
 
 Window *gWindow;
 
+static constexpr VkExtent2D default_extent = { 1280, 720 };
+
+/**
+ * Headless rendering uses a fixed format, so that readback produces RGBA8
+ * pixels regardless of the device.
+ */
+static constexpr VkFormat offscreen_format = VK_FORMAT_R8G8B8A8_UNORM;
+
 Window::Window (void)
+	: m_headless (bIsHeadless)
 {
+	if (m_headless)
+		return;
+
 	VkResult result;
-	if ((result = ::vkfwCreateWindow (&m_wnd, {1280, 720})) != VK_SUCCESS)
+	if ((result = ::vkfwCreateWindow (&m_wnd, default_extent)) != VK_SUCCESS)
 		throw std::runtime_error (std::string ("vkfwCreateWindow returned ") + VulkanTypeToString (result));
 
 	::vkfwSetWindowUserPointer (m_wnd, this);
@@ -42,6 +56,11 @@ Window::Window (void)
 
 Window::~Window (void)
 {
+	if (m_headless) {
+		DestroyOffscreenImages ();
+		return;
+	}
+
 	if (m_swapchain != VK_NULL_HANDLE) {
 		for (uint32_t i = 0; i < m_swapchainSize; i++)
 			vkDestroyImageView (gVkDevice, m_imageViews[i], nullptr);
@@ -55,9 +74,88 @@ Window::~Window (void)
 	::vkfwDestroyWindow (m_wnd);
 }
 
+void
+Window::DestroyOffscreenImages (void)
+{
+	if (!m_offscreenImages)
+		return;
+
+	::vkDeviceWaitIdle (gVkDevice);
+	for (uint32_t i = 0; i < m_swapchainSize; i++) {
+		::vkDestroyImageView (gVkDevice, m_imageViews[i], nullptr);
+		MMDestroyGPUImage (m_offscreenImages[i]);
+	}
+
+	delete[] m_imageViews;
+	delete[] m_images;
+	delete[] m_offscreenImages;
+	m_offscreenImages = nullptr;
+}
+
+void
+Window::CreateOffscreenImages (void)
+{
+	DestroyOffscreenImages ();
+
+	m_generation++;
+	m_swapchainDirty = false;
+	m_acquiredIndex = UINT32_MAX;
+	m_lastPresented = UINT32_MAX;
+	m_nextImage = 0;
+	m_swapchainExtent = default_extent;
+	m_presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+	m_format = offscreen_format;
+
+	// One image per frame in flight, so that an image is never reused
+	// before the fence of the frame that last rendered to it has signaled.
+	m_swapchainSize = CPU_RENDER_AHEAD;
+	m_offscreenImages = new GPUImage[m_swapchainSize];
+	m_images = new VkImage[m_swapchainSize];
+	m_imageViews = new VkImageView[m_swapchainSize];
+
+	VkExtent3D extent {};
+	extent.width = m_swapchainExtent.width;
+	extent.height = m_swapchainExtent.height;
+	extent.depth = 1;
+
+	for (uint32_t i = 0; i < m_swapchainSize; i++) {
+		try {
+			m_offscreenImages[i] = MMCreateGPUImage (VK_IMAGE_TYPE_2D, extent, m_format,
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+		} catch (...) {
+			m_swapchainSize = i;
+			DestroyOffscreenImages ();
+			throw;
+		}
+
+		m_images[i] = m_offscreenImages[i].m_image;
+
+		VkImageViewCreateInfo view_ci {};
+		view_ci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		view_ci.image = m_images[i];
+		view_ci.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		view_ci.format = m_format;
+		view_ci.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		view_ci.subresourceRange.levelCount = 1;
+		view_ci.subresourceRange.layerCount = 1;
+		VkResult result = ::vkCreateImageView (gVkDevice, &view_ci, nullptr, &m_imageViews[i]);
+		if (result != VK_SUCCESS) {
+			MMDestroyGPUImage (m_offscreenImages[i]);
+			m_swapchainSize = i;
+			DestroyOffscreenImages ();
+			throw std::runtime_error (std::string ("vkCreateImageView returned ") + VulkanTypeToString (result));
+		}
+	}
+}
+
 void
 Window::CreateSwapchain (void)
 {
+	if (m_headless) {
+		CreateOffscreenImages ();
+		return;
+	}
+
 	auto choose_format = [&](void) -> VkSurfaceFormatKHR {
 		VkResult result;
 		uint32_t count = 0;
@@ -252,6 +350,24 @@ Window::AcquireSwapchainImage (uint32_t *index, VkSemaphore sema)
 		return true;
 	}
 
+	if (m_headless) {
+		if (!m_offscreenImages)
+			CreateSwapchain ();
+
+		VkSubmitInfo submit_info {};
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.signalSemaphoreCount = 1;
+		submit_info.pSignalSemaphores = &sema;
+		result = ::vkQueueSubmit (gVkQueue, 1, &submit_info, VK_NULL_HANDLE);
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vkQueueSubmit returned ") + VulkanTypeToString (result));
+
+		*index = m_nextImage;
+		m_nextImage = (m_nextImage + 1) % m_swapchainSize;
+		m_acquiredIndex = *index;
+		return true;
+	}
+
 	if (m_swapchainDirty || m_swapchain == VK_NULL_HANDLE)
 		CreateSwapchain ();
 
@@ -274,6 +390,22 @@ Window::PresentSwapchainImage (uint32_t index, VkSemaphore sema)
 {
 	m_acquiredIndex = UINT32_MAX;
 
+	if (m_headless) {
+		VkPipelineStageFlags wait_psf = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+		VkSubmitInfo submit_info {};
+		submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit_info.waitSemaphoreCount = sema != VK_NULL_HANDLE;
+		submit_info.pWaitSemaphores = (sema != VK_NULL_HANDLE) ? &sema : nullptr;
+		submit_info.pWaitDstStageMask = &wait_psf;
+		VkResult result = ::vkQueueSubmit (gVkQueue, 1, &submit_info, VK_NULL_HANDLE);
+		if (result != VK_SUCCESS)
+			throw std::runtime_error (std::string ("vkQueueSubmit returned ") + VulkanTypeToString (result));
+
+		m_lastPresented = index;
+		return;
+	}
+
 	VkPresentInfoKHR info {};
 	info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	info.waitSemaphoreCount = sema != VK_NULL_HANDLE;
@@ -289,4 +421,15 @@ Window::PresentSwapchainImage (uint32_t index, VkSemaphore sema)
 		throw std::runtime_error (std::string ("vkQueuePresentKHR returned ") + VulkanTypeToString (result));
 }
 
+bool
+Window::DownloadLastImage (void *data)
+{
+	if (!m_headless || m_lastPresented == UINT32_MAX)
+		return false;
+
+	MMDownloadTexture2D (m_offscreenImages[m_lastPresented], GetPresentLayout (),
+		m_format, m_swapchainExtent, data);
+	return true;
+}
+
 }
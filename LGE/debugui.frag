@@ -1,5 +1,5 @@
 /**
- * Rasterize DebugUI text.
+ * Rasterize DebugUI text and shapes.
  * Copyright (C) 2024  dbstream
  */
 layout (location = 0) in struct {
@@ -14,5 +14,10 @@ layout (set = 0, binding = 0) uniform sampler2D font_bitmap;
 void
 main (void)
 {
-	color = vec4 (In.modulator.rgb, In.modulator.a * texture(font_bitmap, In.uv).r);
+	// The font is a signed distance field with the outline at 0.5. Blend
+	// over about one screen pixel, whatever the scale.
+	float distance = texture (font_bitmap, In.uv).r;
+	float width = max (0.5 * fwidth (distance), 1.0e-4);
+	float coverage = smoothstep (0.5 - width, 0.5 + width, distance);
+	color = vec4 (In.modulator.rgb, In.modulator.a * coverage);
 }
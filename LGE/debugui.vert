@@ -1,11 +1,30 @@
 /**
- * Rasterize DebugUI text.
+ * Rasterize DebugUI text and shapes.
  * Copyright (C) 2024  dbstream
  */
 layout (location = 0) in vec2 position;
-layout (location = 1) in vec2 uv;
+layout (location = 1) in uint glyph;
 layout (location = 2) in vec4 modulator;
 
+struct GlyphRect {
+	vec2 offset;
+	vec2 size;
+	vec2 uv;
+	vec2 uv_size;
+};
+
+layout (set = 0, binding = 1, std430) readonly buffer GlyphRects {
+	GlyphRect rects[];
+};
+
+layout (push_constant) uniform PushConstants {
+	vec2 inv_extent;
+
+	// Multiplied by the scale in the instance to get atlas pixels to
+	// screen pixels.
+	float scale_unit;
+};
+
 layout (location = 0) out struct {
 	vec2 uv;
 	vec4 modulator;
@@ -14,7 +33,34 @@ layout (location = 0) out struct {
 void
 main (void)
 {
-	Out.uv = uv;
+	// Every instance is a glyph or a shape, drawn as a four-vertex
+	// triangle strip.
+	vec2 corner = vec2 (gl_VertexIndex & 1, gl_VertexIndex >> 1);
+	vec2 pixel;
+
+	if ((glyph & 0x80000000u) == 0u) {
+		GlyphRect rect = rects[glyph & 0xffffu];
+		float scale = float ((glyph >> 16) & 0x7fffu) * scale_unit;
+
+		Out.uv = rect.uv + corner * rect.uv_size;
+		pixel = position + scale * (rect.offset + corner * rect.size);
+	} else {
+		// Shapes sample the white texel that rect 0 points at. Sizes
+		// are in units of 1/4 pixel.
+		Out.uv = rects[0].uv;
+
+		if ((glyph & 0x40000000u) == 0u) {
+			vec2 size = vec2 (glyph & 0x7fffu, (glyph >> 15) & 0x7fffu);
+			pixel = position + corner * size * 0.25;
+		} else {
+			// Sign-extend the two 15-bit extents.
+			vec2 extent = vec2 (int (glyph << 17) >> 17, int (glyph << 2) >> 17) * 0.25;
+			float len = length (extent);
+			vec2 normal = (len > 0.0) ? vec2 (-extent.y, extent.x) / len : vec2 (0.0);
+			pixel = position + corner.x * extent + (corner.y - 0.5) * normal;
+		}
+	}
+
 	Out.modulator = modulator;
-	gl_Position = vec4 (vec2 (-1.0, -1.0) + 2.0 * position, 0.0, 1.0);
+	gl_Position = vec4 (vec2 (-1.0, -1.0) + 2.0 * pixel * inv_extent, 0.0, 1.0);
 }
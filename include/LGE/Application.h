@@ -13,6 +13,8 @@ typedef struct VKFWevent_T VKFWevent;
 
 namespace LGE {
 
+typedef struct DebugUIText_T *DebugUIText;
+
 /**
  * CPU render ahead affects resource management outside the scope of Application
  * too. Keep it a constexpr global.
@@ -35,6 +37,8 @@ private:
 	int m_numFpsFrames = 0;
 
 	float m_displayedFrameTime = 1.0f;
+	DebugUIText m_frameRateText = nullptr;
+	DebugUIText m_frameTimeText = nullptr;
 
 protected:
 	VkRenderPass m_renderPass = VK_NULL_HANDLE;
@@ -51,7 +55,7 @@ public:
 	 *
 	 * @note the render pass may not be created on application startup, and
 	 * it may be recreated at any time in between frames. This function is
-	 * only safe to call inside Application::Draw.
+	 * only safe to call inside Application::PrepareDraw and Application::Draw.
 	 *
 	 * @return current application render pass.
 	 */
@@ -124,6 +128,16 @@ public:
 	virtual VkFramebuffer
 	CreateFramebuffer (VkRenderPass rp);
 
+	/**
+	 * Record commands that must be outside of a render pass, such as
+	 * compute passes and transfers that Draw depends on.
+	 *
+	 * This function is called by the default Render function before the
+	 * default render pass is begun.
+	 */
+	virtual void
+	PrepareDraw (VkCommandBuffer cmd);
+
 	/**
 	 * Begin rendering with the default render pass.
 	 *
@@ -0,0 +1,155 @@
+/**
+ * Memory-mapped asset packs.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/AssetPackFormat.h>
+#include <LGE/GPUMemory.h>
+
+#include <string>
+#include <string_view>
+
+/**
+ * An asset pack is mapped into memory when it is opened. Opening only
+ * validates the table of contents, so it takes the same time regardless of
+ * the size of the pack, and entries are found by binary search. Entries are
+ * copied or decompressed from the mapping straight into staging memory, so
+ * the data is copied once on its way from the page cache to the GPU. Large
+ * compressed entries are decompressed on the GPU instead, with
+ * <LGE/GPUDecompress.h>.
+ *
+ * Packs are built with scripts/make_pack.cc. The format is described in
+ * <LGE/AssetPackFormat.h>.
+ */
+
+namespace LGE {
+
+class AssetPack {
+private:
+	std::string m_path;
+
+	const uint8_t *m_data = nullptr;
+	size_t m_size = 0;
+
+	const AssetPackEntry *m_entries = nullptr;
+	uint32_t m_numEntries = 0;
+	const char *m_names = nullptr;
+	bool m_gpuDecompression = true;
+
+	bool
+	UseGPUDecompression (const AssetPackEntry &entry) const;
+
+public:
+	/**
+	 * Open and map an asset pack. Errors are reported by throwing
+	 * std::runtime_error.
+	 *
+	 * @param path path of the pack.
+	 */
+	AssetPack (const char *path);
+
+	~AssetPack (void);
+
+	AssetPack (const AssetPack &) = delete;
+
+	AssetPack &
+	operator= (const AssetPack &) = delete;
+
+	/**
+	 * Find an entry by name.
+	 *
+	 * @return the entry, or nullptr if the pack has no entry of that name.
+	 */
+	const AssetPackEntry *
+	Find (std::string_view name) const;
+
+	uint32_t
+	GetNumEntries (void) const
+	{
+		return m_numEntries;
+	}
+
+	const AssetPackEntry &
+	GetEntry (uint32_t index) const
+	{
+		return m_entries[index];
+	}
+
+	std::string_view
+	GetName (const AssetPackEntry &entry) const
+	{
+		return std::string_view (m_names + entry.m_nameOffset, entry.m_nameLength);
+	}
+
+	/**
+	 * Set whether LoadBuffer and LoadTexture may decompress large entries
+	 * on the GPU. This is enabled by default.
+	 */
+	void
+	SetGPUDecompression (bool enable)
+	{
+		m_gpuDecompression = enable;
+	}
+
+	/**
+	 * Copy or decompress an entry to memory.
+	 *
+	 * @param entry entry of this pack.
+	 * @param data output buffer of entry.m_uncompressedSize bytes.
+	 */
+	void
+	Read (const AssetPackEntry &entry, void *data) const;
+
+	/**
+	 * Create a GPU buffer that holds the data of an entry.
+	 *
+	 * @param entry entry of this pack.
+	 * @param usage Vulkan buffer usage bits.
+	 * @param memory_class memory class. Must not be MMMemoryClass::TRANSIENT.
+	 */
+	GPUBuffer
+	LoadBuffer (const AssetPackEntry &entry, VkBufferUsageFlags usage,
+		MMMemoryClass memory_class = MMMemoryClass::MESH) const;
+
+	/**
+	 * Create GPU buffers that hold the data of a number of entries, like
+	 * LoadBuffer. The entries that are decompressed on the GPU share one
+	 * GPUDecompressBatch, so loading them waits for the GPU once.
+	 *
+	 * @param entries entries of this pack.
+	 * @param count number of entries.
+	 * @param usage Vulkan buffer usage bits.
+	 * @param buffers receives count buffers.
+	 * @param memory_class memory class. Must not be MMMemoryClass::TRANSIENT.
+	 */
+	void
+	LoadBuffers (const AssetPackEntry *const *entries, uint32_t count,
+		VkBufferUsageFlags usage, GPUBuffer *buffers,
+		MMMemoryClass memory_class = MMMemoryClass::MESH) const;
+
+	/**
+	 * Upload a texture entry with MMUploadTexture2DArray, or with
+	 * GPUDecompressTexture2DArray.
+	 *
+	 * @param entry texture entry of this pack.
+	 *
+	 * @return GPU image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+	 */
+	GPUImage
+	LoadTexture (const AssetPackEntry &entry) const;
+
+	/**
+	 * Upload a number of texture entries, like LoadTexture. The entries
+	 * that are decompressed on the GPU share one GPUDecompressBatch.
+	 *
+	 * @param entries texture entries of this pack.
+	 * @param count number of entries.
+	 * @param images receives count images.
+	 */
+	void
+	LoadTextures (const AssetPackEntry *const *entries, uint32_t count,
+		GPUImage *images) const;
+};
+
+}
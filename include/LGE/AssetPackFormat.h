@@ -0,0 +1,118 @@
+/**
+ * Asset pack file format.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * This is shared between the asset pack loader and the offline packer in
+ * scripts/make_pack.cc. All values are little-endian.
+ *
+ * An asset pack starts with an AssetPackHeader. It is followed by the table
+ * of contents, an array of AssetPackEntry sorted by name hash and then by
+ * name, and by the names, which are not null-terminated. The data of every
+ * entry starts at a multiple of ASSET_PACK_ALIGNMENT, so that a mapped pack
+ * can be copied from directly.
+ *
+ * The data of buffer entries is the contents of the buffer. The data of
+ * texture entries is laid out as MMUploadTexture2DArray expects it: the
+ * layers follow each other, and every layer holds m_levels mip levels,
+ * tightly packed, largest first.
+ *
+ * Compressed entries are split into chunks of ASSET_PACK_CHUNK_SIZE bytes of
+ * uncompressed data, which are compressed independently, so that they can
+ * be decompressed in parallel. Their data starts with num_chunks + 1 u32
+ * offsets, relative to the start of the data; chunk i ends where chunk i + 1
+ * starts, and the last offset is the size of the data. A chunk that is as
+ * large as its uncompressed data is stored as it is.
+ */
+
+namespace LGE {
+
+static constexpr char ASSET_PACK_MAGIC[8] = { 'L', 'G', 'E', 'P', 'A', 'C', 'K', 1 };
+
+static constexpr uint64_t ASSET_PACK_ALIGNMENT = 4096;
+static constexpr uint32_t ASSET_PACK_CHUNK_SIZE = 65536;
+
+enum AssetPackEntryType : uint32_t {
+	ASSET_PACK_BUFFER = 0,
+	ASSET_PACK_TEXTURE
+};
+
+enum AssetPackCompression : uint32_t {
+	ASSET_PACK_UNCOMPRESSED = 0,
+
+	/** Chunks compressed with LZCompress. */
+	ASSET_PACK_LZ
+};
+
+struct AssetPackHeader {
+	char m_magic[8];
+	uint32_t m_numEntries;
+	uint32_t m_reserved;
+	uint64_t m_tocOffset;
+	uint64_t m_namesOffset;
+	uint64_t m_namesSize;
+};
+
+static_assert (sizeof (AssetPackHeader) == 40);
+
+struct AssetPackEntry {
+	/** AssetPackHash of the name. */
+	uint64_t m_nameHash;
+
+	/** Range of the name, relative to the start of the names. */
+	uint32_t m_nameOffset;
+	uint32_t m_nameLength;
+
+	/** Range of the data in the file. */
+	uint64_t m_offset;
+	uint64_t m_size;
+
+	uint64_t m_uncompressedSize;
+
+	/** AssetPackEntryType. */
+	uint32_t m_type;
+
+	/** AssetPackCompression. */
+	uint32_t m_compression;
+
+	/** Texture entries only: VkFormat, extent, levels, layers and VkImageCreateFlags. */
+	uint32_t m_format;
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_levels;
+	uint32_t m_layers;
+	uint32_t m_flags;
+};
+
+static_assert (sizeof (AssetPackEntry) == 72);
+
+/**
+ * Hash an entry name, with 64-bit FNV-1a.
+ */
+static inline uint64_t
+AssetPackHash (const char *name, size_t length)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (uint8_t) name[i];
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+/**
+ * Get the number of chunks of a compressed entry.
+ */
+static inline uint64_t
+AssetPackNumChunks (uint64_t uncompressed_size)
+{
+	return (uncompressed_size + ASSET_PACK_CHUNK_SIZE - 1) / ASSET_PACK_CHUNK_SIZE;
+}
+
+}
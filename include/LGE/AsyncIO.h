@@ -0,0 +1,94 @@
+/**
+ * Asynchronous file I/O.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Reads are submitted in batches and run in the background. On Linux, they
+ * go through io_uring, so that a whole batch costs one system call and many
+ * reads are in flight at once. If io_uring is not available, a small pool of
+ * threads runs them with pread.
+ *
+ * Completion callbacks are called from AsyncIOPoll and AsyncIOWait, on the
+ * thread that calls them, never from the background. All functions must be
+ * called from the same thread, usually the main thread.
+ *
+ * The service starts with the first submission. LGEMain terminates it.
+ */
+
+namespace LGE {
+
+/**
+ * Called when a read has completed.
+ *
+ * @param user user pointer of the read.
+ * @param ok whether all bytes were read.
+ */
+typedef void (*AsyncIOCallback) (void *user, bool ok);
+
+struct AsyncIORead {
+	int m_fd;
+	void *m_buffer;
+	size_t m_size;
+	uint64_t m_offset;
+
+	AsyncIOCallback m_callback;
+	void *m_user;
+};
+
+/** Maximum number of registered buffers. */
+static constexpr uint32_t ASYNC_IO_MAX_BUFFERS = 8;
+
+/**
+ * Submit reads. The file descriptors and buffers must stay valid until the
+ * callbacks have been called.
+ *
+ * @param reads reads to submit.
+ * @param count number of reads.
+ */
+void
+AsyncIOSubmit (const AsyncIORead *reads, uint32_t count);
+
+/**
+ * Call the callbacks of reads that have completed, without waiting.
+ *
+ * @return number of callbacks called.
+ */
+uint32_t
+AsyncIOPoll (void);
+
+/**
+ * Wait for all submitted reads to complete, and call their callbacks.
+ */
+void
+AsyncIOWait (void);
+
+/**
+ * Register a buffer that reads will often target, such as a staging buffer.
+ * With io_uring, the kernel pins its pages once, instead of for every read.
+ * This waits for reads in flight. Registration can fail, for example for
+ * memory mapped from a device; reads into the buffer then work as usual.
+ *
+ * @return whether the buffer was registered with the kernel.
+ */
+bool
+AsyncIORegisterBuffer (void *data, size_t size);
+
+/**
+ * Unregister a buffer registered by AsyncIORegisterBuffer. This waits for
+ * reads in flight.
+ */
+void
+AsyncIOUnregisterBuffer (void *data);
+
+/**
+ * Wait for all reads and stop the service.
+ */
+void
+AsyncIOTerminate (void);
+
+}
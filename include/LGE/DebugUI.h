@@ -6,6 +6,8 @@
 
 #include <LGE/Vulkan.h>
 
+#include <stddef.h>
+
 namespace LGE {
 
 enum class DebugUICorner {
@@ -21,8 +23,33 @@ DebugUIInit (void);
 void
 DebugUITerminate (void);
 
+/**
+ * Set the scale of text drawn or set by subsequent calls. At scale 1, text
+ * has a 12 pixel em size. The scale is stored with a precision of 1/256, and
+ * is clamped to the range [1/256, 127].
+ *
+ * @param scale text scale.
+ */
+void
+DebugUISetScale (float scale);
+
+/**
+ * Get the current text scale.
+ */
+float
+DebugUIGetScale (void);
+
+/**
+ * Get the distance between two lines of text at the current scale.
+ *
+ * @return line height in pixels.
+ */
+int
+DebugUIGetLineHeight (void);
+
 /** 
- * Draw text to the Debug UI.
+ * Draw text to the Debug UI. Text is UTF-8. Glyphs outside of ASCII are
+ * rasterized from the font the first time they are drawn.
  *
  * @param text text to draw
  * @param x, y position of text
@@ -46,6 +73,165 @@ DebugUIPrintf (int x, int y, DebugUICorner corner,
 	float r, float g, float b, float a,
 	const char *fmt, ...);
 
+/**
+ * Shapes are drawn in the same batch as immediate text, in the order they
+ * are added. Positions and sizes are in pixels, and a position is relative
+ * to the given corner of the screen, like for text.
+ */
+
+/**
+ * Draw a filled rectangle to the Debug UI.
+ *
+ * @param x, y position of the rectangle
+ * @param width, height size of the rectangle
+ * @param corner which corner the position is relative to
+ * @param r, g, b, a color and transparency of the rectangle
+ */
+void
+DebugUIDrawRect (int x, int y, int width, int height, DebugUICorner corner,
+	float r, float g, float b, float a);
+
+/**
+ * Draw a one pixel wide rectangle outline to the Debug UI. The outline is
+ * inside of the rectangle.
+ *
+ * @param x, y position of the rectangle
+ * @param width, height size of the rectangle
+ * @param corner which corner the position is relative to
+ * @param r, g, b, a color and transparency of the outline
+ */
+void
+DebugUIDrawRectOutline (int x, int y, int width, int height, DebugUICorner corner,
+	float r, float g, float b, float a);
+
+/**
+ * Draw a one pixel wide line to the Debug UI.
+ *
+ * @param x0, y0 start of the line
+ * @param x1, y1 end of the line
+ * @param corner which corner the positions are relative to
+ * @param r, g, b, a color and transparency of the line
+ */
+void
+DebugUIDrawLine (int x0, int y0, int x1, int y1, DebugUICorner corner,
+	float r, float g, float b, float a);
+
+/**
+ * Draw a line graph of the values in a ring buffer to the Debug UI. The
+ * oldest value is drawn on the left, and the values are spread over the
+ * whole width. Values outside of [min, max] are clamped.
+ *
+ * @param x, y position of the graph
+ * @param width, height size of the graph
+ * @param corner which corner the position is relative to
+ * @param values ring buffer of values
+ * @param count number of values in the ring buffer
+ * @param first index of the oldest value
+ * @param min, max values at the bottom and at the top of the graph
+ * @param r, g, b, a color and transparency of the graph
+ */
+void
+DebugUIDrawGraph (int x, int y, int width, int height, DebugUICorner corner,
+	const float *values, size_t count, size_t first, float min, float max,
+	float r, float g, float b, float a);
+
+struct DebugUIColor {
+	float r, g, b, a;
+};
+
+/**
+ * Draw a horizontal stacked bar to the Debug UI. Segments are drawn from left
+ * to right, and the full width of the bar corresponds to max. Segments that
+ * do not fit are cut off. Draw one bar per sample for a stacked bar chart.
+ *
+ * @param x, y position of the bar
+ * @param width, height size of the bar
+ * @param corner which corner the position is relative to
+ * @param values segment values
+ * @param colors segment colors
+ * @param count number of segments
+ * @param max value that fills the whole bar
+ */
+void
+DebugUIDrawStackedBar (int x, int y, int width, int height, DebugUICorner corner,
+	const float *values, const DebugUIColor *colors, size_t count, float max);
+
+/**
+ * Retained text. Text that changes rarely, such as labels and tables, should
+ * use a DebugUIText instead of DebugUIDrawText. Its glyphs are generated
+ * once and kept in GPU memory, and are only regenerated when the text, its
+ * position or its color changes. All retained text is drawn with a single
+ * draw call.
+ *
+ * Retained text is drawn every frame until it is destroyed. To hide it, set
+ * it to an empty string. It is not destroyed by DebugUITerminate.
+ */
+typedef struct DebugUIText_T *DebugUIText;
+
+/**
+ * Create a retained text. It is initially empty.
+ */
+DebugUIText
+DebugUICreateText (void);
+
+/**
+ * Destroy a retained text.
+ *
+ * @param text text to destroy, or nullptr.
+ */
+void
+DebugUIDestroyText (DebugUIText text);
+
+/**
+ * Set the contents of a retained text. This does nothing if nothing changed.
+ *
+ * @param text retained text.
+ * @param str UTF-8 text to draw
+ * @param x, y position of text
+ * @param corner which corner the position is relative to
+ * @param r, g, b, a color and transparency of text
+ */
+void
+DebugUISetText (DebugUIText text, const char *str, int x, int y, DebugUICorner corner,
+	float r, float g, float b, float a);
+
+/**
+ * Set the contents of a retained text using a printf format specifier.
+ *
+ * @param text retained text.
+ * @param x, y position of text
+ * @param corner which corner the position is relative to
+ * @param r, g, b, a color and transparency of text
+ * @param fmt printf format
+ */
+void
+DebugUISetTextPrintf (DebugUIText text, int x, int y, DebugUICorner corner,
+	float r, float g, float b, float a,
+	const char *fmt, ...);
+
+/**
+ * Tell the Debug UI that the VkFence for rendering operations on a frame has
+ * completed.
+ */
+void
+DebugUINextFrame (void);
+
+/**
+ * Record the copy of glyphs that were rasterized since the last call to the
+ * font atlas. Called by the Application before the render pass begins.
+ * Glyphs that are first used later in the frame are uploaded with the next
+ * frame, and are not drawn until then.
+ *
+ * @param cmd command buffer, outside of a render pass.
+ */
+void
+DebugUIUploadGlyphs (VkCommandBuffer cmd);
+
+/**
+ * Draw all text and shapes that were added since the last call.
+ *
+ * @param cmd command buffer, inside the Debug UI subpass.
+ */
 void
 DebugUIDraw (VkCommandBuffer cmd);
 
@@ -0,0 +1,173 @@
+/**
+ * GPU decompression.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/GPUMemory.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+/**
+ * Data in the chunked LZ format of compressed asset pack entries (see
+ * <LGE/AssetPackFormat.h>) can be decompressed by a compute shader instead
+ * of on the CPU. The compressed bytes are written to staging memory, copied
+ * to a device-local scratch buffer, and decoded from there into the
+ * destination, so only the compressed bytes cross the bus and no CPU time is
+ * spent decoding.
+ *
+ * Every chunk is decoded by one shader invocation. Chunks are independent, so
+ * they decode in parallel, but a chunk decodes serially; this pays off for
+ * data of many chunks, such as large meshes and textures. Loading many
+ * entries at once should go through a GPUDecompressBatch, which waits for
+ * the GPU once for all of them.
+ */
+
+namespace LGE {
+
+/**
+ * Check whether data of the given sizes can be decompressed on the GPU. This
+ * is limited by the largest storage buffer that the device supports.
+ */
+bool
+GPUDecompressSupported (uint64_t compressed_size, uint64_t uncompressed_size);
+
+/** A region of compressed data to decompress with GPUDecompressCmd. */
+struct GPUDecompressRegion {
+	/** Offset of the compressed data in the source. Must be a multiple of 4. */
+	VkDeviceSize m_srcOffset;
+	VkDeviceSize m_srcSize;
+
+	/** Offset of the output in the destination. Must be a multiple of 4. */
+	VkDeviceSize m_dstOffset;
+	uint64_t m_uncompressedSize;
+};
+
+/**
+ * Record the decompression of regions of data that are already in a GPU
+ * buffer. The regions are decoded by one dispatch each, and share descriptor
+ * sets where the storage buffer range allows, so batching many regions into
+ * one call is cheap. The chunk tables are not checked; GPUDecompressBatch
+ * checks them before it calls this.
+ *
+ * @param cmd command buffer. Must be outside of a render pass.
+ * @param src buffer with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT that holds the
+ * compressed data, with room to round the end of every region up to a
+ * multiple of 4 bytes.
+ * @param dst buffer with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, with room for
+ * the uncompressed size of every region rounded up to a multiple of 4 bytes.
+ * Bytes past the uncompressed size are overwritten.
+ * @param regions regions to decompress.
+ * @param count number of regions.
+ */
+void
+GPUDecompressCmd (VkCommandBuffer cmd, VkBuffer src, VkBuffer dst,
+	const GPUDecompressRegion *regions, uint32_t count);
+
+/**
+ * Decompresses a number of entries with one staging buffer, one command
+ * buffer, and one wait. Entries are added, then Submit records and submits
+ * all of them. The data that is passed to Add functions must stay valid
+ * until Submit returns. Errors are reported by throwing std::runtime_error.
+ */
+class GPUDecompressBatch {
+private:
+	struct Entry {
+		const void *m_data;
+		size_t m_size;
+		uint64_t m_uncompressedSize;
+
+		/** Offset of the compressed data in the staging buffer. */
+		VkDeviceSize m_srcOffset;
+
+		/** Target buffer, or VK_NULL_HANDLE for a texture. */
+		VkBuffer m_target;
+
+		/** Offset of the output in the target or the texel buffer. */
+		VkDeviceSize m_dstOffset;
+		GPUImage m_image;
+	};
+
+	std::vector<Entry> m_entries;
+	VkDeviceSize m_size = 0;
+	VkDeviceSize m_texelSize = 0;
+
+	static void
+	write (void *mapped, size_t size, void *user);
+
+	static void
+	record (VkCommandBuffer cmd, VkBuffer staging, void *user);
+
+	void
+	add (const void *data, size_t size, uint64_t uncompressed_size);
+
+public:
+	/**
+	 * Add the decompression of data into a GPU buffer.
+	 *
+	 * @param data compressed data.
+	 * @param size size of data.
+	 * @param uncompressed_size size of the uncompressed data.
+	 * @param target buffer with VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, with room
+	 * as for GPUDecompressCmd.
+	 * @param offset offset of the output in target. Must be a multiple of 4.
+	 */
+	void
+	AddBuffer (const void *data, size_t size, uint64_t uncompressed_size,
+		GPUBuffer &target, size_t offset);
+
+	/**
+	 * Add the decompression of a texture, and create its image. The
+	 * uncompressed data holds all mip_levels levels of every layer, layer
+	 * after layer. The caller owns the image, which holds the texture once
+	 * Submit returns.
+	 *
+	 * @param data compressed data.
+	 * @param size size of data.
+	 * @param uncompressed_size size of the uncompressed data.
+	 *
+	 * @return GPU image, in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL after
+	 * Submit.
+	 */
+	GPUImage
+	AddTexture2DArray (const void *data, size_t size, uint64_t uncompressed_size,
+		VkFormat format, VkExtent2D extent, uint32_t array_layers, uint32_t mip_levels,
+		VkImageCreateFlags flags = 0);
+
+	/**
+	 * Decompress the entries that were added, and wait for it to complete.
+	 * The batch is empty afterwards.
+	 */
+	void
+	Submit (void);
+};
+
+/**
+ * Decompress data into a GPU buffer, and wait for it to complete. This is a
+ * GPUDecompressBatch of one entry.
+ */
+void
+GPUDecompressToBuffer (const void *data, size_t size, uint64_t uncompressed_size,
+	GPUBuffer &target, size_t offset);
+
+/**
+ * Decompress a texture, and upload it like MMUploadTexture2DArray. This is a
+ * GPUDecompressBatch of one entry.
+ *
+ * @return GPU image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+ */
+GPUImage
+GPUDecompressTexture2DArray (const void *data, size_t size, uint64_t uncompressed_size,
+	VkFormat format, VkExtent2D extent, uint32_t array_layers, uint32_t mip_levels,
+	VkImageCreateFlags flags = 0);
+
+/**
+ * Destroy the decompression pipeline. The device must be idle.
+ */
+void
+GPUDecompressTerminate (void);
+
+}
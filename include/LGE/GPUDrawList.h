@@ -0,0 +1,180 @@
+/**
+ * GPU-driven draw lists.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/Descriptor.h>
+#include <LGE/GeometryArena.h>
+#include <LGE/GPUMemory.h>
+#include <LGE/Math.h>
+
+#include <vector>
+
+/**
+ * A GPU draw list holds objects that are meshes in a GeometryArena together
+ * with a transform and a bounding sphere. The object data lives in a storage
+ * buffer. Every frame, a compute shader culls the objects against the view
+ * frustum and writes a VkDrawIndexedIndirectCommand and a draw count for the
+ * visible objects, which are then drawn with vkCmdDrawIndexedIndirectCount.
+ * The CPU cost of drawing is independent of the number of objects; only
+ * objects that changed since the previous frame are uploaded.
+ *
+ * The firstInstance of every draw command is the object index, so the vertex
+ * shader finds the object as objects[gl_InstanceIndex] in the buffer returned
+ * by GetObjectBuffer. The layout of GPUDrawObject matches the std430 layout
+ * of:
+ *
+ *	struct DrawObject {
+ *		mat4 transform;
+ *		vec4 bounds;
+ *		uint first_index;
+ *		uint index_count;
+ *		int vertex_offset;
+ *		uint pad;
+ *	};
+ */
+
+namespace LGE {
+
+struct GPUDrawObject {
+	Math::mat4 m_transform;
+
+	/** Bounding sphere in object space: center in xyz, radius in w. */
+	Math::vec4 m_bounds;
+
+	uint32_t m_firstIndex;
+
+	/** 0 if the object slot is unused. */
+	uint32_t m_indexCount;
+
+	int32_t m_vertexOffset;
+	uint32_t m_pad;
+};
+
+static_assert (sizeof (GPUDrawObject) == 96);
+
+typedef uint32_t GPUDrawObjectID;
+
+class GPUDrawListPipeline;
+
+class GPUDrawList {
+private:
+	GeometryArena &m_arena;
+	uint32_t m_maxObjects;
+
+	/** CPU copy of the object buffer. */
+	std::vector<GPUDrawObject> m_objects;
+	std::vector<GPUDrawObjectID> m_freeIDs;
+	uint32_t m_numObjects = 0;
+
+	/** Range of objects to upload in the next Cull. */
+	uint32_t m_dirtyBegin = 0, m_dirtyEnd = 0;
+
+	GPUBuffer m_objectBuffer;
+
+	/**
+	 * The draw count, followed by one VkDrawIndexedIndirectCommand per
+	 * object.
+	 */
+	GPUBuffer m_drawBuffer;
+
+	GPUDrawListPipeline *m_pipeline = nullptr;
+	DescriptorSetLayout m_setLayout;
+	VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+
+	/**
+	 * Without drawIndirectCount, the culling shader writes every command
+	 * in place and sets the instance count of culled objects to zero.
+	 */
+	bool m_compact;
+
+	void
+	Destroy (void);
+
+	void
+	MarkDirty (GPUDrawObjectID id);
+
+public:
+	/**
+	 * Create a GPU draw list.
+	 *
+	 * @param arena geometry arena that all objects are drawn from. It must
+	 * have an index buffer, and outlive the draw list.
+	 * @param max_objects maximum number of objects.
+	 */
+	GPUDrawList (GeometryArena &arena, uint32_t max_objects);
+
+	/**
+	 * Destroy the draw list. Like pipelines, draw lists must not be
+	 * destroyed while frames that use them are in flight.
+	 */
+	~GPUDrawList (void);
+
+	GPUDrawList (const GPUDrawList &) = delete;
+
+	GPUDrawList &
+	operator= (const GPUDrawList &) = delete;
+
+	/**
+	 * Add an object to the draw list.
+	 *
+	 * @param range indexed mesh in the arena.
+	 * @param transform object to world transform.
+	 * @param center, radius bounding sphere of the mesh, in object space.
+	 *
+	 * @return object ID, or UINT32_MAX if the draw list is full.
+	 */
+	GPUDrawObjectID
+	AddObject (const GeometryRange &range, const Math::mat4 &transform,
+		const Math::vec3 &center, float radius);
+
+	/**
+	 * Change the transform of an object.
+	 */
+	void
+	SetTransform (GPUDrawObjectID id, const Math::mat4 &transform);
+
+	/**
+	 * Remove an object from the draw list. The ID may be returned by a
+	 * later AddObject.
+	 */
+	void
+	RemoveObject (GPUDrawObjectID id);
+
+	/**
+	 * Upload changed objects and record the culling pass. This must be
+	 * called outside of a render pass, from Application::PrepareDraw.
+	 *
+	 * @param cmd command buffer used by this frame.
+	 * @param view_projection world to clip space transform to cull
+	 * against.
+	 */
+	void
+	Cull (VkCommandBuffer cmd, const Math::mat4 &view_projection);
+
+	/**
+	 * Draw the objects that passed the last Cull. The graphics pipeline
+	 * and its descriptor sets must be bound; this binds the arena.
+	 */
+	void
+	Draw (VkCommandBuffer cmd);
+
+	/**
+	 * Get the object buffer, for use as a storage buffer in the vertex
+	 * shader.
+	 */
+	VkBuffer
+	GetObjectBuffer (void) const
+	{
+		return m_objectBuffer.m_buffer;
+	}
+
+	uint32_t
+	GetNumObjects (void) const
+	{
+		return m_numObjects - (uint32_t) m_freeIDs.size ();
+	}
+};
+
+}
@@ -23,6 +23,33 @@ MMInit (void);
 void
 MMTerminate (void);
 
+/**
+ * Memory classes. Every class except DEFAULT has its own VMA pools, so that
+ * allocations with different lifetimes do not fragment each other's memory.
+ * When VK_EXT_memory_priority is available, the class also determines the
+ * priority of the memory, which tells the driver what to page out first.
+ */
+enum class MMMemoryClass {
+	/** The default VMA pools. */
+	DEFAULT,
+
+	/** Long-lived buffers, in large blocks. High priority. */
+	MESH,
+
+	/**
+	 * Sampled images. Low priority, as textures are the cheapest to lose
+	 * when memory runs out.
+	 */
+	TEXTURE,
+
+	/**
+	 * Memory that is freed when the current frame has completed rendering.
+	 * This uses one linear pool per frame in flight, and is only used by
+	 * MMCreateTemporaryGPUBuffer.
+	 */
+	TRANSIENT
+};
+
 struct GPUBuffer {
 	VkBuffer m_buffer = VK_NULL_HANDLE;
 	VmaAllocation m_allocation = VK_NULL_HANDLE;
@@ -50,11 +77,13 @@ MMDestroyGPUBuffer (GPUBuffer &buffer);
  * @param data pointer to data.
  * @param size buffer size.
  * @param usage Vulkan buffer usage bits.
+ * @param memory_class memory class. Must not be MMMemoryClass::TRANSIENT.
  *
  * @return newly created GPU buffer.
  */
 GPUBuffer
-MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage);
+MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage,
+	MMMemoryClass memory_class = MMMemoryClass::MESH);
 
 /**
  * Copy data to the GPU buffer, via a staging buffer. The target buffer should
@@ -68,6 +97,57 @@ MMCreateMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage);
 void
 MMCopyToGPUBuffer (GPUBuffer &target, const void *data, size_t size, size_t offset);
 
+/**
+ * Called to write upload data straight into mapped staging memory. This
+ * lets loaders copy or decompress data from its source, such as a mapped
+ * file, without assembling it in a separate buffer first. The memory may be
+ * write-combined, so it should be written sequentially and never read.
+ *
+ * @param mapped staging memory.
+ * @param size number of bytes to write.
+ * @param user user pointer passed along with the callback.
+ */
+typedef void (*MMWriteCallback) (void *mapped, size_t size, void *user);
+
+/**
+ * Copy data to the GPU buffer, like MMCopyToGPUBuffer, but let a callback
+ * write the data into the staging buffer.
+ *
+ * @param target target GPU buffer.
+ * @param size size of the data.
+ * @param offset destination offset.
+ * @param write callback that writes size bytes.
+ * @param user user pointer passed to the callback.
+ */
+void
+MMUploadToGPUBuffer (GPUBuffer &target, size_t size, size_t offset,
+	MMWriteCallback write, void *user);
+
+/**
+ * Record commands that read a staging buffer.
+ *
+ * @param cmd command buffer.
+ * @param staging staging buffer, with VK_BUFFER_USAGE_TRANSFER_SRC_BIT.
+ * @param user user pointer passed along with the callback.
+ */
+typedef void (*MMRecordCallback) (VkCommandBuffer cmd, VkBuffer staging, void *user);
+
+/**
+ * Let a callback fill a staging buffer, and another one record the commands
+ * that consume it, such as copies or a decoding pass. The commands are
+ * submitted, and this waits for them to complete. MMUploadToGPUBuffer is
+ * built on this.
+ *
+ * @param size size of the staging buffer.
+ * @param write callback that writes size bytes.
+ * @param write_user user pointer passed to write.
+ * @param record callback that records the commands.
+ * @param record_user user pointer passed to record.
+ */
+void
+MMSubmitUpload (size_t size, MMWriteCallback write, void *write_user,
+	MMRecordCallback record, void *record_user);
+
 /**
  * Create a temporary GPU buffer and fill it with the given data. The buffer
  * will be freed automatically by LGE after the current frame has completed
@@ -85,10 +165,53 @@ MMCopyToGPUBuffer (GPUBuffer &target, const void *data, size_t size, size_t offs
 VkBuffer
 MMCreateTemporaryGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage);
 
+/**
+ * Create a GPU buffer that stays mapped into host memory until it is
+ * destroyed. The memory is suitable for sequential writes from the CPU.
+ *
+ * @note Use this for data that the CPU writes every frame, such as instance
+ * data. The caller is responsible for not overwriting data that frames in
+ * flight are still reading.
+ *
+ * @param size buffer size.
+ * @param usage Vulkan buffer usage bits.
+ * @param mapped receives a pointer to the mapped memory.
+ *
+ * @return newly created GPU buffer.
+ */
+GPUBuffer
+MMCreateMappedGPUBuffer (size_t size, VkBufferUsageFlags usage, void **mapped);
+
+/**
+ * Make CPU writes to a mapped GPU buffer visible to the GPU. This must be
+ * called before submitting commands that read the written range.
+ *
+ * @param buffer buffer created by MMCreateMappedGPUBuffer.
+ * @param offset start of the written range.
+ * @param size size of the written range.
+ */
+void
+MMFlushMappedGPUBuffer (const GPUBuffer &buffer, size_t offset, size_t size);
+
+/**
+ * Destroy the GPU buffer after the current frame has completed rendering.
+ *
+ * @param buffer buffer to destroy.
+ */
+void
+MMReleaseGPUBuffer (GPUBuffer &buffer);
+
 struct GPUImage {
 	VkImage m_image = VK_NULL_HANDLE;
 	VmaAllocation m_allocation = VK_NULL_HANDLE;
 
+	VkImageType m_type = VK_IMAGE_TYPE_2D;
+	VkImageCreateFlags m_flags = 0;
+	VkFormat m_format = VK_FORMAT_UNDEFINED;
+	VkExtent3D m_extent {};
+	uint32_t m_mipLevels = 0;
+	uint32_t m_arrayLayers = 0;
+
 	constexpr
 	operator bool (void) const
 	{
@@ -104,6 +227,24 @@ struct GPUImage {
 void
 MMDestroyGPUImage (GPUImage &image);
 
+/**
+ * Get the number of mip levels in a full mip chain, down to 1x1x1.
+ */
+uint32_t
+MMGetMipLevelCount (VkExtent3D extent);
+
+/**
+ * Get the size of a tightly packed mip level of an image. Block-compressed
+ * formats, such as BC1 to BC7, are counted in whole blocks, so rows of
+ * blocks are (width + 3) / 4 blocks wide.
+ *
+ * @param format image format.
+ * @param extent extent of level 0.
+ * @param level mip level.
+ */
+VkDeviceSize
+MMGetMipLevelSize (VkFormat format, VkExtent3D extent, uint32_t level);
+
 /**
  * Create a GPU image.
  *
@@ -111,20 +252,367 @@ MMDestroyGPUImage (GPUImage &image);
  * @param extent image extent. If 1D, y and z must be 1. If 2D, z must be 1.
  * @param format image format.
  * @param usage image usage.
+ * @param memory_class memory class. Must not be MMMemoryClass::TRANSIENT.
+ * @param mip_levels number of mip levels.
+ * @param array_layers number of array layers.
+ * @param flags image create flags, for example
+ * VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT for cube maps, which need a multiple
+ * of 6 array layers.
  */
 GPUImage
 MMCreateGPUImage (VkImageType type, VkExtent3D extent, VkFormat format,
-	VkImageUsageFlags usage);
+	VkImageUsageFlags usage, MMMemoryClass memory_class = MMMemoryClass::DEFAULT,
+	uint32_t mip_levels = 1, uint32_t array_layers = 1, VkImageCreateFlags flags = 0);
 
 /**
- * Upload a 2D texture to the GPU.
+ * Upload a 2D texture to the GPU. The image is allocated from
+ * MMMemoryClass::TEXTURE.
  *
  * @param format image format.
  * @param extent image extent.
- * @param data pixel data, must match format.
+ * @param data pixel data, must match format. This holds mip_levels tightly
+ * packed levels, largest first, and is copied with a single staging buffer.
+ * @param mip_levels number of levels in data.
+ * @param generate_mipmaps if true, the image gets a full mip chain, and the
+ * levels that are not in data are generated on the GPU from the smallest
+ * level that is.
  */
 GPUImage
-MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data);
+MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data,
+	uint32_t mip_levels = 1, bool generate_mipmaps = false);
+
+/**
+ * Upload a 2D array texture to the GPU, like MMUploadTexture2D. All layers
+ * are copied with a single staging buffer and command buffer.
+ *
+ * @param format image format.
+ * @param extent image extent.
+ * @param array_layers number of array layers.
+ * @param layers array_layers pointers to pixel data, one per layer, each
+ * laid out like the data of MMUploadTexture2D.
+ * @param mip_levels number of levels in the data of each layer.
+ * @param generate_mipmaps as for MMUploadTexture2D.
+ * @param flags image create flags, such as
+ * VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT.
+ */
+GPUImage
+MMUploadTexture2DArray (VkFormat format, VkExtent2D extent, uint32_t array_layers,
+	const void *const *layers, uint32_t mip_levels = 1, bool generate_mipmaps = false,
+	VkImageCreateFlags flags = 0);
+
+/**
+ * Upload a 2D array texture to the GPU, like MMUploadTexture2DArray, but let
+ * a callback write the pixel data into the staging buffer. The data of all
+ * layers follows each other, each laid out like the data of
+ * MMUploadTexture2D.
+ *
+ * @param write callback that writes the pixel data of all layers.
+ * @param user user pointer passed to the callback.
+ */
+GPUImage
+MMUploadTexture2DArray (VkFormat format, VkExtent2D extent, uint32_t array_layers,
+	MMWriteCallback write, void *user, uint32_t mip_levels = 1,
+	bool generate_mipmaps = false, VkImageCreateFlags flags = 0);
+
+/**
+ * Upload a cube map to the GPU. This is MMUploadTexture2DArray with 6 layers
+ * and VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT.
+ *
+ * @param faces pixel data of the +X, -X, +Y, -Y, +Z and -Z faces.
+ */
+GPUImage
+MMUploadTextureCube (VkFormat format, VkExtent2D extent, const void *const faces[6],
+	uint32_t mip_levels = 1, bool generate_mipmaps = false);
+
+/**
+ * Create a view of all mip levels and array layers of an image. The view type
+ * follows from the image: a cube compatible image with 6 layers gets a cube
+ * view, one with more layers a cube array view, and other images with more
+ * than one layer get an array view. Depth formats are viewed through the
+ * depth aspect.
+ *
+ * Destroy the view with vkDestroyImageView.
+ */
+VkImageView
+MMCreateImageView (const GPUImage &image);
+
+/**
+ * Create a view of a range of mip levels and array layers of an image, for
+ * example a 2D view of a single layer of an array or a face of a cube map.
+ *
+ * @param image image.
+ * @param type view type.
+ * @param base_level, level_count range of mip levels.
+ * @param base_layer, layer_count range of array layers.
+ */
+VkImageView
+MMCreateImageView (const GPUImage &image, VkImageViewType type,
+	uint32_t base_level, uint32_t level_count, uint32_t base_layer, uint32_t layer_count);
+
+/**
+ * Record the generation of all mip levels of an image from level 0, with
+ * vkCmdBlitImage. The image must have been created with
+ * VK_IMAGE_USAGE_TRANSFER_SRC_BIT and VK_IMAGE_USAGE_TRANSFER_DST_BIT, and
+ * its format must support blits. Linear filtering is used if the format
+ * supports it.
+ *
+ * @param cmd command buffer. Must be outside of a render pass.
+ * @param image image to generate mip levels of.
+ * @param layout current layout of level 0. The contents of the other levels
+ * are discarded. All levels are left in
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+ */
+void
+MMCmdGenerateMipmaps (VkCommandBuffer cmd, const GPUImage &image, VkImageLayout layout);
+
+/**
+ * Record a copy of the first data_levels mip levels of all layers of a 2D
+ * image from a buffer. The buffer holds the levels as MMUploadTexture2DArray
+ * expects them: layer after layer, each with its levels tightly packed.
+ *
+ * @param cmd command buffer. Must be outside of a render pass.
+ * @param buffer source buffer, with VK_BUFFER_USAGE_TRANSFER_SRC_BIT.
+ * @param offset offset of the data in buffer.
+ * @param image image in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+ * @param data_levels number of levels to copy.
+ */
+void
+MMCmdCopyToTexture2DArray (VkCommandBuffer cmd, VkBuffer buffer, VkDeviceSize offset,
+	const GPUImage &image, uint32_t data_levels);
+
+/**
+ * Copy regions of data to a 2D GPU image, via a staging buffer. Texels
+ * outside of the regions keep their contents. This waits for the queue to
+ * become idle.
+ *
+ * @param image target image. Must have been created with
+ * VK_IMAGE_USAGE_TRANSFER_DST_BIT, and be in
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, which it is returned to.
+ * @param data pointer to data.
+ * @param size size of data.
+ * @param num_regions number of regions.
+ * @param regions copy regions. Buffer offsets are relative to data.
+ */
+void
+MMCopyToGPUImage (GPUImage &image, const void *data, size_t size,
+	uint32_t num_regions, const VkBufferImageCopy *regions);
+
+/**
+ * Download the contents of a 2D image from the GPU. This waits for the queue
+ * to become idle.
+ *
+ * @param image source image. Must have been created with
+ * VK_IMAGE_USAGE_TRANSFER_SRC_BIT.
+ * @param layout current layout of the image. The image is returned to this
+ * layout afterwards.
+ * @param format image format.
+ * @param extent image extent.
+ * @param data pointer to memory that receives the tightly packed pixel data.
+ */
+void
+MMDownloadTexture2D (const GPUImage &image, VkImageLayout layout, VkFormat format,
+	VkExtent2D extent, void *data);
+
+/**
+ * Movable GPU resources. The defragmenter can move these to different memory
+ * while the application is running, which replaces the VkBuffer or VkImage
+ * behind the handle. Do not keep the Vulkan handles across frames; get them
+ * with MMGetBuffer or MMGetImage when recording commands.
+ *
+ * GPUBuffer and GPUImage are never moved.
+ */
+typedef struct MovableGPUBuffer_T *MovableGPUBuffer;
+typedef struct MovableGPUImage_T *MovableGPUImage;
+
+/**
+ * Called from MMNextFrame when the defragmenter has moved a resource. Use it
+ * to recreate image views and to update persistent descriptor sets. The old
+ * VkBuffer or VkImage stays valid until the frames in flight have completed,
+ * so views of it must not be destroyed immediately either.
+ *
+ * @param user user pointer passed to MMSetMoveCallback.
+ */
+typedef void (*MMMoveCallback) (void *user);
+
+/**
+ * Create a movable GPU buffer suitable for mesh data, and fill it with the
+ * given data.
+ *
+ * @param data pointer to data, or nullptr.
+ * @param size buffer size.
+ * @param usage Vulkan buffer usage bits.
+ *
+ * @return newly created movable GPU buffer.
+ */
+MovableGPUBuffer
+MMCreateMovableMeshGPUBuffer (const void *data, size_t size, VkBufferUsageFlags usage);
+
+/**
+ * Get the current VkBuffer of a movable GPU buffer. This is only valid until
+ * the next call to MMNextFrame.
+ */
+VkBuffer
+MMGetBuffer (MovableGPUBuffer buffer);
+
+/**
+ * Destroy a movable GPU buffer after the current frame has completed
+ * rendering.
+ */
+void
+MMReleaseMovableGPUBuffer (MovableGPUBuffer buffer);
+
+/**
+ * Upload a 2D texture to the GPU, into a movable image. The image stays in
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, which is what the defragmenter
+ * expects between frames.
+ *
+ * @param format image format.
+ * @param extent image extent.
+ * @param data pixel data, must match format.
+ * @param mip_levels, generate_mipmaps as for MMUploadTexture2D.
+ */
+MovableGPUImage
+MMUploadMovableTexture2D (VkFormat format, VkExtent2D extent, const void *data,
+	uint32_t mip_levels = 1, bool generate_mipmaps = false);
+
+/**
+ * Get the current VkImage of a movable GPU image. This is only valid until
+ * the next call to MMNextFrame.
+ */
+VkImage
+MMGetImage (MovableGPUImage image);
+
+/**
+ * Destroy a movable GPU image after the current frame has completed
+ * rendering.
+ */
+void
+MMReleaseMovableGPUImage (MovableGPUImage image);
+
+/**
+ * Set the callback that is called when a movable resource has been moved.
+ *
+ * @param callback callback, or nullptr to remove it.
+ * @param user user pointer passed to the callback.
+ */
+void
+MMSetMoveCallback (MovableGPUBuffer buffer, MMMoveCallback callback, void *user);
+
+void
+MMSetMoveCallback (MovableGPUImage image, MMMoveCallback callback, void *user);
+
+/**
+ * Start defragmenting GPU memory in the background. MMNextFrame runs one pass
+ * at a time: it copies up to the given number of movable resources to new
+ * memory on the GPU, and frees the old memory once the frames that might use
+ * it have completed. Defragmentation stops when no more moves are useful.
+ * Does nothing if defragmentation is already running.
+ *
+ * @param max_bytes_per_pass maximum number of bytes to copy in one pass, or 0
+ * for no limit.
+ * @param max_moves_per_pass maximum number of resources to move in one pass,
+ * or 0 for no limit.
+ */
+void
+MMStartDefragmentation (VkDeviceSize max_bytes_per_pass, uint32_t max_moves_per_pass);
+
+/**
+ * Test if defragmentation is running.
+ */
+bool
+MMIsDefragmenting (void);
+
+struct MMHeapStats {
+	VkMemoryHeapFlags m_flags;
+
+	/** Size of the heap in bytes. */
+	VkDeviceSize m_size;
+
+	/**
+	 * Bytes of the heap that are used by this process. With
+	 * VK_EXT_memory_budget, this includes memory allocated outside of LGE.
+	 */
+	VkDeviceSize m_usage;
+
+	/**
+	 * Bytes of the heap that this process can use before the driver
+	 * starts paging. Without VK_EXT_memory_budget, this is 80% of the
+	 * heap size.
+	 */
+	VkDeviceSize m_budget;
+
+	/** Number of VkDeviceMemory blocks and the bytes they occupy. */
+	uint32_t m_blockCount;
+	VkDeviceSize m_blockBytes;
+
+	/** Number of allocations and the bytes they occupy. */
+	uint32_t m_allocationCount;
+	VkDeviceSize m_allocationBytes;
+
+	/**
+	 * Fraction of m_blockBytes that is not used by any allocation, from 0
+	 * to 1. This memory is wasted unless new allocations fit into it.
+	 */
+	float m_fragmentation;
+};
+
+struct MMStats {
+	/** Whether budgets come from VK_EXT_memory_budget. */
+	bool m_hasMemoryBudget;
+
+	uint32_t m_numHeaps;
+	MMHeapStats m_heaps[VK_MAX_MEMORY_HEAPS];
+};
+
+/**
+ * Get memory usage statistics. This is cheap enough to call every frame.
+ * Budgets are refreshed by MMNextFrame.
+ *
+ * @param stats receives the statistics.
+ */
+void
+MMGetStats (MMStats &stats);
+
+/**
+ * Over-budget callback. It is called from MMNextFrame, once per frame and
+ * heap, for as long as the usage of the heap is above the threshold. Use it
+ * to evict streamed resources before the driver starts paging.
+ *
+ * @param stats current memory statistics.
+ * @param heap index of the heap that is over the threshold.
+ * @param user user pointer passed to MMSetOverBudgetCallback.
+ */
+typedef void (*MMOverBudgetCallback) (const MMStats &stats, uint32_t heap, void *user);
+
+/**
+ * Set the over-budget callback.
+ *
+ * @param callback callback, or nullptr to remove it.
+ * @param user user pointer passed to the callback.
+ * @param threshold fraction of the budget above which the callback is
+ * called, for example 0.9.
+ */
+void
+MMSetOverBudgetCallback (MMOverBudgetCallback callback, void *user, float threshold);
+
+enum class MMOverBudgetPolicy {
+	/** Allocate anyway, even if the driver has to page memory out. */
+	ALLOW,
+
+	/**
+	 * Throw from MMCreateMeshGPUBuffer, MMCreateGPUImage and
+	 * MMUploadTexture2D if the allocation would exceed the budget.
+	 * Temporary and staging buffers are always allowed.
+	 */
+	FAIL
+};
+
+/**
+ * Set what happens when a long-lived allocation would exceed the budget. The
+ * default is MMOverBudgetPolicy::ALLOW.
+ */
+void
+MMSetOverBudgetPolicy (MMOverBudgetPolicy policy);
 
 /**
  * Tell the memory manager that the VkFence for rendering operations on a frame
@@ -133,4 +621,12 @@ MMUploadTexture2D (VkFormat format, VkExtent2D extent, const void *data);
 void
 MMNextFrame (void);
 
+/**
+ * Get the number of times MMNextFrame has been called. Resources that were
+ * last used while this returned N are no longer in use by the GPU once it
+ * returns N + CPU_RENDER_AHEAD.
+ */
+uint64_t
+MMGetFrameIndex (void);
+
 }
@@ -0,0 +1,182 @@
+/**
+ * GPU profiling using timestamp queries.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#define VK_NO_PROTOTYPES 1
+#include <vulkan/vulkan.h>
+
+#include <LGE/DebugUI.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Every frame has its own VkQueryPool. Results are read back when the frame
+ * slot is reused, CPU_RENDER_AHEAD frames later, at which point the VkFence of
+ * the frame has already been waited on. Reading back results therefore never
+ * stalls.
+ *
+ * Scopes nest. Every frame has an implicit root scope named "Frame", which is
+ * opened by GPUProfilerNextFrame and closed by GPUProfilerEndFrame.
+ */
+
+namespace LGE {
+
+/**
+ * Initialize the GPU profiler.
+ */
+void
+GPUProfilerInit (void);
+
+/**
+ * Terminate the GPU profiler.
+ */
+void
+GPUProfilerTerminate (void);
+
+/**
+ * Tell the GPU profiler that the VkFence for rendering operations on a frame
+ * has completed, and that recording of a new frame has begun.
+ *
+ * @param cmd command buffer used by the new frame. Must be outside of a
+ * render pass.
+ */
+void
+GPUProfilerNextFrame (VkCommandBuffer cmd);
+
+/**
+ * Close the root scope of the current frame. This should be called just
+ * before vkEndCommandBuffer.
+ *
+ * @param cmd command buffer used by this frame.
+ */
+void
+GPUProfilerEndFrame (VkCommandBuffer cmd);
+
+/**
+ * Begin a named GPU profiling scope.
+ *
+ * @param cmd command buffer used by this frame.
+ * @param name name of the scope. This must be a string that stays valid for
+ * the duration of the program, such as a string literal.
+ */
+void
+ProfileScopeBegin (VkCommandBuffer cmd, const char *name);
+
+/**
+ * End the innermost GPU profiling scope.
+ *
+ * @param cmd command buffer used by this frame.
+ */
+void
+ProfileScopeEnd (VkCommandBuffer cmd);
+
+/**
+ * RAII helper for ProfileScopeBegin and ProfileScopeEnd.
+ */
+class GPUProfileScope {
+private:
+	VkCommandBuffer m_cmd;
+
+public:
+	GPUProfileScope (VkCommandBuffer cmd, const char *name)
+		: m_cmd (cmd)
+	{
+		ProfileScopeBegin (cmd, name);
+	}
+
+	~GPUProfileScope (void)
+	{
+		ProfileScopeEnd (m_cmd);
+	}
+
+	GPUProfileScope (const GPUProfileScope &) = delete;
+	GPUProfileScope &operator= (const GPUProfileScope &) = delete;
+};
+
+/**
+ * Collect pipeline statistics for scopes directly below the root scope.
+ *
+ * @note pipeline statistics queries cannot cross render pass boundaries, so
+ * such scopes must begin and end within the same subpass, or both outside of a
+ * render pass. This has no effect if the device does not support the
+ * pipelineStatisticsQuery feature.
+ *
+ * @param enable whether to collect pipeline statistics.
+ */
+void
+GPUProfilerEnablePipelineStatistics (bool enable);
+
+enum GPUProfilerStatistic {
+	GPU_STAT_INPUT_ASSEMBLY_PRIMITIVES,
+	GPU_STAT_VERTEX_SHADER_INVOCATIONS,
+	GPU_STAT_FRAGMENT_SHADER_INVOCATIONS,
+	GPU_STAT_COMPUTE_SHADER_INVOCATIONS,
+	NUM_GPU_STATS
+};
+
+struct GPUProfilerScope {
+	const char *name;
+	uint32_t depth;
+
+	/** Start of the scope, in milliseconds after the start of the frame. */
+	double start;
+
+	/** Duration of the scope in milliseconds. */
+	double duration;
+
+	/** Raw GPU timestamps, in nanoseconds. */
+	uint64_t begin_ns, end_ns;
+
+	/** Time the CPU spent recording the scope, in milliseconds. */
+	double cpu_duration;
+
+	bool has_statistics;
+	uint64_t statistics[NUM_GPU_STATS];
+};
+
+/**
+ * Get the results of the most recently resolved frame. Scopes are stored in
+ * the order they were begun, so the list is a pre-order traversal of the scope
+ * tree. The first scope is always the root scope.
+ *
+ * @param scopes pointer to a variable that receives a pointer to the scope
+ * list. The list is valid until the next call to GPUProfilerNextFrame.
+ * @param count pointer to a variable that receives the number of scopes.
+ *
+ * @return the frame number of the results, or zero if no frame has been
+ * resolved yet.
+ */
+uint64_t
+GPUProfilerGetResults (const GPUProfilerScope **scopes, size_t *count);
+
+/**
+ * Get the frame number of the frame currently being recorded.
+ */
+uint64_t
+GPUProfilerGetFrameNumber (void);
+
+/**
+ * Draw the results of the most recently resolved frame as an indented table
+ * to the Debug UI.
+ *
+ * @param x, y position of the table.
+ * @param corner which corner the position is relative to.
+ */
+void
+GPUProfilerDrawDebugUI (int x, int y, DebugUICorner corner);
+
+/**
+ * Write the results of the most recently resolved frame to a trace file in
+ * the Chrome trace event format.
+ *
+ * @param path path of the trace file.
+ *
+ * @return true on success, false otherwise.
+ */
+bool
+GPUProfilerWriteTrace (const char *path);
+
+}
@@ -0,0 +1,150 @@
+/**
+ * Geometry arena.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/GPUMemory.h>
+
+#include <vector>
+
+VK_DEFINE_HANDLE (VmaVirtualBlock)
+VK_DEFINE_NON_DISPATCHABLE_HANDLE (VmaVirtualAllocation)
+
+/**
+ * A geometry arena holds the vertices and indices of many meshes in one large
+ * vertex buffer and one large index buffer. Meshes are suballocated from them
+ * and are referred to by vertex and index ranges, so drawing many meshes only
+ * needs the arena to be bound once, and the ranges map directly onto
+ * vkCmdDrawIndexed parameters and VkDrawIndexedIndirectCommand.
+ *
+ * All meshes in an arena share one vertex layout. Indices are relative to the
+ * first vertex of their mesh.
+ */
+
+namespace LGE {
+
+struct GeometryRange {
+	uint32_t m_firstVertex = 0;
+	uint32_t m_vertexCount = 0;
+	uint32_t m_firstIndex = 0;
+	uint32_t m_indexCount = 0;
+
+	VmaVirtualAllocation m_vertexAllocation = VK_NULL_HANDLE;
+	VmaVirtualAllocation m_indexAllocation = VK_NULL_HANDLE;
+
+	constexpr
+	operator bool (void) const
+	{
+		return m_vertexAllocation != VK_NULL_HANDLE;
+	}
+};
+
+class GeometryArena {
+private:
+	uint32_t m_vertexStride;
+	VkIndexType m_indexType;
+	uint32_t m_indexSize;
+
+	GPUBuffer m_vertexBuffer;
+	GPUBuffer m_indexBuffer;
+	VmaVirtualBlock m_vertexBlock = VK_NULL_HANDLE;
+	VmaVirtualBlock m_indexBlock = VK_NULL_HANDLE;
+
+	struct PendingFree {
+		GeometryRange m_range;
+		uint64_t m_frame;
+	};
+
+	/** Ranges that frames in flight might still be drawing from. */
+	std::vector<PendingFree> m_pendingFrees;
+
+	void
+	Destroy (void);
+
+	void
+	ReclaimPendingFrees (void);
+
+	void
+	FreeNow (GeometryRange &range);
+
+public:
+	/**
+	 * Create a geometry arena.
+	 *
+	 * @param vertex_stride size of a vertex in bytes.
+	 * @param max_vertices capacity of the vertex buffer, in vertices.
+	 * @param max_indices capacity of the index buffer, in indices. If 0,
+	 * the arena has no index buffer.
+	 * @param index_type VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32.
+	 * @param usage additional buffer usage bits for both buffers, for
+	 * example VK_BUFFER_USAGE_STORAGE_BUFFER_BIT to read them from shaders.
+	 */
+	GeometryArena (uint32_t vertex_stride, uint32_t max_vertices, uint32_t max_indices,
+		VkIndexType index_type = VK_INDEX_TYPE_UINT32, VkBufferUsageFlags usage = 0);
+
+	~GeometryArena (void);
+
+	GeometryArena (const GeometryArena &) = delete;
+
+	GeometryArena &
+	operator= (const GeometryArena &) = delete;
+
+	/**
+	 * Allocate space for a mesh and upload its data.
+	 *
+	 * @param vertices vertex data, vertex_count * vertex_stride bytes.
+	 * @param vertex_count number of vertices.
+	 * @param indices index data of the index type, or nullptr.
+	 * @param index_count number of indices.
+	 * @param range receives the ranges of the mesh.
+	 *
+	 * @return true on success, false if the arena is full.
+	 */
+	bool
+	Allocate (const void *vertices, uint32_t vertex_count,
+		const void *indices, uint32_t index_count, GeometryRange &range);
+
+	/**
+	 * Free the ranges of a mesh. The space is reused once the frames in
+	 * flight have completed.
+	 */
+	void
+	Free (GeometryRange &range);
+
+	/**
+	 * Bind the vertex buffer and, if there is one, the index buffer.
+	 *
+	 * @param cmd command buffer.
+	 * @param binding vertex input binding of the vertex buffer.
+	 */
+	void
+	Bind (VkCommandBuffer cmd, uint32_t binding = 0);
+
+	/**
+	 * Draw a mesh. The arena must be bound.
+	 */
+	void
+	Draw (VkCommandBuffer cmd, const GeometryRange &range,
+		uint32_t instance_count = 1, uint32_t first_instance = 0);
+
+	VkBuffer
+	GetVertexBuffer (void) const
+	{
+		return m_vertexBuffer.m_buffer;
+	}
+
+	VkBuffer
+	GetIndexBuffer (void) const
+	{
+		return m_indexBuffer.m_buffer;
+	}
+
+	uint32_t
+	GetVertexStride (void) const
+	{
+		return m_vertexStride;
+	}
+};
+
+}
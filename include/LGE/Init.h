@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 namespace LGE {
 
 class Application;
@@ -11,9 +13,39 @@ class Application;
 extern bool bIsProduction;
 extern int gExitCode;
 
+/**
+ * Render into offscreen images instead of a window. Set by the "headless"
+ * argument to LGEMain.
+ */
+extern bool bIsHeadless;
+
+/**
+ * Exit the event loop after this many frames, or never if zero. Set by the
+ * "frames=N" argument to LGEMain.
+ */
+extern uint64_t gFrameLimit;
+
+/**
+ * Exit the event loop after this many seconds, or never if zero. Set by the
+ * "seconds=N" argument to LGEMain.
+ */
+extern double gTimeLimit;
+
 /**
  * Start the LGE engine.
  *
+ * Recognized arguments:
+ *   prod               disable debug logging after initialization
+ *   headless           render offscreen, without a window or swapchain
+ *   frames=N           exit after N frames
+ *   seconds=N          exit after N seconds
+ *   readback=PATH      write the last headless frame to a PNG file
+ *   checksum           print a checksum of the last headless frame
+ *   trace=PATH         capture a trace and write it to PATH
+ *   trace-frames=N     number of frames to capture (default 120)
+ *   log-binary=PATH    write a binary log to PATH
+ *   profiler-overlay   show the profiler overlay
+ *
  * @param app Pointer to an Application instance.
  * @param argv nullptr or argument vector as passed to main.
  *
@@ -0,0 +1,88 @@
+/**
+ * KTX2 texture loader.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/GPUMemory.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace LGE {
+
+/** Entry of the level index of a KTX2 file. */
+struct KTX2Level {
+	uint64_t byteOffset;
+	uint64_t byteLength;
+	uint64_t uncompressedByteLength;
+};
+
+/** What LGE needs to know about a KTX2 file to upload it. */
+struct KTX2Info {
+	VkFormat m_format;
+	VkExtent2D m_extent;
+
+	/** Array layers times faces. */
+	uint32_t m_layers;
+
+	/** VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT for cube maps. */
+	VkImageCreateFlags m_flags;
+
+	/** The file only has level 0, and asks for a generated mip chain. */
+	bool m_generateMipmaps;
+
+	/** Level 0 first. Every level holds all layers and faces. */
+	std::vector<KTX2Level> m_levels;
+};
+
+/** Size of the KTX2 header. The level index follows it. */
+static constexpr size_t KTX2_HEADER_SIZE = 80;
+
+/**
+ * Parse and validate the header and level index of a KTX2 file. This is
+ * meant for loaders that do not read the whole file at once.
+ *
+ * @param data start of the file. This must hold at least the header and the
+ * level index, KTX2_HEADER_SIZE + levelCount * sizeof (KTX2Level) bytes.
+ * @param size size of data.
+ * @param file_size size of the whole file, to validate the level index.
+ * @param name name of the file, for error messages.
+ * @param info receives the parsed information.
+ */
+void
+ReadKTX2Info (const void *data, size_t size, uint64_t file_size, const char *name,
+	KTX2Info &info);
+
+/**
+ * Load a 2D texture from a KTX2 file and upload it to the GPU with
+ * MMUploadTexture2DArray. All mip levels in the file are uploaded as they
+ * are, so block-compressed textures (BC1 to BC7) stay compressed in VRAM. If
+ * the file has no mip levels (levelCount 0), the mip chain is generated on
+ * the GPU. Array textures and cube maps become images with one layer per
+ * layer and face; cube maps are cube compatible, so MMCreateImageView gives
+ * them a cube view.
+ *
+ * Supercompressed files (Basis Universal, Zstandard) and files without a
+ * Vulkan format are not supported, nor are 3D textures. Errors are reported
+ * by throwing std::runtime_error.
+ *
+ * @param path path of the KTX2 file.
+ *
+ * @return GPU image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+ */
+GPUImage
+LoadKTX2 (const char *path);
+
+/**
+ * Load a 2D texture from a KTX2 file in memory, like LoadKTX2 (path).
+ *
+ * @param data contents of the KTX2 file.
+ * @param size size of data.
+ */
+GPUImage
+LoadKTX2 (const void *data, size_t size);
+
+}
@@ -0,0 +1,71 @@
+/**
+ * LZ compression for asset packs.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A simple byte-oriented LZ77 format in the style of LZ4 blocks. This is
+ * shared between the asset pack loader and the offline packer in
+ * scripts/make_pack.cc.
+ *
+ * A block is a sequence of sequences. Every sequence is:
+ *
+ *   u8 token             high nibble: literal count, low nibble: match
+ *                        length - LZ_MIN_MATCH; 15 means that the count
+ *                        continues in extra bytes
+ *   [u8 ...]             extra literal count bytes, added to 15; every
+ *                        byte of 255 is followed by another one
+ *   literals
+ *   u16 offset           distance back to the match, little-endian, not 0
+ *   [u8 ...]             extra match length bytes, as for literals
+ *
+ * The last sequence ends after its literals, at the end of the block. A
+ * match may overlap the bytes that it produces.
+ */
+
+namespace LGE {
+
+static constexpr size_t LZ_MIN_MATCH = 4;
+static constexpr size_t LZ_MAX_OFFSET = 65535;
+
+/**
+ * Get the largest possible compressed size of size bytes.
+ */
+static inline size_t
+LZCompressBound (size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+/**
+ * Compress a block.
+ *
+ * @param in data to compress.
+ * @param size size of data. Must be less than 4 GiB.
+ * @param out output buffer of at least LZCompressBound (size) bytes.
+ *
+ * @return compressed size.
+ */
+size_t
+LZCompress (const void *in, size_t size, void *out);
+
+/**
+ * Decompress a block. Corrupt input is detected, and never makes this read
+ * or write outside of the buffers.
+ *
+ * @param in compressed block.
+ * @param in_size size of the compressed block.
+ * @param out output buffer.
+ * @param out_size exact size of the decompressed block.
+ *
+ * @return false if the block is corrupt or does not decompress to out_size
+ * bytes.
+ */
+bool
+LZDecompress (const void *in, size_t in_size, void *out, size_t out_size);
+
+}
@@ -8,10 +8,179 @@
 #define LGE_MODULE "<no LGE_MODULE>"
 #endif
 
+/**
+ * Log levels. Messages below LGE_LOG_LEVEL are compiled out, which is set for
+ * the whole build by the LGE_LOG_LEVEL CMake option. A module can raise its
+ * own minimum level by defining LGE_MODULE_LOG_LEVEL next to LGE_MODULE.
+ */
+#define LGE_LOG_LEVEL_TRACE 0
+#define LGE_LOG_LEVEL_DEBUG 1
+#define LGE_LOG_LEVEL_INFO 2
+#define LGE_LOG_LEVEL_WARNING 3
+#define LGE_LOG_LEVEL_ERROR 4
+#define LGE_LOG_LEVEL_NONE 5
+
+#ifndef LGE_LOG_LEVEL
+#define LGE_LOG_LEVEL LGE_LOG_LEVEL_TRACE
+#endif
+
+#ifndef LGE_MODULE_LOG_LEVEL
+#define LGE_MODULE_LOG_LEVEL LGE_LOG_LEVEL_TRACE
+#endif
+
+#define LGE_LOG_MIN_LEVEL \
+	((LGE_MODULE_LOG_LEVEL > LGE_LOG_LEVEL) ? LGE_MODULE_LOG_LEVEL : LGE_LOG_LEVEL)
+
+/**
+ * Log a message at the given level. When the level is below
+ * LGE_LOG_MIN_LEVEL, the arguments are not evaluated and no code is emitted.
+ */
+#define LGE_LOG_AT(level, ...)							\
+	do {									\
+		if constexpr ((level) >= LGE_LOG_MIN_LEVEL)			\
+			::LGE::LogAt ((::LGE::LogLevel) (level), LGE_MODULE,	\
+				__VA_ARGS__);					\
+	} while (0)
+
+#define LGE_LOG_TRACE(...) LGE_LOG_AT (LGE_LOG_LEVEL_TRACE, __VA_ARGS__)
+#define LGE_LOG_DEBUG(...) LGE_LOG_AT (LGE_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LGE_LOG_INFO(...) LGE_LOG_AT (LGE_LOG_LEVEL_INFO, __VA_ARGS__)
+#define LGE_LOG_WARNING(...) LGE_LOG_AT (LGE_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define LGE_LOG_ERROR(...) LGE_LOG_AT (LGE_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+/**
+ * Log does not format messages on the calling thread. Instead, it captures
+ * the timestamp, the module, the format string and a copy of the arguments
+ * into a lock-free multi-producer ring buffer. A background thread formats
+ * the messages and writes them out. Strings are copied, so arguments do not
+ * have to outlive the call. The format string itself is not copied, and must
+ * be a string literal.
+ *
+ * The background thread is started by LogInit. Before that, and after
+ * LogTerminate, messages are formatted and written synchronously.
+ *
+ * Optionally, the background thread writes a binary log instead of text. A
+ * binary log stores every distinct format string once, and every message as
+ * a format string ID followed by the captured arguments. Use
+ * scripts/decode_log to turn it into text.
+ */
+
 namespace LGE {
 
 extern bool bLoggingEnabled;
 
+enum LogLevel : uint8_t {
+	LOG_LEVEL_TRACE = LGE_LOG_LEVEL_TRACE,
+	LOG_LEVEL_DEBUG = LGE_LOG_LEVEL_DEBUG,
+	LOG_LEVEL_INFO = LGE_LOG_LEVEL_INFO,
+	LOG_LEVEL_WARNING = LGE_LOG_LEVEL_WARNING,
+	LOG_LEVEL_ERROR = LGE_LOG_LEVEL_ERROR
+};
+
+enum LogArgType : uint8_t {
+	LOG_ARG_I64 = 1,
+	LOG_ARG_U64,
+	LOG_ARG_F64,
+	LOG_ARG_PTR,
+	LOG_ARG_STR
+};
+
+/**
+ * Captured log message arguments. Every argument is stored as a LogArgType
+ * tag followed by its value. Strings are stored as a 16-bit length followed
+ * by the characters, and are truncated to fit. Arguments that do not fit at
+ * all are dropped, along with the ones after them, and are printed as "<?>".
+ */
+struct LogArgs {
+	static constexpr size_t MAX_SIZE = 224;
+
+	uint8_t m_data[MAX_SIZE];
+	size_t m_size = 0;
+
+	/** An argument was dropped. m_size stays at the end of the last one. */
+	bool m_truncated = false;
+
+	void
+	Put (LogArgType type, const void *value, size_t size)
+	{
+		if (m_truncated || m_size + 1 + size > MAX_SIZE) {
+			m_truncated = true;
+			return;
+		}
+
+		m_data[m_size++] = type;
+		::memcpy (&m_data[m_size], value, size);
+		m_size += size;
+	}
+
+	void
+	PutString (const char *s)
+	{
+		if (!s)
+			s = "(null)";
+
+		if (m_truncated || m_size + 3 > MAX_SIZE) {
+			m_truncated = true;
+			return;
+		}
+
+		size_t len = ::strlen (s);
+		if (len > MAX_SIZE - m_size - 3)
+			len = MAX_SIZE - m_size - 3;
+
+		uint16_t len16 = len;
+		m_data[m_size++] = LOG_ARG_STR;
+		::memcpy (&m_data[m_size], &len16, 2);
+		::memcpy (&m_data[m_size + 2], s, len);
+		m_size += 2 + len;
+	}
+};
+
+template <class T>
+static inline void
+LogEncodeArg (LogArgs &args, T &&value)
+{
+	using U = std::decay_t<T>;
+	if constexpr (std::is_same_v<U, char *> || std::is_same_v<U, const char *>) {
+		args.PutString (value);
+	} else if constexpr (std::is_floating_point_v<U>) {
+		double v = value;
+		args.Put (LOG_ARG_F64, &v, sizeof (v));
+	} else if constexpr (std::is_enum_v<U>) {
+		int64_t v = (int64_t) value;
+		args.Put (LOG_ARG_I64, &v, sizeof (v));
+	} else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+		int64_t v = value;
+		args.Put (LOG_ARG_I64, &v, sizeof (v));
+	} else if constexpr (std::is_integral_v<U>) {
+		uint64_t v = value;
+		args.Put (LOG_ARG_U64, &v, sizeof (v));
+	} else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+		uint64_t v = (uintptr_t) value;
+		args.Put (LOG_ARG_PTR, &v, sizeof (v));
+	} else {
+		static_assert (std::is_pointer_v<U>, "unsupported log argument type");
+	}
+}
+
+/**
+ * Queue a captured log message. Use Log instead.
+ *
+ * @param level severity of the message.
+ * @param origin message source. This should be LGE_MODULE.
+ * @param fmt printf format string. Must stay valid for the duration of the
+ * program.
+ * @param args captured arguments.
+ */
+void
+LogSubmit (LogLevel level, const char *origin, const char *fmt, const LogArgs &args);
+
 /**
  * Output a log message.
  *
@@ -19,23 +188,90 @@ extern bool bLoggingEnabled;
  * @param fmt printf format string.
  *
  * @note It is strongly recommended to use Log instead of DebugPrint.
+ * DebugPrint formats the message on the calling thread.
  */
 void
 DebugPrint (const char *origin, const char *fmt, ...);
 
 /**
- * Output a message if logging is enabled.
+ * Output a message if logging is enabled. Use the LGE_LOG_* macros instead.
  *
+ * @param level severity of the message.
+ * @param origin message source.
  * @param fmt printf format string.
  */
 template <class ...Args>
 static inline void
-Log (const char *fmt, Args &&...args)
+LogAt (LogLevel level, const char *origin, const char *fmt, Args &&...args)
 {
 	if (!bLoggingEnabled)
 		return;
 
-	DebugPrint (LGE_MODULE, fmt, args...);
+	LogArgs captured;
+	(LogEncodeArg (captured, args), ...);
+	LogSubmit (level, origin, fmt, captured);
+}
+
+/**
+ * Output an informational message if logging is enabled.
+ *
+ * @note unlike LGE_LOG_INFO, the arguments are evaluated even when
+ * informational messages are compiled out.
+ *
+ * @param fmt printf format string.
+ */
+template <class ...Args>
+static inline void
+Log (const char *fmt, Args &&...args)
+{
+	if constexpr (LGE_LOG_LEVEL_INFO >= LGE_LOG_MIN_LEVEL)
+		LogAt (LOG_LEVEL_INFO, LGE_MODULE, fmt, args...);
 }
 
+/**
+ * What Log does when the ring buffer is full.
+ */
+enum class LogOverflowPolicy {
+	/** Drop the message. The number of dropped messages is reported. */
+	DROP,
+
+	/** Wait for the background thread to make room. */
+	BLOCK
+};
+
+/**
+ * Set the overflow policy. The default is LogOverflowPolicy::DROP.
+ */
+void
+LogSetOverflowPolicy (LogOverflowPolicy policy);
+
+/**
+ * Write a binary log instead of text. This must be called before LogInit.
+ *
+ * @param path path of the binary log file.
+ *
+ * @return true on success, false otherwise.
+ */
+bool
+LogOpenBinary (const char *path);
+
+/**
+ * Start the background logging thread. This also installs handlers that write
+ * out queued messages on a crash, and at exit.
+ */
+void
+LogInit (void);
+
+/**
+ * Write out all queued messages and stop the background logging thread.
+ */
+void
+LogTerminate (void);
+
+/**
+ * Wait until all messages queued before this call have been written.
+ */
+void
+LogFlush (void);
+
 }
@@ -0,0 +1,60 @@
+/**
+ * Formatting of captured log messages.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/Log.h>
+
+/**
+ * This is shared between the background logging thread and the offline
+ * binary log decoder in scripts/decode_log.cc.
+ *
+ * A binary log starts with LOG_BINARY_MAGIC, followed by the 64-bit
+ * timestamp in nanoseconds that all other timestamps are relative to. After
+ * that, it contains a sequence of records, all in host byte order:
+ *
+ *   LOG_RECORD_FORMAT:  u8 type, u32 id, u8 level, u16 origin length,
+ *                       origin, u16 format length, format
+ *   LOG_RECORD_MESSAGE: u8 type, u32 id, u64 time, u16 args size, args
+ *
+ * Every format record appears before the first message that refers to it.
+ */
+
+namespace LGE {
+
+static constexpr char LOG_BINARY_MAGIC[8] = { 'L', 'G', 'E', 'L', 'O', 'G', 0, 1 };
+
+enum LogRecordType : uint8_t {
+	LOG_RECORD_FORMAT = 1,
+	LOG_RECORD_MESSAGE
+};
+
+/**
+ * Format a captured message.
+ *
+ * @param out output buffer. The output is always null-terminated.
+ * @param size size of the output buffer. Must be at least 1.
+ * @param fmt printf format string.
+ * @param args captured arguments.
+ *
+ * @return the number of characters written, excluding the null terminator.
+ */
+size_t
+LogFormatMessage (char *out, size_t size, const char *fmt, const LogArgs &args);
+
+/**
+ * Format a captured message as a line of log output, including the
+ * timestamp, the origin, the level and a trailing newline.
+ *
+ * @param out output buffer. The output is always null-terminated.
+ * @param size size of the output buffer. Must be at least 2.
+ * @param seconds timestamp of the message.
+ *
+ * @return the number of characters written, excluding the null terminator.
+ */
+size_t
+LogFormatLine (char *out, size_t size, double seconds, LogLevel level,
+	const char *origin, const char *fmt, const LogArgs &args);
+
+}
@@ -0,0 +1,25 @@
+/**
+ * Minimal PNG writer.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace LGE {
+
+/**
+ * Write an 8-bit RGBA image to a PNG file. The image data is stored without
+ * compression, so this is meant for debugging and testing, not for assets.
+ *
+ * @param path path of the PNG file.
+ * @param width, height image dimensions in pixels.
+ * @param pixels tightly packed RGBA8 pixel data, top row first.
+ *
+ * @return true on success, false otherwise.
+ */
+bool
+WritePNG (const char *path, uint32_t width, uint32_t height, const void *pixels);
+
+}
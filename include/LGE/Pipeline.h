@@ -14,7 +14,20 @@ extern VkPipelineCache gPipelineCache;
 class Pipeline {
 protected:
 	VkPipeline m_pipeline = VK_NULL_HANDLE;
-	VkRenderPass m_targetRenderPass;
+	VkRenderPass m_targetRenderPass = VK_NULL_HANDLE;
+
+#ifdef LGE_SHADER_HOT_RELOAD
+private:
+	/**
+	 * The pipeline that Bind binds. A shader reload calls Create on a
+	 * background thread, so Create writes m_pipeline under a lock, and
+	 * ShaderReloadNextFrame swaps the result in.
+	 */
+	VkPipeline m_bound = VK_NULL_HANDLE;
+
+	friend struct ShaderReloadAccess;
+protected:
+#endif
 
 	/**
 	 * Pipeline constructor.
@@ -38,7 +51,8 @@ public:
 	virtual ~Pipeline (void);
 
 	/**
-	 * Bind the pipeline.
+	 * Bind the pipeline. Graphics pipelines are recreated when the render
+	 * pass of the Application changes.
 	 *
 	 * @param cmd command buffer.
 	 * @param bind_point bind point.
@@ -47,6 +61,19 @@ public:
 	Bind (VkCommandBuffer cmd, VkPipelineBindPoint bind_point);
 };
 
+/**
+ * Destroy the pipelines that Bind replaced CPU_RENDER_AHEAD frames ago.
+ * Called by the Application at the start of a frame.
+ */
+void
+PipelineNextFrame (void);
+
+/**
+ * Destroy all pipelines that Bind replaced. The device must be idle.
+ */
+void
+PipelineTerminate (void);
+
 /**
  * The purpose of LinkShaderModules and FreeShaderModules is
  * 1) To make life easier for developers by reducing the number of different
@@ -82,4 +109,21 @@ LinkShaderModules (VkGraphicsPipelineCreateInfo *pipeline_ci,
 void
 FreeShaderModules (VkGraphicsPipelineCreateInfo *pipeline_ci);
 
+/**
+ * Store the specified compute shader in the pipeline create info.
+ *
+ * @note FreeShaderModules must be called with the same pipeline create info,
+ * otherwise the VkShaderModule object will be leaked.
+ */
+void
+LinkShaderModules (VkComputePipelineCreateInfo *pipeline_ci,
+	const ShaderModuleInfo &shader);
+
+/**
+ * Free the shader module associated with a compute pipeline created by
+ * LinkShaderModules.
+ */
+void
+FreeShaderModules (VkComputePipelineCreateInfo *pipeline_ci);
+
 }
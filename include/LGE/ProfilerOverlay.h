@@ -0,0 +1,56 @@
+/**
+ * Profiler overlay.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/DebugUI.h>
+
+/**
+ * The profiler overlay shows a frame time graph with p99 markers, the GPU
+ * profiler scope tree with CPU and GPU time per scope, GPU memory usage per
+ * heap, and the engine counters of the previous frame. It is drawn with
+ * DebugUI, and is hidden by default.
+ *
+ * Frame times are collected while the overlay is hidden, so the graph is
+ * complete as soon as it is shown.
+ */
+
+namespace LGE {
+
+/**
+ * Show or hide the profiler overlay.
+ */
+void
+ProfilerOverlaySetVisible (bool visible);
+
+/**
+ * Toggle the profiler overlay. This is meant to be bound to a key by the
+ * application.
+ */
+void
+ProfilerOverlayToggle (void);
+
+/**
+ * Test if the profiler overlay is visible.
+ */
+bool
+ProfilerOverlayIsVisible (void);
+
+/**
+ * Record the frame time of the previous frame. This is called by
+ * Application::Render after GPUProfilerNextFrame.
+ */
+void
+ProfilerOverlayNextFrame (void);
+
+/**
+ * Draw the profiler overlay to the Debug UI, if it is visible.
+ *
+ * @param x, y position of the overlay.
+ * @param corner which corner the position is relative to.
+ */
+void
+ProfilerOverlayDraw (int x, int y, DebugUICorner corner);
+
+}
@@ -0,0 +1,139 @@
+/**
+ * Shader hot reload.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <LGE/Pipeline.h>
+
+#include <stdint.h>
+
+#ifdef LGE_SHADER_HOT_RELOAD
+#include <vector>
+#endif
+
+/**
+ * Shader hot reload is a development aid, compiled in with the CMake option
+ * LGE_SHADER_HOT_RELOAD. Without it, the functions here do nothing.
+ *
+ * The GLSL sources of watched shaders are watched with inotify. When one is
+ * saved, a background thread compiles it to SPIR-V with glslang, using the
+ * flags of lge_add_shaders, and recreates every Pipeline whose Create linked
+ * the shader. The new VkPipeline objects are swapped in by
+ * ShaderReloadNextFrame, between frames, and the old ones are destroyed once
+ * the frames that use them have completed. If the shader does not compile,
+ * the compiler output is logged and the pipelines are left as they are.
+ *
+ * Shaders are known by the address of their embedded SPIR-V array, so Create
+ * implementations keep passing the embedded arrays to LinkShaderModules,
+ * which substitutes the latest compiled code.
+ *
+ * Create may thus be called on the background thread. A Pipeline subclass
+ * whose destructor destroys objects that Create uses, such as its pipeline
+ * layout, must call ShaderReloadForget (this) before it does so.
+ */
+
+namespace LGE {
+
+#ifdef LGE_SHADER_HOT_RELOAD
+
+/**
+ * Watch the GLSL source of an embedded shader.
+ *
+ * @param code SPIR-V array of the shader, as passed to LinkShaderModules.
+ * @param path path of the GLSL source. Relative paths are relative to the LGE
+ * source directory.
+ */
+void
+ShaderReloadWatch (const uint32_t *code, const char *path);
+
+/**
+ * Wait for the recreation of a pipeline that is being destroyed, and stop
+ * recreating it.
+ */
+void
+ShaderReloadForget (Pipeline *pipeline);
+
+/**
+ * Swap in recreated pipelines, and destroy the pipelines that they replaced
+ * once unused. Called by the Application at the start of a frame.
+ */
+void
+ShaderReloadNextFrame (void);
+
+/**
+ * Stop watching shaders, and destroy the pipelines that are waiting to be
+ * swapped in or destroyed. The device must be idle.
+ */
+void
+ShaderReloadTerminate (void);
+
+/**
+ * Keeps the background thread from recreating pipelines while it exists.
+ * Held by the Application while it replaces the render pass that graphics
+ * pipelines are created for.
+ */
+class ShaderReloadPause {
+public:
+	ShaderReloadPause (void);
+	~ShaderReloadPause (void);
+};
+
+/**
+ * Used by Pipeline to serialize Create with the background thread, and to
+ * record the shaders that Create links.
+ */
+class ShaderReloadCreateScope {
+	Pipeline *m_pipeline;
+	std::vector<const uint32_t *> m_shaders;
+	ShaderReloadCreateScope *m_outer;
+
+	friend void
+	ShaderReloadResolve (ShaderModuleInfo &shader);
+public:
+	ShaderReloadCreateScope (Pipeline *pipeline);
+	~ShaderReloadCreateScope (void);
+
+	/** Record the shaders, after Create has succeeded. */
+	void
+	Commit (void);
+};
+
+/**
+ * Used by LinkShaderModules: record that the current Create links a shader,
+ * and replace its code with the latest compiled code.
+ */
+void
+ShaderReloadResolve (ShaderModuleInfo &shader);
+
+#else
+
+static inline void
+ShaderReloadWatch (const uint32_t *, const char *)
+{
+}
+
+static inline void
+ShaderReloadForget (Pipeline *)
+{
+}
+
+static inline void
+ShaderReloadNextFrame (void)
+{
+}
+
+static inline void
+ShaderReloadTerminate (void)
+{
+}
+
+class ShaderReloadPause {
+public:
+	ShaderReloadPause (void) {}
+	~ShaderReloadPause (void) {}
+};
+
+#endif
+
+}
@@ -0,0 +1,75 @@
+/**
+ * Per-frame engine counters.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Counters are incremented by engine code as work happens, and are snapshotted
+ * and reset once per frame by Application::Render. They are only touched by
+ * the thread running the event loop, so they are plain integers.
+ */
+
+namespace LGE {
+
+enum StatCounter {
+	STAT_GPU_ALLOCATIONS,
+	STAT_TEMPORARY_BUFFERS,
+	STAT_TEMPORARY_BUFFER_BYTES,
+	STAT_STAGING_UPLOADS,
+	STAT_UPLOAD_BYTES,
+	STAT_DEFRAG_MOVES,
+	STAT_DEFRAG_BYTES,
+	STAT_STREAMING_UPLOAD_BYTES,
+	STAT_STREAMING_DEMOTIONS,
+	STAT_DESCRIPTOR_SETS,
+	STAT_DESCRIPTOR_POOLS,
+	STAT_PIPELINES_CREATED,
+	STAT_PIPELINE_BINDS,
+	STAT_DEBUGUI_GLYPHS,
+	STAT_DEBUGUI_SHAPES,
+	NUM_STATS
+};
+
+extern uint64_t gStatCounters[NUM_STATS];
+
+/**
+ * Add to a counter for the current frame.
+ *
+ * @param counter counter to add to.
+ * @param value value to add.
+ */
+static inline void
+StatAdd (StatCounter counter, uint64_t value = 1)
+{
+	gStatCounters[counter] += value;
+}
+
+/**
+ * Snapshot the counters of the current frame and reset them. This is called
+ * by Application::Render at the start of every frame.
+ */
+void
+StatsNextFrame (void);
+
+/**
+ * Get the counters of the previous frame.
+ *
+ * @return pointer to NUM_STATS counter values.
+ */
+const uint64_t *
+StatsGetLastFrame (void);
+
+/**
+ * Get the name of a counter, suitable as a column name.
+ *
+ * @param counter counter.
+ *
+ * @return name of the counter.
+ */
+const char *
+StatGetName (StatCounter counter);
+
+}
@@ -0,0 +1,136 @@
+/**
+ * Texture streaming.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#define VK_NO_PROTOTYPES 1
+#include <vulkan/vulkan.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Streamed textures are KTX2 files with a mip chain, of which only the
+ * smallest levels are resident when the texture is created. The application
+ * tells the streamer how large every texture appears on screen, and the
+ * missing levels are read from disk with AsyncIO, most blurry textures first.
+ * The reads go straight into a persistently mapped staging ring, which is
+ * registered with AsyncIO.
+ *
+ * TextureStreamingNextFrame uploads the levels that have been read into a
+ * new, larger image, by recording copies from the staging ring into the frame
+ * command buffer. The new image replaces the old one in the same frame, so
+ * nothing waits for the GPU. The old image and its view stay valid until the
+ * frames in flight have completed.
+ *
+ * When the memory usage of a device-local heap rises above a threshold of
+ * its budget, textures are demoted one level at a time, starting with those
+ * that are the most oversampled on screen, and no new levels are streamed in.
+ * Uploads are limited to a number of bytes per frame.
+ *
+ * All functions must be called from the main thread.
+ */
+
+namespace LGE {
+
+typedef struct StreamedTexture_T *StreamedTexture;
+
+/**
+ * Called from TextureStreamingNextFrame when the image behind a streamed
+ * texture has been replaced. Use it to update persistent descriptor sets.
+ *
+ * @param user user pointer passed to StreamedTextureSetCallback.
+ */
+typedef void (*StreamedTextureCallback) (void *user);
+
+/**
+ * Create a streamed texture. This reads the header and the smallest mip
+ * levels of the file, which are uploaded by the next call to
+ * TextureStreamingNextFrame. Errors are reported by throwing
+ * std::runtime_error.
+ *
+ * @param path path of a KTX2 file. The file must stay in place for as long as
+ * the texture exists, and have its mip levels stored in the file; files that
+ * ask for generated mip levels cannot be streamed.
+ * @param min_resident_size largest width or height of the levels that are
+ * always resident.
+ */
+StreamedTexture
+StreamedTextureCreate (const char *path, uint32_t min_resident_size = 64);
+
+/**
+ * Destroy a streamed texture after the current frame has completed
+ * rendering.
+ */
+void
+StreamedTextureDestroy (StreamedTexture texture);
+
+/**
+ * Set how large the texture appears on screen. The streamer aims for one
+ * texel per pixel, so a 4096x4096 texture that covers 500 pixels needs mip
+ * level 3 and up. The default is 0, which only keeps the smallest levels
+ * resident.
+ *
+ * @param screen_size width or height of the texture on screen, in pixels.
+ */
+void
+StreamedTextureSetPriority (StreamedTexture texture, float screen_size);
+
+/**
+ * Get an image view of all resident levels of the texture. This is only
+ * valid until the next call to TextureStreamingNextFrame.
+ */
+VkImageView
+StreamedTextureGetView (StreamedTexture texture);
+
+/**
+ * Get the mip level of the file that is level 0 of the resident image.
+ */
+uint32_t
+StreamedTextureGetResidentLevel (StreamedTexture texture);
+
+/**
+ * Set the callback that is called when the image behind the texture has
+ * been replaced.
+ *
+ * @param callback callback, or nullptr to remove it.
+ * @param user user pointer passed to the callback.
+ */
+void
+StreamedTextureSetCallback (StreamedTexture texture, StreamedTextureCallback callback,
+	void *user);
+
+/**
+ * Set the maximum number of bytes that are uploaded per frame. A mip level
+ * that is larger than this is uploaded on its own. The default is 8 MiB.
+ */
+void
+TextureStreamingSetUploadBudget (size_t bytes_per_frame);
+
+/**
+ * Set the fraction of the budget of a device-local heap above which textures
+ * are demoted. The default is 0.9.
+ */
+void
+TextureStreamingSetMemoryThreshold (float threshold);
+
+/**
+ * Upload the mip levels that have been read from disk, demote textures if
+ * memory is low, and queue new reads. This is called by Application::Render
+ * at the start of every frame.
+ *
+ * @param cmd command buffer used by the new frame. Must be outside of a
+ * render pass.
+ */
+void
+TextureStreamingNextFrame (VkCommandBuffer cmd);
+
+/**
+ * Wait for reads in flight and destroy all streamed textures and the staging
+ * ring. The device must be idle.
+ */
+void
+TextureStreamingTerminate (void);
+
+}
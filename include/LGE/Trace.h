@@ -0,0 +1,138 @@
+/**
+ * CPU and GPU timeline tracing.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * CPU zones are recorded with LGE_TRACE_SCOPE into per-thread ring buffers.
+ * Only the owning thread writes to a buffer, so recording a zone takes two
+ * clock reads and no locks. GPU zones are fed in by the GPU profiler when it
+ * resolves a frame, and are converted to the CPU clock using calibrated
+ * timestamps (VK_EXT_calibrated_timestamps) when available.
+ *
+ * A capture covers a range of frames and is written as Chrome trace event
+ * JSON, which can be opened in chrome://tracing or ui.perfetto.dev.
+ *
+ * Zones are only recorded if LGE is built with LGE_ENABLE_TRACE. Otherwise
+ * LGE_TRACE_SCOPE expands to nothing.
+ */
+
+#define LGE_TRACE_CONCAT2(a, b) a##b
+#define LGE_TRACE_CONCAT(a, b) LGE_TRACE_CONCAT2 (a, b)
+
+#ifdef LGE_ENABLE_TRACE
+#define LGE_TRACE_SCOPE(name) \
+	::LGE::TraceScope LGE_TRACE_CONCAT (lge_trace_scope_, __LINE__) (name)
+#else
+#define LGE_TRACE_SCOPE(name) ((void) 0)
+#endif
+
+namespace LGE {
+
+/**
+ * Get the current time of the trace clock in nanoseconds. This is the same
+ * clock as CLOCK_MONOTONIC.
+ */
+uint64_t
+TraceNow (void);
+
+/**
+ * Begin a CPU zone on the current thread. Use LGE_TRACE_SCOPE instead.
+ *
+ * @return the begin timestamp, which must be passed to TraceEndScope.
+ */
+uint64_t
+TraceBeginScope (void);
+
+/**
+ * End a CPU zone on the current thread. Use LGE_TRACE_SCOPE instead.
+ *
+ * @param name name of the zone. Must stay valid for the duration of the
+ * program, such as a string literal.
+ * @param begin timestamp returned by TraceBeginScope.
+ */
+void
+TraceEndScope (const char *name, uint64_t begin);
+
+class TraceScope {
+private:
+	const char *m_name;
+	uint64_t m_begin;
+
+public:
+	TraceScope (const char *name)
+		: m_name (name), m_begin (TraceBeginScope ())
+	{}
+
+	~TraceScope (void)
+	{
+		TraceEndScope (m_name, m_begin);
+	}
+
+	TraceScope (const TraceScope &) = delete;
+	TraceScope &operator= (const TraceScope &) = delete;
+};
+
+/**
+ * Set the name of the current thread as shown in trace files.
+ *
+ * @param name thread name. Truncated to 31 characters.
+ */
+void
+TraceSetThreadName (const char *name);
+
+/**
+ * Start a capture on the next frame.
+ *
+ * @param frames number of frames to capture.
+ * @param path path of the trace file. It is written once the capture is
+ * complete and GPU results for the captured frames have been resolved.
+ */
+void
+TraceCapture (uint32_t frames, const char *path);
+
+/**
+ * Test if a capture is in progress.
+ */
+bool
+TraceIsCapturing (void);
+
+/**
+ * Mark the start of a new frame. This is called by the event loop.
+ */
+void
+TraceNextFrame (void);
+
+/**
+ * Record a GPU zone. This is called by the GPU profiler.
+ *
+ * @param name name of the zone.
+ * @param depth nesting depth of the zone.
+ * @param begin_ns, end_ns GPU timestamps in nanoseconds.
+ */
+void
+TraceGPUEvent (const char *name, uint32_t depth, uint64_t begin_ns, uint64_t end_ns);
+
+/**
+ * Provide a rough correspondence between the GPU clock and the CPU clock. This
+ * is used to place GPU events on the timeline when calibrated timestamps are
+ * unavailable. This is called by the GPU profiler.
+ *
+ * @param cpu_ns CPU time at which a frame was submitted.
+ * @param gpu_ns GPU timestamp at which the frame began executing.
+ */
+void
+TraceGPUFrame (uint64_t cpu_ns, uint64_t gpu_ns);
+
+/**
+ * Write a string as a quoted JSON string, escaping quotes and backslashes and
+ * dropping control characters. Used for names in trace event JSON.
+ */
+void
+TraceWriteJSONString (FILE *f, const char *s);
+
+}
@@ -0,0 +1,70 @@
+/**
+ * UTF-8 decoding.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stdint.h>
+
+namespace LGE {
+
+static constexpr uint32_t UTF8_REPLACEMENT_CHARACTER = 0xfffd;
+
+/**
+ * Decode the next code point of a null-terminated UTF-8 string, and advance
+ * past it. Malformed sequences, overlong encodings, surrogates and code
+ * points above U+10FFFF decode to U+FFFD one byte at a time.
+ *
+ * @param text string, which must not be at its null terminator.
+ *
+ * @return the code point.
+ */
+static inline uint32_t
+UTF8Decode (const char *&text)
+{
+	const unsigned char *s = (const unsigned char *) text;
+	uint32_t c = s[0];
+	uint32_t min;
+	int len;
+
+	if (c < 0x80) {
+		text++;
+		return c;
+	} else if ((c & 0xe0) == 0xc0) {
+		c &= 0x1f;
+		min = 0x80;
+		len = 2;
+	} else if ((c & 0xf0) == 0xe0) {
+		c &= 0x0f;
+		min = 0x800;
+		len = 3;
+	} else if ((c & 0xf8) == 0xf0) {
+		c &= 0x07;
+		min = 0x10000;
+		len = 4;
+	} else {
+		text++;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	// A null terminator is not a continuation byte, so this does not read
+	// past the end of the string.
+	for (int i = 1; i < len; i++) {
+		if ((s[i] & 0xc0) != 0x80) {
+			text++;
+			return UTF8_REPLACEMENT_CHARACTER;
+		}
+
+		c = (c << 6) | (s[i] & 0x3f);
+	}
+
+	if (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) {
+		text++;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	text += len;
+	return c;
+}
+
+}
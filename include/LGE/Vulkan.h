@@ -19,6 +19,7 @@ extern VkPhysicalDeviceFeatures gVkFeatures10;
 extern VkPhysicalDeviceVulkan11Features gVkFeatures11;
 extern VkPhysicalDeviceVulkan12Features gVkFeatures12;
 extern VkPhysicalDeviceVulkan13Features gVkFeatures13;
+extern VkPhysicalDeviceMemoryPriorityFeaturesEXT gVkMemoryPriorityFeatures;
 extern uint32_t gVkQueueFamily;
 
 /**
@@ -37,6 +38,17 @@ template <class T>
 const char *
 VulkanTypeToString (T value);
 
+/**
+ * Check if a device extension is enabled. This is useful for optional
+ * extensions, which are enabled only if the device supports them.
+ *
+ * @param name extension name.
+ *
+ * @return true if the extension is enabled, false otherwise.
+ */
+bool
+IsDeviceExtensionEnabled (const char *name);
+
 /** 
  * Initialize Vulkan.
  *
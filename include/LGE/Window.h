@@ -7,14 +7,27 @@
 #define VK_NO_PROTOTYPES 1
 #include <vulkan/vulkan.h>
 
+#include <LGE/GPUMemory.h>
+
 typedef struct VKFWwindow_T VKFWwindow;
 
 namespace LGE {
 
+/**
+ * In headless mode (bIsHeadless), there is no window or surface. Instead, the
+ * "swapchain" is a ring of offscreen images. Acquire and present are empty
+ * queue submissions that signal and wait on the semaphores, so that the
+ * synchronization seen by Application::Render is the same in both modes.
+ */
 class Window {
 private:
-	VKFWwindow *m_wnd;
-	VkSurfaceKHR m_surface;
+	VKFWwindow *m_wnd = nullptr;
+	VkSurfaceKHR m_surface = VK_NULL_HANDLE;
+
+	bool m_headless;
+	GPUImage *m_offscreenImages = nullptr;
+	uint32_t m_nextImage = 0;
+	uint32_t m_lastPresented = UINT32_MAX;
 
 	VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
 	bool m_swapchainDirty = false;
@@ -30,6 +43,12 @@ private:
 	uint32_t m_acquiredIndex = UINT32_MAX;
 
 	uint64_t m_generation = 0;
+
+	void
+	CreateOffscreenImages (void);
+
+	void
+	DestroyOffscreenImages (void);
 public:
 	Window (void);
 	~Window (void);
@@ -110,6 +129,40 @@ public:
 			|| m_presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR;
 	}
 
+	/**
+	 * Get the layout that images must be in when they are presented.
+	 *
+	 * @return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, or
+	 * VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL in headless mode.
+	 */
+	VkImageLayout
+	GetPresentLayout (void)
+	{
+		return m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+			: VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	}
+
+	/**
+	 * Check if the window is running in headless mode.
+	 */
+	bool
+	IsHeadless (void)
+	{
+		return m_headless;
+	}
+
+	/**
+	 * Download the most recently presented image in headless mode. The
+	 * caller must make sure that the GPU is idle.
+	 *
+	 * @param data pointer to memory that receives the pixel data, in the
+	 * swapchain format and extent.
+	 *
+	 * @return true on success, or false if no image has been presented.
+	 */
+	bool
+	DownloadLastImage (void *data);
+
 	/**
 	 * Get the swapchain generation counter.
 	 *
@@ -0,0 +1,120 @@
+/**
+ * Decode a binary log written with the log-binary= argument.
+ * Copyright (C) 2024  dbstream
+ */
+#include <LGE/LogFormat.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+struct format {
+	LGE::LogLevel level;
+	std::string origin;
+	std::string fmt;
+};
+
+static std::vector<format> formats;
+
+static bool
+read_bytes (FILE *f, void *out, size_t size)
+{
+	return fread (out, 1, size, f) == size;
+}
+
+template <class T>
+static bool
+read_value (FILE *f, T *out)
+{
+	return read_bytes (f, out, sizeof (T));
+}
+
+static bool
+read_string (FILE *f, std::string *out)
+{
+	uint16_t len;
+	if (!read_value (f, &len))
+		return false;
+
+	out->resize (len);
+	return read_bytes (f, out->data (), len);
+}
+
+int
+main (int argc, char **argv)
+{
+	if (argc != 2) {
+		fprintf (stderr, "usage: ./decode_log /path/to/log.bin > log.txt\n");
+		return 1;
+	}
+
+	FILE *f = fopen (argv[1], "rb");
+	if (!f) {
+		fprintf (stderr, "failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	char magic[sizeof (LGE::LOG_BINARY_MAGIC)];
+	uint64_t t0;
+	if (!read_bytes (f, magic, sizeof (magic)) || memcmp (magic, LGE::LOG_BINARY_MAGIC, sizeof (magic))
+			|| !read_value (f, &t0)) {
+		fprintf (stderr, "%s is not a binary log\n", argv[1]);
+		return 1;
+	}
+
+	for (;;) {
+		uint8_t type;
+		if (!read_value (f, &type))
+			break;
+
+		if (type == LGE::LOG_RECORD_FORMAT) {
+			uint32_t id;
+			format fmt;
+			if (!read_value (f, &id) || !read_value (f, &fmt.level)
+					|| !read_string (f, &fmt.origin) || !read_string (f, &fmt.fmt))
+				goto truncated;
+
+			if (id != formats.size ()) {
+				fprintf (stderr, "format ID %u is out of order\n", id);
+				return 1;
+			}
+
+			formats.push_back (std::move (fmt));
+		} else if (type == LGE::LOG_RECORD_MESSAGE) {
+			uint32_t id;
+			uint64_t time;
+			uint16_t args_size;
+			LGE::LogArgs args;
+			if (!read_value (f, &id) || !read_value (f, &time) || !read_value (f, &args_size))
+				goto truncated;
+
+			if (id >= formats.size () || args_size > sizeof (args.m_data)) {
+				fprintf (stderr, "corrupt message record\n");
+				return 1;
+			}
+
+			args.m_size = args_size;
+			if (!read_bytes (f, args.m_data, args_size))
+				goto truncated;
+
+			const format &fmt = formats[id];
+			char line[1024];
+			size_t n = LGE::LogFormatLine (line, sizeof (line), (double) (time - t0) * 1.0e-9,
+				fmt.level, fmt.origin.c_str (), fmt.fmt.c_str (), args);
+			fwrite (line, 1, n, stdout);
+		} else {
+			fprintf (stderr, "unknown record type %u\n", type);
+			return 1;
+		}
+	}
+
+	fclose (f);
+	return 0;
+
+truncated:
+	// The log is written in batches, so a crash can leave a partial record.
+	fprintf (stderr, "warning: the log ends with a truncated record\n");
+	fclose (f);
+	return 0;
+}
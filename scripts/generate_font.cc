@@ -1,14 +1,24 @@
 /**
  * Generate the font used for DebugUI.
  * Copyright (C) 2024  dbstream
+ *
+ * Glyphs are stored as signed distance fields, so that DebugUI can draw text
+ * at any scale from a single atlas. A texel value of 128 is on the outline,
+ * larger values are inside the glyph.
  */
 #include <ft2build.h>
 #include <freetype/freetype.h>
+#include <freetype/ftmodapi.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
+#include <string>
+#include <vector>
+
 #define STB_RECT_PACK_IMPLEMENTATION 1
-#include "stb_rect_pack.h"
+#include "../vendor/stb_rect_pack.h"
 
 static FT_Library ft;
 static FT_Face font;
@@ -20,6 +30,15 @@ static char charset[] =
 static constexpr int NUM_CHARS = sizeof (charset) - 1;
 static_assert (NUM_CHARS == 95);
 
+// Size that glyphs are rasterized at, and the distance in pixels that the
+// distance field extends beyond the outline.
+static constexpr int PIXEL_SIZE = 32;
+static constexpr int SDF_SPREAD = 4;
+
+// Empty border around every glyph in the atlas, so that bilinear filtering
+// does not pick up neighbouring glyphs.
+static constexpr int GLYPH_PADDING = 1;
+
 static stbrp_rect glyph_rects[NUM_CHARS];
 static int num_glyph_rects = 0;
 
@@ -37,8 +56,13 @@ static glyphdata glyphs[256] {};
 int
 main (int argc, char **argv)
 {
-	if (argc != 3) {
-		fprintf (stderr, "usage: ./generate_font /path/to/font.ttf LGE::Font::Namespace > font.cc\n");
+	if (argc != 3 && argc != 4) {
+		fprintf (stderr, "usage: ./generate_font /path/to/font.ttf LGE::Font::Namespace [font.cc]\n");
+		return 1;
+	}
+
+	if (argc == 4 && !freopen (argv[3], "w", stdout)) {
+		fprintf (stderr, "failed to open %s\n", argv[3]);
 		return 1;
 	}
 
@@ -46,11 +70,16 @@ main (int argc, char **argv)
 	if (e != FT_Err_Ok)
 		return 1;
 
+	FT_Int spread = SDF_SPREAD;
+	e = FT_Property_Set (ft, "sdf", "spread", &spread);
+	if (e != FT_Err_Ok)
+		return 1;
+
 	e = FT_New_Face (ft, argv[1], 0, &font);
 	if (e != FT_Err_Ok)
 		return 1;
 
-	e = FT_Set_Pixel_Sizes (font, 0, 12);
+	e = FT_Set_Pixel_Sizes (font, 0, PIXEL_SIZE);
 	if (e != FT_Err_Ok)
 		return 1;
 
@@ -64,7 +93,7 @@ main (int argc, char **argv)
 			return 1;
 
 		FT_GlyphSlot slot = font->glyph;
-		e = FT_Render_Glyph (slot, FT_RENDER_MODE_NORMAL);
+		e = FT_Render_Glyph (slot, FT_RENDER_MODE_SDF);
 		if (e != FT_Err_Ok)
 			return 1;
 
@@ -72,16 +101,16 @@ main (int argc, char **argv)
 		glyphs[c].xoffset = slot->bitmap_left;
 		glyphs[c].yoffset = slot->bitmap_top;
 		glyphs[c].advance = slot->advance.x / 64;
-		glyphs[c].width = slot->metrics.width / 64;
-		glyphs[c].height = slot->metrics.height / 64;
+		glyphs[c].width = slot->bitmap.width;
+		glyphs[c].height = slot->bitmap.rows;
 		glyphs[c].atlas_xoffset = 0;
 		glyphs[c].atlas_yoffset = 0;
 
 		if (glyphs[c].width && glyphs[c].height) {
 			glyph_rects[num_glyph_rects++] = {
 				.id = c,
-				.w = glyphs[c].width,
-				.h = glyphs[c].height,
+				.w = glyphs[c].width + GLYPH_PADDING,
+				.h = glyphs[c].height + GLYPH_PADDING,
 				.x = 0,
 				.y = 0,
 				.was_packed = 0
@@ -106,6 +135,38 @@ main (int argc, char **argv)
 		atlas_size *= 2;
 	}
 
+	// DebugUI rasterizes glyphs outside of the baked charset at runtime,
+	// from a copy of the font that is embedded in the output, so that the
+	// font file is not needed on the machine that runs the program.
+	std::vector<uint8_t> font_data;
+	FILE *font_file = fopen (argv[1], "rb");
+	if (!font_file) {
+		fprintf (stderr, "failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	uint8_t chunk[65536];
+	size_t n;
+	while ((n = fread (chunk, 1, sizeof (chunk), font_file)) != 0)
+		font_data.insert (font_data.end (), chunk, chunk + n);
+
+	bool read_error = ferror (font_file);
+	fclose (font_file);
+	if (read_error) {
+		fprintf (stderr, "failed to read %s\n", argv[1]);
+		return 1;
+	}
+
+	const char *font_name = strrchr (argv[1], '/');
+	font_name = font_name ? font_name + 1 : argv[1];
+
+	std::string escaped_name;
+	for (const char *p = font_name; *p; p++) {
+		if (*p == '"' || *p == '\\')
+			escaped_name += '\\';
+		escaped_name += *p;
+	}
+
 	printf (R"code(/**
  * Font data for %s, generated by scripts/generate_font.
  * Copyright (C) 2024  dbstream
@@ -117,14 +178,22 @@ main (int argc, char **argv)
 
 namespace %s {
 
+static constexpr const char *font_name = "%s";
+static constexpr int font_pixel_size = %d;
+static constexpr int font_sdf_spread = %d;
+static constexpr int font_ascender = %d;
+static constexpr int font_line_height = %d;
+
 static constexpr size_t font_bitmap_size = %d;
 static const uint8_t font_bitmap[font_bitmap_size * font_bitmap_size] = {
-)code", argv[1], argv[1], argv[2], atlas_size);
+)code", font_name, font_name, argv[2], escaped_name.c_str (), PIXEL_SIZE, SDF_SPREAD,
+		(int) (font->size->metrics.ascender / 64),
+		(int) (font->size->metrics.height / 64), atlas_size);
 
 	for (int i = 0; i < num_glyph_rects; i++) {
 		char c = glyph_rects[i].id;
-		glyphs[c].atlas_xoffset = glyph_rects[i].x;
-		glyphs[c].atlas_yoffset = glyph_rects[i].y;
+		glyphs[c].atlas_xoffset = glyph_rects[i].x + GLYPH_PADDING;
+		glyphs[c].atlas_yoffset = glyph_rects[i].y + GLYPH_PADDING;
 	}
 
 	uint8_t *buffer = new uint8_t[atlas_size * atlas_size];
@@ -141,12 +210,12 @@ static const uint8_t font_bitmap[font_bitmap_size * font_bitmap_size] = {
 			return 1;
 
 		FT_GlyphSlot slot = font->glyph;
-		e = FT_Render_Glyph (slot, FT_RENDER_MODE_NORMAL);
+		e = FT_Render_Glyph (slot, FT_RENDER_MODE_SDF);
 		if (e != FT_Err_Ok)
 			return 1;
 
-		assert (slot->metrics.width / 64 == glyphs[c].width);
-		assert (slot->metrics.height / 64 == glyphs[c].height);
+		assert ((int) slot->bitmap.width == glyphs[c].width);
+		assert ((int) slot->bitmap.rows == glyphs[c].height);
 
 		for (int y = 0; y < glyphs[c].height; y++) {
 			uint8_t *src = &slot->bitmap.buffer[y * slot->bitmap.pitch];
@@ -198,6 +267,16 @@ static const glyph glyphs[MAX_CHARSET] = {
 
 	printf (R"code(};
 
+static constexpr size_t font_data_size = %zu;
+static const uint8_t font_data[font_data_size] = {
+)code", font_data.size ());
+
+	for (size_t i = 0; i < font_data.size (); i++)
+		printf ((i % 32 == 31) ? "%d,\n" : "%d,", (int) font_data[i]);
+
+	printf (R"code(
+};
+
 }
 
 )code");
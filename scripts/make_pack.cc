@@ -0,0 +1,283 @@
+/**
+ * Build an asset pack from files.
+ * Copyright (C) 2024  dbstream
+ */
+#include <LGE/AssetPackFormat.h>
+#include <LGE/LZ.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/* VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT, without depending on Vulkan headers. */
+static constexpr uint32_t CUBE_COMPATIBLE_BIT = 0x10;
+
+struct input {
+	std::string name;
+	LGE::AssetPackEntry entry {};
+	std::vector<uint8_t> data;
+};
+
+static bool
+read_file (const char *path, std::vector<uint8_t> *out)
+{
+	FILE *f = fopen (path, "rb");
+	if (!f)
+		return false;
+
+	long size = -1;
+	if (!fseek (f, 0, SEEK_END))
+		size = ftell (f);
+
+	bool ok = size >= 0 && !fseek (f, 0, SEEK_SET);
+	if (ok) {
+		out->resize ((size_t) size);
+		ok = fread (out->data (), 1, out->size (), f) == out->size ();
+	}
+
+	fclose (f);
+	return ok;
+}
+
+template <class T>
+static T
+read_value (const std::vector<uint8_t> &file, size_t offset)
+{
+	T value;
+	memcpy (&value, &file[offset], sizeof (T));
+	return value;
+}
+
+/**
+ * Convert a KTX2 file to a texture entry. KTX2 stores all layers of a level
+ * together; texture entries store all levels of a layer together.
+ */
+static bool
+convert_ktx2 (const std::vector<uint8_t> &file, input *in)
+{
+	static const uint8_t identifier[12] = {
+		0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n'
+	};
+
+	if (file.size () < 80 || memcmp (file.data (), identifier, sizeof (identifier)))
+		return false;
+
+	uint32_t format = read_value<uint32_t> (file, 12);
+	uint32_t width = read_value<uint32_t> (file, 20);
+	uint32_t height = read_value<uint32_t> (file, 24);
+	uint32_t depth = read_value<uint32_t> (file, 28);
+	uint32_t layers = read_value<uint32_t> (file, 32);
+	uint32_t faces = read_value<uint32_t> (file, 36);
+	uint32_t levels = read_value<uint32_t> (file, 40);
+	uint32_t scheme = read_value<uint32_t> (file, 44);
+
+	if (!format || !width || !height || depth || !levels || scheme
+		|| (faces != 1 && faces != 6) || levels > 32)
+		return false;
+
+	uint32_t num_layers = (layers ? layers : 1) * faces;
+	if (file.size () < 80 + (size_t) levels * 24)
+		return false;
+
+	std::vector<uint64_t> offsets (levels), sizes (levels);
+	uint64_t layer_size = 0;
+	for (uint32_t level = 0; level < levels; level++) {
+		offsets[level] = read_value<uint64_t> (file, 80 + level * 24);
+		uint64_t length = read_value<uint64_t> (file, 88 + level * 24);
+		if (offsets[level] > file.size () || length > file.size () - offsets[level]
+			|| length % num_layers)
+			return false;
+
+		sizes[level] = length / num_layers;
+		layer_size += sizes[level];
+	}
+
+	in->data.resize (layer_size * num_layers);
+	size_t pos = 0;
+	for (uint32_t layer = 0; layer < num_layers; layer++) {
+		for (uint32_t level = 0; level < levels; level++) {
+			memcpy (&in->data[pos], &file[offsets[level] + layer * sizes[level]], sizes[level]);
+			pos += sizes[level];
+		}
+	}
+
+	in->entry.m_type = LGE::ASSET_PACK_TEXTURE;
+	in->entry.m_format = format;
+	in->entry.m_width = width;
+	in->entry.m_height = height;
+	in->entry.m_levels = levels;
+	in->entry.m_layers = num_layers;
+	in->entry.m_flags = (faces == 6) ? CUBE_COMPATIBLE_BIT : 0;
+	return true;
+}
+
+static void
+put_u32 (std::vector<uint8_t> *out, size_t offset, uint32_t value)
+{
+	memcpy (&(*out)[offset], &value, sizeof (value));
+}
+
+/** Compress an entry, unless that does not make it smaller. */
+static void
+compress (input *in)
+{
+	uint64_t size = in->data.size ();
+	uint64_t num_chunks = LGE::AssetPackNumChunks (size);
+	std::vector<uint8_t> out ((num_chunks + 1) * sizeof (uint32_t));
+	std::vector<uint8_t> buffer (LGE::LZCompressBound (LGE::ASSET_PACK_CHUNK_SIZE));
+
+	for (uint64_t i = 0; i < num_chunks; i++) {
+		const uint8_t *chunk = &in->data[i * LGE::ASSET_PACK_CHUNK_SIZE];
+		size_t chunk_size = std::min<uint64_t> (LGE::ASSET_PACK_CHUNK_SIZE,
+			size - i * LGE::ASSET_PACK_CHUNK_SIZE);
+
+		if (out.size () > UINT32_MAX)
+			return;
+
+		put_u32 (&out, i * sizeof (uint32_t), (uint32_t) out.size ());
+		size_t compressed = LGE::LZCompress (chunk, chunk_size, buffer.data ());
+		if (compressed >= chunk_size)
+			out.insert (out.end (), chunk, chunk + chunk_size);
+		else
+			out.insert (out.end (), buffer.begin (), buffer.begin () + compressed);
+	}
+
+	if (out.size () > UINT32_MAX || out.size () >= size)
+		return;
+
+	put_u32 (&out, num_chunks * sizeof (uint32_t), (uint32_t) out.size ());
+	in->entry.m_compression = LGE::ASSET_PACK_LZ;
+	in->data.swap (out);
+}
+
+static uint64_t
+align (uint64_t offset)
+{
+	return (offset + LGE::ASSET_PACK_ALIGNMENT - 1) & ~(LGE::ASSET_PACK_ALIGNMENT - 1);
+}
+
+static bool
+write_padding (FILE *f, uint64_t *pos, uint64_t target)
+{
+	static const uint8_t zeros[LGE::ASSET_PACK_ALIGNMENT] = {};
+	size_t size = (size_t) (target - *pos);
+	*pos = target;
+	return fwrite (zeros, 1, size, f) == size;
+}
+
+int
+main (int argc, char **argv)
+{
+	bool lz = false;
+	int arg = 1;
+	if (arg < argc && !strcmp (argv[arg], "-z")) {
+		lz = true;
+		arg++;
+	}
+
+	if (argc - arg < 2) {
+		fprintf (stderr, "usage: ./make_pack [-z] out.pack name=path...\n"
+			"  -z       compress entries with LZ\n"
+			"  .ktx2 files become texture entries, other files buffer entries\n");
+		return 1;
+	}
+
+	const char *out_path = argv[arg++];
+	std::vector<input> inputs;
+	for (; arg < argc; arg++) {
+		const char *eq = strchr (argv[arg], '=');
+		if (!eq || eq == argv[arg]) {
+			fprintf (stderr, "expected name=path, got %s\n", argv[arg]);
+			return 1;
+		}
+
+		input in;
+		in.name.assign (argv[arg], eq - argv[arg]);
+		const char *path = eq + 1;
+
+		std::vector<uint8_t> file;
+		if (!read_file (path, &file)) {
+			fprintf (stderr, "failed to read %s\n", path);
+			return 1;
+		}
+
+		size_t len = strlen (path);
+		if (len > 5 && !strcmp (path + len - 5, ".ktx2")) {
+			if (!convert_ktx2 (file, &in)) {
+				fprintf (stderr, "%s: unsupported KTX2 file\n", path);
+				return 1;
+			}
+		} else {
+			in.entry.m_type = LGE::ASSET_PACK_BUFFER;
+			in.data.swap (file);
+		}
+
+		in.entry.m_nameHash = LGE::AssetPackHash (in.name.data (), in.name.size ());
+		in.entry.m_uncompressedSize = in.data.size ();
+		if (lz)
+			compress (&in);
+
+		in.entry.m_size = in.data.size ();
+		inputs.push_back (std::move (in));
+	}
+
+	std::sort (inputs.begin (), inputs.end (), [] (const input &a, const input &b) {
+		if (a.entry.m_nameHash != b.entry.m_nameHash)
+			return a.entry.m_nameHash < b.entry.m_nameHash;
+		return a.name < b.name;
+	});
+
+	for (size_t i = 1; i < inputs.size (); i++) {
+		if (inputs[i].name == inputs[i - 1].name) {
+			fprintf (stderr, "duplicate entry %s\n", inputs[i].name.c_str ());
+			return 1;
+		}
+	}
+
+	LGE::AssetPackHeader header {};
+	memcpy (header.m_magic, LGE::ASSET_PACK_MAGIC, sizeof (header.m_magic));
+	header.m_numEntries = (uint32_t) inputs.size ();
+	header.m_tocOffset = sizeof (header);
+	header.m_namesOffset = header.m_tocOffset + inputs.size () * sizeof (LGE::AssetPackEntry);
+
+	std::string names;
+	for (input &in : inputs) {
+		in.entry.m_nameOffset = (uint32_t) names.size ();
+		in.entry.m_nameLength = (uint32_t) in.name.size ();
+		names += in.name;
+	}
+
+	header.m_namesSize = names.size ();
+	uint64_t offset = align (header.m_namesOffset + names.size ());
+	for (input &in : inputs) {
+		in.entry.m_offset = offset;
+		offset = align (offset + in.entry.m_size);
+	}
+
+	FILE *f = fopen (out_path, "wb");
+	if (!f) {
+		fprintf (stderr, "failed to open %s\n", out_path);
+		return 1;
+	}
+
+	bool ok = fwrite (&header, sizeof (header), 1, f) == 1;
+	for (const input &in : inputs)
+		ok = ok && fwrite (&in.entry, sizeof (in.entry), 1, f) == 1;
+	ok = ok && fwrite (names.data (), 1, names.size (), f) == names.size ();
+
+	uint64_t pos = header.m_namesOffset + names.size ();
+	for (const input &in : inputs) {
+		ok = ok && write_padding (f, &pos, in.entry.m_offset);
+		ok = ok && fwrite (in.data.data (), 1, in.data.size (), f) == in.data.size ();
+		pos += in.data.size ();
+	}
+
+	if (fclose (f) || !ok) {
+		fprintf (stderr, "failed to write %s\n", out_path);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,269 @@
+/**
+ * Tests for LZ compression and compressed asset pack entries.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "TestLZ"
+
+#include <LGE/AssetPack.h>
+#include <LGE/LZ.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+using namespace LGE;
+
+/** Deterministic data that LZCompress cannot shrink. */
+static std::vector<uint8_t>
+random_bytes (size_t size, uint64_t seed)
+{
+	std::vector<uint8_t> data (size);
+	uint64_t x = seed | 1;
+	for (uint8_t &byte : data) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		byte = (uint8_t) (x >> 32);
+	}
+
+	return data;
+}
+
+/** Data with matches at every distance up to LZ_MAX_OFFSET and beyond. */
+static std::vector<uint8_t>
+repetitive_bytes (size_t size)
+{
+	std::vector<uint8_t> data (size);
+	for (size_t i = 0; i < size; i++)
+		data[i] = (uint8_t) ("LGE asset pack "[i % 15] + (i / 4096) % 3);
+
+	return data;
+}
+
+/** Compress data, check that it decompresses to itself, and return the compressed size. */
+static size_t
+round_trip (const std::vector<uint8_t> &data)
+{
+	std::vector<uint8_t> compressed (LZCompressBound (data.size ()));
+	size_t size = LZCompress (data.data (), data.size (), compressed.data ());
+	CHECK (size <= compressed.size ());
+
+	std::vector<uint8_t> out (data.size () + 1, 0xa5);
+	CHECK (LZDecompress (compressed.data (), size, out.data (), data.size ()));
+	CHECK (std::equal (data.begin (), data.end (), out.begin ()));
+	CHECK (out[data.size ()] == 0xa5);
+
+	// Truncated or mis-sized blocks are detected.
+	if (size > 1)
+		CHECK (!LZDecompress (compressed.data (), size - 1, out.data (), data.size ()));
+	CHECK (!LZDecompress (compressed.data (), size, out.data (), data.size () + 1));
+
+	return size;
+}
+
+static void
+test_round_trip (void)
+{
+	for (size_t size : { (size_t) 0, (size_t) 1, LZ_MIN_MATCH - 1, LZ_MIN_MATCH,
+			(size_t) 15, (size_t) 16, (size_t) 300, (size_t) 65536 })
+		round_trip (repetitive_bytes (size));
+
+	// Long runs need extra length bytes, and overlap their own output.
+	CHECK (round_trip (std::vector<uint8_t> (100000, 'a')) < 1000);
+	CHECK (round_trip (repetitive_bytes (200000)) < 200000 / 4);
+
+	// Incompressible data only grows by the bound.
+	std::vector<uint8_t> noise = random_bytes (65536, 1);
+	CHECK (round_trip (noise) >= noise.size ());
+}
+
+static void
+test_corrupt_block (void)
+{
+	uint8_t out[64];
+
+	// A match before the start of the output.
+	const uint8_t far_match[] = { 0x10, 'x', 0x05, 0x00, 'y' };
+	CHECK (!LZDecompress (far_match, sizeof (far_match), out, 6));
+
+	// An offset of 0.
+	const uint8_t zero_offset[] = { 0x10, 'x', 0x00, 0x00, 'y' };
+	CHECK (!LZDecompress (zero_offset, sizeof (zero_offset), out, 6));
+
+	// More literals than the block holds.
+	const uint8_t short_literals[] = { 0x50, 'a', 'b' };
+	CHECK (!LZDecompress (short_literals, sizeof (short_literals), out, 5));
+
+	// An extra length that runs off the end of the block.
+	const uint8_t open_length[] = { 0xf0, 0xff };
+	CHECK (!LZDecompress (open_length, sizeof (open_length), out, sizeof (out)));
+}
+
+/**
+ * A temporary asset pack with one compressed buffer entry, called "data",
+ * whose data is given as is.
+ */
+class TestPack {
+private:
+	std::string m_path;
+
+public:
+	TestPack (const std::vector<uint8_t> &data, uint64_t uncompressed_size)
+	{
+		const char *dir = ::getenv ("TMPDIR");
+		m_path = std::string (dir ? dir : "/tmp") + "/lge-test-XXXXXX";
+		int fd = ::mkstemp (m_path.data ());
+		if (fd < 0)
+			throw std::runtime_error ("cannot create " + m_path);
+
+		static constexpr char NAME[] = "data";
+		std::vector<uint8_t> file (ASSET_PACK_ALIGNMENT + data.size ());
+
+		AssetPackHeader header {};
+		::memcpy (header.m_magic, ASSET_PACK_MAGIC, sizeof (header.m_magic));
+		header.m_numEntries = 1;
+		header.m_tocOffset = sizeof (header);
+		header.m_namesOffset = sizeof (header) + sizeof (AssetPackEntry);
+		header.m_namesSize = sizeof (NAME) - 1;
+
+		AssetPackEntry entry {};
+		entry.m_nameHash = AssetPackHash (NAME, sizeof (NAME) - 1);
+		entry.m_nameLength = sizeof (NAME) - 1;
+		entry.m_offset = ASSET_PACK_ALIGNMENT;
+		entry.m_size = data.size ();
+		entry.m_uncompressedSize = uncompressed_size;
+		entry.m_type = ASSET_PACK_BUFFER;
+		entry.m_compression = ASSET_PACK_LZ;
+
+		::memcpy (&file[0], &header, sizeof (header));
+		::memcpy (&file[header.m_tocOffset], &entry, sizeof (entry));
+		::memcpy (&file[header.m_namesOffset], NAME, sizeof (NAME) - 1);
+		::memcpy (&file[ASSET_PACK_ALIGNMENT], data.data (), data.size ());
+
+		bool ok = ::write (fd, file.data (), file.size ()) == (ssize_t) file.size ();
+		::close (fd);
+		if (!ok) {
+			::unlink (m_path.c_str ());
+			throw std::runtime_error ("cannot write " + m_path);
+		}
+	}
+
+	~TestPack (void)
+	{
+		::unlink (m_path.c_str ());
+	}
+
+	const char *
+	GetPath (void) const
+	{
+		return m_path.c_str ();
+	}
+};
+
+static void
+put_u32 (std::vector<uint8_t> &out, size_t offset, uint32_t value)
+{
+	::memcpy (&out[offset], &value, sizeof (value));
+}
+
+/** Compress data into chunks, as scripts/make_pack.cc does. */
+static std::vector<uint8_t>
+compress_chunks (const std::vector<uint8_t> &data)
+{
+	uint64_t num_chunks = AssetPackNumChunks (data.size ());
+	std::vector<uint8_t> out ((num_chunks + 1) * sizeof (uint32_t));
+	std::vector<uint8_t> buffer (LZCompressBound (ASSET_PACK_CHUNK_SIZE));
+
+	for (uint64_t i = 0; i < num_chunks; i++) {
+		const uint8_t *chunk = &data[i * ASSET_PACK_CHUNK_SIZE];
+		size_t chunk_size = std::min<uint64_t> (ASSET_PACK_CHUNK_SIZE,
+			data.size () - i * ASSET_PACK_CHUNK_SIZE);
+
+		put_u32 (out, i * sizeof (uint32_t), (uint32_t) out.size ());
+		size_t compressed = LZCompress (chunk, chunk_size, buffer.data ());
+		if (compressed >= chunk_size)
+			out.insert (out.end (), chunk, chunk + chunk_size);
+		else
+			out.insert (out.end (), buffer.data (), buffer.data () + compressed);
+	}
+
+	put_u32 (out, num_chunks * sizeof (uint32_t), (uint32_t) out.size ());
+	return out;
+}
+
+static bool
+read_fails (const std::vector<uint8_t> &data, uint64_t uncompressed_size)
+{
+	TestPack file (data, uncompressed_size);
+	AssetPack pack (file.GetPath ());
+	std::vector<uint8_t> out (uncompressed_size);
+	try {
+		pack.Read (*pack.Find ("data"), out.data ());
+	} catch (const std::runtime_error &) {
+		return true;
+	}
+
+	return false;
+}
+
+static void
+test_pack_chunks (void)
+{
+	// A compressible chunk, a stored chunk, and a short compressible one.
+	std::vector<uint8_t> data = repetitive_bytes (ASSET_PACK_CHUNK_SIZE);
+	std::vector<uint8_t> noise = random_bytes (ASSET_PACK_CHUNK_SIZE, 2);
+	data.insert (data.end (), noise.begin (), noise.end ());
+	data.resize (data.size () + 1000, 'z');
+
+	std::vector<uint8_t> compressed = compress_chunks (data);
+	uint32_t stored_begin, stored_end;
+	::memcpy (&stored_begin, &compressed[4], 4);
+	::memcpy (&stored_end, &compressed[8], 4);
+	CHECK (stored_end - stored_begin == ASSET_PACK_CHUNK_SIZE);
+
+	{
+		TestPack file (compressed, data.size ());
+		AssetPack pack (file.GetPath ());
+		const AssetPackEntry *entry = pack.Find ("data");
+		CHECK (entry && entry->m_uncompressedSize == data.size ());
+
+		std::vector<uint8_t> out (data.size ());
+		pack.Read (*entry, out.data ());
+		CHECK (out == data);
+	}
+
+	// The chunk table of three chunks needs 16 bytes.
+	CHECK (read_fails (std::vector<uint8_t> (12), data.size ()));
+	CHECK (read_fails (std::vector<uint8_t> (compressed.begin (), compressed.begin () + 8),
+		data.size ()));
+
+	// Offsets that go backwards, or past the end of the data.
+	std::vector<uint8_t> corrupt = compressed;
+	put_u32 (corrupt, 8, 4);
+	CHECK (read_fails (corrupt, data.size ()));
+
+	corrupt = compressed;
+	put_u32 (corrupt, 12, (uint32_t) compressed.size () + 1);
+	CHECK (read_fails (corrupt, data.size ()));
+
+	// A corrupt compressed chunk.
+	corrupt = compressed;
+	corrupt[16] ^= 0xff;
+	CHECK (read_fails (corrupt, data.size ()));
+}
+
+int
+main (void)
+{
+	test_round_trip ();
+	test_corrupt_block ();
+	test_pack_chunks ();
+	return TestResult ();
+}
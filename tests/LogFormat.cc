@@ -0,0 +1,146 @@
+/**
+ * Tests for the formatting of captured log messages.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "TestLogFormat"
+
+#include <LGE/LogFormat.h>
+
+#include <string.h>
+
+#include <string>
+
+#include "Test.h"
+
+using namespace LGE;
+
+/** Capture the arguments like Log does, and format the message. */
+template <class ...Args>
+static std::string
+format (size_t size, const char *fmt, Args &&...args)
+{
+	LogArgs captured;
+	(LogEncodeArg (captured, args), ...);
+
+	std::string out (size, '#');
+	size_t n = LogFormatMessage (out.data (), size, fmt, captured);
+	CHECK (n < size && out[n] == 0);
+	out.resize (n);
+	return out;
+}
+
+template <class ...Args>
+static std::string
+format (const char *fmt, Args &&...args)
+{
+	return format (256, fmt, args...);
+}
+
+static void
+test_conversions (void)
+{
+	CHECK (format ("plain text") == "plain text");
+	CHECK (format ("100%%") == "100%");
+	CHECK (format ("%d %i %u", -5, (short) 7, 42u) == "-5 7 42");
+	CHECK (format ("%lld %llu", INT64_MIN, UINT64_MAX)
+		== "-9223372036854775808 18446744073709551615");
+	CHECK (format ("%x %X %o %#x", 255, 255, 8, 16) == "ff FF 10 0x10");
+	CHECK (format ("%5d|%-5d|%05d", 42, 42, 42) == "   42|42   |00042");
+	CHECK (format ("%*d", 4, 7) == "   7");
+	CHECK (format ("%.2f %e %g", 3.14159, 1000.0, 0.5f) == "3.14 1.000000e+03 0.5");
+	CHECK (format ("%c%c", 'o', 'k') == "ok");
+	CHECK (format ("%s, %s", "hello", std::string ("world").c_str ()) == "hello, world");
+	CHECK (format ("%.3s|%5s|%-5s|", "abcdef", "ab", "ab") == "abc|   ab|ab   |");
+	CHECK (format ("%s", (const char *) nullptr) == "(null)");
+	CHECK (format ("%p", (void *) 0x1234) == "0x1234");
+
+	// Arguments are converted to the conversion, not the other way round.
+	CHECK (format ("%d %f", 2.75, 3) == "2 3.000000");
+}
+
+static void
+test_mismatches (void)
+{
+	// Missing arguments, strings for numbers, and numbers for strings.
+	CHECK (format ("%d and %d", 1) == "1 and <?>");
+	CHECK (format ("%d", "text") == "<?>");
+	CHECK (format ("%s", 5) == "<?>");
+	CHECK (format ("%y", 5) == "<?>");
+
+	// Strings are truncated to fit the capture, and arguments that do not
+	// fit at all are dropped.
+	std::string s (LogArgs::MAX_SIZE * 2, 'x');
+	std::string out = format (1024, "%s %d", s.c_str (), 1);
+	CHECK (out.size () == LogArgs::MAX_SIZE - 3 + 4);
+	CHECK (out.compare (out.size () - 4, 4, " <?>") == 0);
+
+	// A number that only partly fits is dropped, and so are the arguments
+	// after it, even if they would fit.
+	std::string t (LogArgs::MAX_SIZE - 3 - 8, 't');
+	out = format (1024, "%s %d %s", t.c_str (), 7, "");
+	CHECK (out == t + " <?> <?>");
+}
+
+static void
+test_corrupt_args (void)
+{
+	// Records from binary logs are not trusted: a number or string that
+	// runs past the end, or an unknown type, ends the arguments.
+	char out[64];
+	LogArgs args;
+	const uint8_t short_number[] = { LOG_ARG_I64, 1, 2, 3 };
+	::memcpy (args.m_data, short_number, sizeof (short_number));
+	args.m_size = sizeof (short_number);
+	LogFormatMessage (out, sizeof (out), "%d %d", args);
+	CHECK (std::string (out) == "<?> <?>");
+
+	const uint8_t long_string[] = { LOG_ARG_STR, 200, 0, 'a', 'b' };
+	::memcpy (args.m_data, long_string, sizeof (long_string));
+	args.m_size = sizeof (long_string);
+	LogFormatMessage (out, sizeof (out), "%s", args);
+	CHECK (std::string (out) == "<?>");
+
+	const uint8_t unknown[] = { 0x7f, 0, 0, 0, 0, 0, 0, 0, 0 };
+	::memcpy (args.m_data, unknown, sizeof (unknown));
+	args.m_size = sizeof (unknown);
+	LogFormatMessage (out, sizeof (out), "%d", args);
+	CHECK (std::string (out) == "<?>");
+}
+
+static void
+test_truncation (void)
+{
+	CHECK (format (1, "text") == "");
+	CHECK (format (5, "some text") == "some");
+	CHECK (format (5, "%d", 123456789) == "1234");
+	CHECK (format (5, "ab%s", "cdefgh") == "abcd");
+	CHECK (format (6, "%d %s", 1, "long") == "1 lon");
+}
+
+static void
+test_line (void)
+{
+	LogArgs args;
+	LogEncodeArg (args, 3);
+
+	char out[128];
+	size_t n = LogFormatLine (out, sizeof (out), 1.5, LOG_LEVEL_WARNING, "LGETest",
+		"%d frames", args);
+	CHECK (n == strlen (out));
+	CHECK (std::string (out) == "      1.500000  LGETest: warning: 3 frames\n");
+
+	// The newline survives truncation.
+	n = LogFormatLine (out, 20, 1.5, LOG_LEVEL_INFO, "LGETest", "%d frames", args);
+	CHECK (n == 19 && out[18] == '\n' && out[19] == 0);
+}
+
+int
+main (void)
+{
+	test_conversions ();
+	test_mismatches ();
+	test_corrupt_args ();
+	test_truncation ();
+	test_line ();
+	return TestResult ();
+}
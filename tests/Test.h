@@ -0,0 +1,33 @@
+/**
+ * Minimal test helpers.
+ * Copyright (C) 2024  dbstream
+ */
+#pragma once
+
+#include <stdio.h>
+
+/**
+ * Every test is a separate executable, registered with CTest. A test checks
+ * conditions with CHECK, which reports failures and keeps going, and returns
+ * TestResult () from main.
+ */
+
+static int test_failures = 0;
+
+#define CHECK(cond)								\
+	do {									\
+		if (!(cond)) {							\
+			::fprintf (stderr, "%s:%d: check failed: %s\n",		\
+				__FILE__, __LINE__, #cond);			\
+			test_failures++;					\
+		}								\
+	} while (0)
+
+static inline int
+TestResult (void)
+{
+	if (test_failures)
+		::fprintf (stderr, "%d checks failed\n", test_failures);
+
+	return test_failures ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * Tests for the UTF-8 decoder of DebugUI.
+ * Copyright (C) 2024  dbstream
+ */
+#define LGE_MODULE "TestUTF8"
+
+#include <LGE/UTF8.h>
+
+#include <vector>
+
+#include "Test.h"
+
+using namespace LGE;
+
+static constexpr uint32_t FFFD = UTF8_REPLACEMENT_CHARACTER;
+
+/** Decode a whole string, and compare it with the expected code points. */
+static bool
+decodes_to (const char *text, std::vector<uint32_t> expected)
+{
+	std::vector<uint32_t> decoded;
+	while (*text)
+		decoded.push_back (UTF8Decode (text));
+
+	return decoded == expected;
+}
+
+static void
+test_valid (void)
+{
+	CHECK (decodes_to ("", {}));
+	CHECK (decodes_to ("LGE", { 'L', 'G', 'E' }));
+	CHECK (decodes_to ("\x7f", { 0x7f }));
+	CHECK (decodes_to ("\xc2\x80\xdf\xbf", { 0x80, 0x7ff }));
+	CHECK (decodes_to ("\xe0\xa0\x80\xef\xbf\xbf", { 0x800, 0xffff }));
+	CHECK (decodes_to ("\xed\x9f\xbf\xee\x80\x80", { 0xd7ff, 0xe000 }));
+	CHECK (decodes_to ("\xf0\x90\x80\x80\xf4\x8f\xbf\xbf", { 0x10000, 0x10ffff }));
+	CHECK (decodes_to ("a\xc3\xa5" "b", { 'a', 0xe5, 'b' }));
+}
+
+static void
+test_invalid (void)
+{
+	// Continuation bytes and bytes that never start a sequence.
+	CHECK (decodes_to ("\x80", { FFFD }));
+	CHECK (decodes_to ("a\xbf" "b", { 'a', FFFD, 'b' }));
+	CHECK (decodes_to ("\xf8\x88\x80\x80\x80", { FFFD, FFFD, FFFD, FFFD, FFFD }));
+	CHECK (decodes_to ("\xfe\xff", { FFFD, FFFD }));
+
+	// Truncated sequences, at the end of the string and before other
+	// characters. The null terminator is never read past.
+	CHECK (decodes_to ("\xc3", { FFFD }));
+	CHECK (decodes_to ("\xe2\x82", { FFFD, FFFD }));
+	CHECK (decodes_to ("\xf0\x9f\x98", { FFFD, FFFD, FFFD }));
+	CHECK (decodes_to ("\xe2\x82" "a", { FFFD, FFFD, 'a' }));
+
+	// Overlong encodings.
+	CHECK (decodes_to ("\xc0\xaf", { FFFD, FFFD }));
+	CHECK (decodes_to ("\xc1\xbf", { FFFD, FFFD }));
+	CHECK (decodes_to ("\xe0\x9f\xbf", { FFFD, FFFD, FFFD }));
+	CHECK (decodes_to ("\xf0\x8f\xbf\xbf", { FFFD, FFFD, FFFD, FFFD }));
+
+	// Surrogates, and code points above U+10FFFF.
+	CHECK (decodes_to ("\xed\xa0\x80", { FFFD, FFFD, FFFD }));
+	CHECK (decodes_to ("\xed\xbf\xbf", { FFFD, FFFD, FFFD }));
+	CHECK (decodes_to ("\xf4\x90\x80\x80", { FFFD, FFFD, FFFD, FFFD }));
+	CHECK (decodes_to ("\xf7\xbf\xbf\xbf", { FFFD, FFFD, FFFD, FFFD }));
+}
+
+int
+main (void)
+{
+	test_valid ();
+	test_invalid ();
+	return TestResult ();
+}